@@ -0,0 +1,231 @@
+#ifndef AITRACE_H
+#define AITRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Instrumentation for GhostAI: a binary ring of the most recent decisions and
+// mode changes, plus running counters. Off unless a trace is attached
+// (GhostAI::setTrace / GameSession::setTrace); attached, a decision costs one
+// 24-byte record and two clock reads.
+//
+// dump() writes the counters and the ring (oldest first) to a binary file;
+// tools/aitrace.cpp prints one. The layout is the structs below as written
+// (little-endian, no padding beyond what is spelled out).
+
+// One ghost decision, or one mode change (kind == MODE_CHANGE: ghost = 0xFF,
+// mode = the new mode, chosen = the old one).
+struct AITraceRecord
+{
+    enum Kind : std::uint8_t
+    {
+        DECISION = 0,
+        MODE_CHANGE = 1
+    };
+    enum Flags : std::uint8_t
+    {
+        SEARCHED = 1,   // the lookahead search ran (and may have overruled greedy)
+        RANDOM = 2,     // frightened: random pick, no target
+        FROM_WORKER = 4 // AsyncGhostAI applied the worker's answer
+    };
+
+    std::uint32_t tick;       // GhostAI ticks (frames) since the trace was attached
+    std::uint8_t kind;        // Kind
+    std::uint8_t ghost;       // index in the ghost list
+    std::uint8_t mode;        // AIMode at the decision
+    std::uint8_t flags;       // Flags
+    std::int16_t tileX, tileY;     // where the ghost decided
+    std::int16_t targetX, targetY; // its target tile (the tile itself when RANDOM)
+    std::uint8_t candidates;  // bit per legal GhostDirection (UP=1, DOWN=2, LEFT=4, RIGHT=8)
+    std::uint8_t chosen;      // GhostDirection taken
+    std::uint16_t nanos;      // time deciding, saturating at 65535
+    std::uint32_t searchNodes; // nodes the lookahead expanded for this decision
+};
+static_assert(sizeof(AITraceRecord) == 24, "AITraceRecord is a file format");
+
+struct AITraceCounters
+{
+    std::uint64_t ticks = 0;               // GhostAI::update / beginTick calls
+    std::uint64_t decisions = 0;           // scatter/chase turns decided
+    std::uint64_t randomDecisions = 0;     // frightened turns
+    std::uint64_t workerDecisions = 0;     // of `decisions`, answered by AsyncGhostAI's worker
+    std::uint64_t searchedDecisions = 0;   // of `decisions`, where the lookahead ran
+    std::uint64_t searchNodes = 0;         // lookahead nodes expanded
+    std::uint64_t homeSearches = 0;        // Ghost::updateMovement return-home BFS runs
+    std::uint64_t homeSearchNodes = 0;     // ...and tiles they expanded
+    std::uint64_t updateNanos = 0;         // inside GhostAI::update (or AsyncGhostAI::update)
+    std::uint64_t decideNanos = 0;         // inside the target + greedy (+ search) choice
+    std::uint64_t modeTransitions[3][3] = {}; // [from][to], AIMode order
+    std::uint64_t wallNanos = 0;           // since the trace was attached (set by dump/print)
+};
+
+class AITrace
+{
+public:
+    static constexpr std::uint32_t FILE_MAGIC = 0x52544941; // "AITR"
+    static constexpr std::uint32_t FILE_VERSION = 1;
+
+    struct FileHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t recordSize;
+        std::uint32_t recordCount; // records that follow the counters
+        AITraceCounters counters;
+    };
+
+    // capacity is rounded up to a power of two.
+    explicit AITrace(std::size_t capacity = 1 << 16);
+
+    void beginTick() { ++counters.ticks; }
+    void record(const AITraceRecord &r)
+    {
+        ring[head & mask] = r;
+        ++head;
+    }
+    void modeChange(int from, int to);
+    void addHomeSearch(long searches, long nodes)
+    {
+        counters.homeSearches += searches;
+        counters.homeSearchNodes += nodes;
+    }
+
+    std::uint32_t tick() const { return static_cast<std::uint32_t>(counters.ticks); }
+    AITraceCounters &getCounters() { return counters; }
+    const AITraceCounters &getCounters() const { return counters; }
+    std::size_t size() const { return head < ring.size() ? static_cast<std::size_t>(head) : ring.size(); }
+
+    // Monotonic nanoseconds, for the timing counters.
+    static std::uint64_t nowNanos()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now().time_since_epoch())
+                                              .count());
+    }
+
+    bool dump(const std::string &path);
+    void printCounters(std::ostream &out);
+
+    // Reader side (tools/aitrace.cpp).
+    static bool load(const std::string &path, FileHeader &header, std::vector<AITraceRecord> &records);
+    static void printCounters(std::ostream &out, const AITraceCounters &c);
+
+private:
+    std::vector<AITraceRecord> ring;
+    std::uint64_t mask;
+    std::uint64_t head = 0; // records ever written
+    AITraceCounters counters;
+    std::uint64_t startNanos;
+};
+
+inline AITrace::AITrace(std::size_t capacity) : startNanos(nowNanos())
+{
+    std::size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+    ring.resize(size);
+    mask = size - 1;
+}
+
+inline void AITrace::modeChange(int from, int to)
+{
+    if (from >= 0 && from < 3 && to >= 0 && to < 3)
+        counters.modeTransitions[from][to]++;
+    AITraceRecord r{};
+    r.tick = tick();
+    r.kind = AITraceRecord::MODE_CHANGE;
+    r.ghost = 0xFF;
+    r.mode = static_cast<std::uint8_t>(to);
+    r.chosen = static_cast<std::uint8_t>(from);
+    record(r);
+}
+
+inline bool AITrace::dump(const std::string &path)
+{
+    counters.wallNanos = nowNanos() - startNanos;
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        std::cout << "Cannot write AI trace " << path << std::endl;
+        return false;
+    }
+
+    FileHeader header{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.recordSize = sizeof(AITraceRecord);
+    header.recordCount = static_cast<std::uint32_t>(size());
+    header.counters = counters;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    // Oldest first: the ring is in order from head once it has wrapped.
+    std::uint64_t first = head - size();
+    for (std::uint64_t i = first; ok && i < head; ++i)
+        ok = std::fwrite(&ring[i & mask], sizeof(AITraceRecord), 1, file) == 1;
+    ok = (std::fclose(file) == 0) && ok;
+
+    std::cout << "AI trace: " << header.recordCount << " records -> " << path << std::endl;
+    return ok;
+}
+
+inline void AITrace::printCounters(std::ostream &out)
+{
+    counters.wallNanos = nowNanos() - startNanos;
+    printCounters(out, counters);
+}
+
+inline bool AITrace::load(const std::string &path, FileHeader &header, std::vector<AITraceRecord> &records)
+{
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 && header.magic == FILE_MAGIC &&
+              header.version == FILE_VERSION && header.recordSize == sizeof(AITraceRecord);
+    if (ok)
+    {
+        records.resize(header.recordCount);
+        ok = records.empty() || std::fread(records.data(), sizeof(AITraceRecord), records.size(), file) == records.size();
+    }
+    std::fclose(file);
+    return ok;
+}
+
+inline void AITrace::printCounters(std::ostream &out, const AITraceCounters &c)
+{
+    static const char *const modeNames[3] = {"SCATTER", "CHASE", "FRIGHTENED"};
+    double wall = c.wallNanos / 1e9;
+    double decisions = static_cast<double>(c.decisions + c.randomDecisions);
+
+    out << "Ghost AI counters (" << c.ticks << " ticks, " << wall << " s wall)\n";
+    out << "  decisions: " << c.decisions << " scatter/chase + " << c.randomDecisions << " frightened";
+    if (wall > 0.0)
+        out << " (" << static_cast<long>(decisions / wall) << "/s wall)";
+    out << "\n";
+    if (c.workerDecisions)
+        out << "  from the async worker: " << c.workerDecisions << "\n";
+    out << "  lookahead: " << c.searchedDecisions << " searches, " << c.searchNodes << " nodes\n";
+    out << "  return-home BFS: " << c.homeSearches << " runs, " << c.homeSearchNodes << " tiles expanded\n";
+    out << "  time: update " << c.updateNanos / 1e6 << " ms";
+    if (c.ticks)
+        out << " (" << c.updateNanos / c.ticks << " ns/tick)";
+    out << ", deciding " << c.decideNanos / 1e6 << " ms";
+    if (c.decisions)
+        out << " (" << c.decideNanos / c.decisions << " ns/decision)";
+    out << "\n  mode changes:";
+    for (int from = 0; from < 3; ++from)
+    {
+        for (int to = 0; to < 3; ++to)
+        {
+            if (c.modeTransitions[from][to])
+                out << " " << modeNames[from] << "->" << modeNames[to] << " " << c.modeTransitions[from][to];
+        }
+    }
+    out << std::endl;
+}
+
+#endif // AITRACE_H
@@ -0,0 +1,291 @@
+#ifndef ASYNCGHOSTAI_H
+#define ASYNCGHOSTAI_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <SFML/System.hpp>
+#include "Grid.h"
+#include "Muncher.h"
+#include "Spookies.h"
+#include "Spookie_Chase.h"
+#include "TripleBuffer.h"
+
+// Runs the scatter/chase decisions (and the lookahead search, the expensive
+// part) on a worker thread so a slow search never stretches a frame.
+//
+// Every frame the main thread publishes an immutable Snapshot: the AI mode,
+// the muncher's tile and heading, and for each ghost the tile it is walking
+// into plus its heading. The worker takes the newest snapshot, decides every
+// ghost's turn *at that next tile* with its own GhostAI, and hands the answers
+// back. Both handoffs are TripleBuffers, so neither side ever blocks; the
+// condition variable only lets an idle worker sleep.
+//
+// Decisions are applied when a ghost reaches a tile boundary, and only if
+// they were made for exactly the situation it is in: same tile, heading, door
+// rule and mode, from a snapshot taken after it committed to that move.
+// Anything else (worker behind, mode just flipped, ghost reset) falls back to
+// the synchronous greedy choice, so ghosts never stall. Frightened ghosts stay
+// on the main thread (they draw from the game's generator), as do mode timing
+// and state changes.
+//
+// Decisions see the muncher as it was a few frames earlier, so this mode is
+// not frame-for-frame deterministic; GhostAI::update stays the default path.
+class AsyncGhostAI
+{
+public:
+    static constexpr int MAX_GHOSTS = 8; // ghosts past this are always decided in-frame
+
+    // The grid is read by the worker; hold holdWorker() while replacing it.
+    explicit AsyncGhostAI(const Grid &grid);
+    AsyncGhostAI(const AsyncGhostAI &) = delete;
+    AsyncGhostAI &operator=(const AsyncGhostAI &) = delete;
+    ~AsyncGhostAI();
+
+    // Difficulty for the worker's brain (mirrors GhostAI::setLevel / setSearchBudget).
+    void configure(int level, long searchMicros);
+
+    // Replaces GhostAI::update: `ai` keeps the mode clock and the fallbacks.
+    void update(GhostAI &ai, std::vector<Ghost> &ghosts, const Muncher &muncher, const Grid &grid);
+
+    // Blocks the worker out of the grid while the lock is held (map reload).
+    std::unique_lock<std::mutex> holdWorker() { return std::unique_lock<std::mutex>(busy); }
+
+    long getApplied() const { return applied; }
+    long getFallbacks() const { return fallbacks; }
+    long getWorkerSnapshots() const { return workerSnapshots.load(std::memory_order_relaxed); }
+
+private:
+    struct GhostSlot
+    {
+        GhostView view; // tile = the tile it is walking into
+        bool steer;     // not RETURNING / eaten
+    };
+
+    struct Snapshot
+    {
+        std::uint64_t tick = 0;
+        AIMode mode = AIMode::SCATTER;
+        MuncherView muncher{};
+        bool hasChaser = false;
+        sf::Vector2i chaserTile;
+        int ghostCount = 0;
+        GhostSlot ghosts[MAX_GHOSTS]{};
+        int level = 1;
+        long searchMicros = 0;
+    };
+
+    struct Decision
+    {
+        bool valid = false;
+        std::uint64_t tick = 0; // snapshot it was made from
+        AIMode mode = AIMode::SCATTER;
+        GhostView from{};       // situation it answers
+        GhostDirection direction = GhostDirection::RIGHT;
+    };
+
+    struct Decisions
+    {
+        int count = 0;
+        Decision ghosts[MAX_GHOSTS];
+    };
+
+    const Grid &grid;
+    TripleBuffer<Snapshot> snapshots; // main -> worker
+    TripleBuffer<Decisions> decisions; // worker -> main
+
+    std::thread worker;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping{false};
+    std::mutex busy; // held by the worker while it reads the grid
+
+    // Main-thread state.
+    std::uint64_t tick = 0;
+    int level = 1;
+    long searchMicros = 0;
+    sf::Vector2i lastNext[MAX_GHOSTS];
+    GhostDirection lastHeading[MAX_GHOSTS]{};
+    std::uint64_t committedAt[MAX_GHOSTS]{}; // tick each ghost committed to its current move
+    long applied = 0;
+    long fallbacks = 0;
+    std::atomic<long> workerSnapshots{0};
+
+    void run();
+    void publishSnapshot(const GhostAI &ai, const std::vector<Ghost> &ghosts, const Muncher &muncher);
+    static bool sameView(const GhostView &a, const GhostView &b)
+    {
+        return a.tile == b.tile && a.heading == b.heading && a.type == b.type && a.doorOpen == b.doorOpen &&
+               a.personality == b.personality && a.scatter == b.scatter;
+    }
+};
+
+inline AsyncGhostAI::AsyncGhostAI(const Grid &g) : grid(g)
+{
+    worker = std::thread(&AsyncGhostAI::run, this);
+    std::cout << "Ghost AI running on a worker thread" << std::endl;
+}
+
+inline AsyncGhostAI::~AsyncGhostAI()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable())
+        worker.join();
+}
+
+inline void AsyncGhostAI::configure(int lvl, long micros)
+{
+    level = lvl;
+    searchMicros = micros;
+}
+
+inline void AsyncGhostAI::update(GhostAI &ai, std::vector<Ghost> &ghosts, const Muncher &muncher, const Grid &g)
+{
+    std::uint64_t start = ai.getTrace() ? AITrace::nowNanos() : 0;
+    ai.beginTick(ghosts);
+    ++tick;
+
+    decisions.update();
+    const Decisions &ready = decisions.readBuffer();
+
+    const AIMode mode = ai.getCurrentMode();
+    const MuncherView muncherView = GhostAI::viewOf(muncher);
+    const Ghost *chaser = ai.getChaserGhost();
+    sf::Vector2i chaserTile = chaser ? chaser->getPosition() : sf::Vector2i();
+
+    for (std::size_t i = 0; i < ghosts.size(); ++i)
+    {
+        Ghost &ghost = ghosts[i];
+        if (!GhostAI::needsDecision(ghost))
+            continue;
+
+        if (mode == AIMode::FRIGHTENED)
+        {
+            ai.steerFrightened(ghost, g, static_cast<int>(i));
+            continue;
+        }
+
+        GhostView view = GhostAI::viewOf(ghost);
+        GhostDirection dir;
+        const Decision *d = static_cast<int>(i) < ready.count ? &ready.ghosts[i] : nullptr;
+        if (d && d->valid && d->mode == mode && d->tick >= committedAt[i] && sameView(d->from, view))
+        {
+            dir = d->direction;
+            ++applied;
+            ai.recordWorkerDecision(static_cast<int>(i), g, view, muncherView, chaser ? &chaserTile : nullptr, mode, dir);
+        }
+        else
+        {
+            // Worker has not caught up with this ghost: same rule, decided now
+            // (ai's own search is left off in async mode, so this is greedy).
+            dir = ai.decide(g, view, muncherView, chaser ? &chaserTile : nullptr, mode, static_cast<int>(i));
+            ++fallbacks;
+        }
+        ghost.startMovement(g, dir);
+    }
+
+    // Snapshot after this frame's moves have started, so every ghost's next
+    // tile is where its following decision will be needed.
+    publishSnapshot(ai, ghosts, muncher);
+
+    if (ai.getTrace())
+        ai.getTrace()->getCounters().updateNanos += AITrace::nowNanos() - start;
+}
+
+inline void AsyncGhostAI::publishSnapshot(const GhostAI &ai, const std::vector<Ghost> &ghosts, const Muncher &muncher)
+{
+    Snapshot &s = snapshots.writeBuffer();
+    s.tick = tick;
+    s.mode = ai.getCurrentMode();
+    s.muncher = GhostAI::viewOf(muncher);
+    s.hasChaser = ai.getChaserGhost() != nullptr;
+    s.chaserTile = s.hasChaser ? ai.getChaserGhost()->getPosition() : sf::Vector2i();
+    s.level = level;
+    s.searchMicros = searchMicros;
+    s.ghostCount = std::min(static_cast<int>(ghosts.size()), MAX_GHOSTS);
+    for (int i = 0; i < s.ghostCount; ++i)
+    {
+        const Ghost &ghost = ghosts[i];
+        GhostView view = GhostAI::viewOf(ghost);
+        view.tile = ghost.getNextTile();
+        s.ghosts[i].view = view;
+        s.ghosts[i].steer = ghost.getState() != GhostState::RETURNING && !ghost.getIsEaten();
+
+        if (view.tile != lastNext[i] || view.heading != lastHeading[i])
+        {
+            committedAt[i] = tick;
+            lastNext[i] = view.tile;
+            lastHeading[i] = view.heading;
+        }
+    }
+    snapshots.publish();
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex); // pairs with the worker's predicate check
+    }
+    wake.notify_one();
+}
+
+inline void AsyncGhostAI::run()
+{
+    GhostAI brain(grid.getWidth(), grid.getHeight());
+    int brainWidth = grid.getWidth(), brainHeight = grid.getHeight();
+    int brainLevel = -1;
+    long brainBudget = -1;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait(lock, [this] { return stopping.load() || snapshots.hasFresh(); });
+            if (stopping)
+                return;
+        }
+
+        std::lock_guard<std::mutex> hold(busy);
+        snapshots.update();
+        const Snapshot &s = snapshots.readBuffer();
+
+        // Scatter corners come from the map size; depth from the level.
+        if (grid.getWidth() != brainWidth || grid.getHeight() != brainHeight)
+        {
+            brainWidth = grid.getWidth();
+            brainHeight = grid.getHeight();
+            brain = GhostAI(brainWidth, brainHeight);
+            brainLevel = -1;
+        }
+        if (s.level != brainLevel || s.searchMicros != brainBudget)
+        {
+            brainLevel = s.level;
+            brainBudget = s.searchMicros;
+            brain.setLevel(brainLevel);
+            brain.setSearchBudget(brainBudget);
+        }
+
+        Decisions &out = decisions.writeBuffer();
+        out.count = s.ghostCount;
+        for (int i = 0; i < s.ghostCount; ++i)
+        {
+            Decision &d = out.ghosts[i];
+            d.valid = s.ghosts[i].steer && s.mode != AIMode::FRIGHTENED;
+            d.tick = s.tick;
+            d.mode = s.mode;
+            d.from = s.ghosts[i].view;
+            if (d.valid)
+                d.direction = brain.decide(grid, d.from, s.muncher, s.hasChaser ? &s.chaserTile : nullptr, s.mode);
+        }
+        decisions.publish();
+        workerSnapshots.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+#endif // ASYNCGHOSTAI_H
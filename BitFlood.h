@@ -0,0 +1,444 @@
+#ifndef BITFLOOD_H
+#define BITFLOOD_H
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Grid.h"
+
+// One bit per tile, row by row: row y is `stride` 64-bit words, tile x in
+// bit x & 63 of word x >> 6. Bits past the right edge stay clear.
+class BitBoard
+{
+public:
+    BitBoard() = default;
+    BitBoard(int w, int h) { resize(w, h); }
+
+    void resize(int w, int h)
+    {
+        width = w;
+        height = h;
+        stride = (w + 63) / 64;
+        words.assign(static_cast<std::size_t>(stride) * h, 0);
+    }
+    bool test(int x, int y) const { return words[static_cast<std::size_t>(y) * stride + (x >> 6)] >> (x & 63) & 1; }
+    void set(int x, int y) { words[static_cast<std::size_t>(y) * stride + (x >> 6)] |= 1ULL << (x & 63); }
+    void put(int x, int y, bool on)
+    {
+        std::uint64_t &w = words[static_cast<std::size_t>(y) * stride + (x >> 6)];
+        w = on ? w | 1ULL << (x & 63) : w & ~(1ULL << (x & 63));
+    }
+    std::uint64_t *row(int y) { return &words[static_cast<std::size_t>(y) * stride]; }
+    const std::uint64_t *row(int y) const { return &words[static_cast<std::size_t>(y) * stride]; }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getStride() const { return stride; }
+
+private:
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    std::vector<std::uint64_t> words;
+};
+
+// Who can walk where on a map, as bitboards for BitFlood: built once per map
+// and cached on the grid like PelletLayout. After a few tile edits (a door
+// toggled, a live reload) the cached masks are copied with just those tiles
+// redone, instead of reading the whole board again.
+class PassMasks
+{
+public:
+    BitBoard eyes;    // returning eyes: open tiles, the ghost door, the ghost house
+    BitBoard ghosts;  // live ghosts: open tiles and the door (ThreatMap)
+    BitBoard muncher; // open tiles only
+    BitBoard home;    // GHOST_SPAWN tiles
+    // Tunnel warps, both ways round (from, to): one step for the muncher.
+    std::vector<std::pair<sf::Vector2i, sf::Vector2i>> tunnels;
+    std::uint64_t version = 0; // the grid's, when these were made
+
+    explicit PassMasks(const Grid &grid);
+    // `old` with `cells` re-read from `grid`.
+    PassMasks(const PassMasks &old, const Grid &grid, const std::vector<sf::Vector2i> &cells);
+    static std::shared_ptr<const PassMasks> of(const Grid &grid);
+
+private:
+    void classify(const Grid &grid, int x, int y);
+    void findTunnels(const Grid &grid);
+};
+
+// Bit-parallel breadth-first search. Each BFS layer is a bitboard; the next
+// one is the current layer shifted one tile each way (a whole 64-tile word
+// per shift) and ORed with the rows above and below, masked by the walkable
+// tiles not yet reached. Only the rows between the frontier's top and bottom
+// are touched, so a bounded flood costs its own height, not the board's.
+//
+// Tile order inside a layer is lost, but a first step can still be read off
+// exactly (firstStep): walk back from the goals keeping only tiles on some
+// shortest path, and take the first direction, in UP, DOWN, LEFT, RIGHT
+// order, that lands on one. That is the step a FIFO BFS expanding
+// neighbours in that order would have taken.
+//
+// Holds its layers between calls; one per thread (scratch()) is plenty.
+class BitFlood
+{
+public:
+    using Tunnels = std::vector<std::pair<sf::Vector2i, sf::Vector2i>>;
+
+    // Flood `pass` from `start` out to `maxDepth` steps, stopping early at
+    // the first layer that holds a `targets` tile. Tunnel warps (optional)
+    // are one step each. Returns that layer's depth, or -1 if no target was
+    // met (always, without targets).
+    int flood(const BitBoard &pass, sf::Vector2i start, int maxDepth = std::numeric_limits<int>::max(),
+              const BitBoard *targets = nullptr, const Tunnels *tunnels = nullptr);
+
+    // After a flood that met its targets: the first step towards the nearest
+    // one, as a direction 0 UP, 1 DOWN, 2 LEFT, 3 RIGHT (a tunnel warp is the
+    // step off the map edge); -1 if the start is itself a target.
+    int firstStep();
+
+    int getDepth() const { return static_cast<int>(layers.size()) - 1; } // deepest layer made
+    long getCellsReached() const { return cellsReached; }
+    bool reached(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height && visited.test(x, y); }
+
+    // Visit every tile `depth` steps out: f(x, y).
+    template <typename F>
+    void forEachCell(int depth, F &&f) const;
+
+    static BitFlood &scratch();
+
+private:
+    struct Layer
+    {
+        int lo, hi;         // rows holding its tiles
+        std::size_t offset; // of row lo in layerWords
+    };
+
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    sf::Vector2i start;
+    const BitBoard *floodTargets = nullptr;
+    const Tunnels *floodTunnels = nullptr;
+    int hitDepth = -1; // layer the last flood met its targets at
+    BitBoard visited;
+    int visitedLo = 0, visitedHi = -1; // rows of `visited` that may hold bits
+    std::vector<Layer> layers;
+    std::vector<std::uint64_t> layerWords;
+    std::vector<std::uint64_t> trail, trailNext; // firstStep's walk back
+    long cellsReached = 0;
+
+    const std::uint64_t *layerRow(int depth, int y) const
+    {
+        const Layer &l = layers[depth];
+        return y < l.lo || y > l.hi ? nullptr : &layerWords[l.offset + static_cast<std::size_t>(y - l.lo) * stride];
+    }
+    bool inLayer(int depth, int x, int y) const
+    {
+        const std::uint64_t *r = layerRow(depth, y);
+        return r && (r[x >> 6] >> (x & 63) & 1);
+    }
+    // dst |= src dilated one tile left and right.
+    void spreadRow(const std::uint64_t *src, std::uint64_t *dst) const
+    {
+        for (int w = 0; w < stride; ++w)
+        {
+            std::uint64_t s = src[w];
+            std::uint64_t left = s >> 1 | (w + 1 < stride ? src[w + 1] << 63 : 0);
+            std::uint64_t right = s << 1 | (w > 0 ? src[w - 1] >> 63 : 0);
+            dst[w] |= s | left | right;
+        }
+    }
+    void reset(const BitBoard &pass);
+};
+
+inline PassMasks::PassMasks(const Grid &grid) : version(grid.getVersion())
+{
+    const int w = grid.getWidth();
+    const int h = grid.getHeight();
+    eyes.resize(w, h);
+    ghosts.resize(w, h);
+    muncher.resize(w, h);
+    home.resize(w, h);
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+            classify(grid, x, y);
+    findTunnels(grid);
+}
+
+inline PassMasks::PassMasks(const PassMasks &old, const Grid &grid, const std::vector<sf::Vector2i> &cells)
+    : eyes(old.eyes), ghosts(old.ghosts), muncher(old.muncher), home(old.home), version(grid.getVersion())
+{
+    for (const sf::Vector2i &c : cells)
+        classify(grid, c.x, c.y);
+    findTunnels(grid);
+}
+
+inline void PassMasks::classify(const Grid &grid, int x, int y)
+{
+    const bool wall = grid.isWall(x, y);
+    const bool door = grid.isGhostDoor(x, y);
+    const bool spawn = grid.isGhostSpawn(x, y);
+    eyes.put(x, y, !wall || door || spawn);
+    ghosts.put(x, y, !wall || door);
+    muncher.put(x, y, !wall);
+    home.put(x, y, spawn);
+}
+
+inline void PassMasks::findTunnels(const Grid &grid)
+{
+    tunnels.clear();
+    for (const sf::Vector2i &t : grid.teleportTiles)
+    {
+        sf::Vector2i partner = grid.getTeleportPartner(t.x, t.y);
+        if (grid.isValidPosition(partner.x, partner.y))
+            tunnels.emplace_back(t, partner);
+    }
+}
+
+inline std::shared_ptr<const PassMasks> PassMasks::of(const Grid &grid)
+{
+    std::shared_ptr<const PassMasks> cached = std::atomic_load(&grid.passMasks);
+    if (cached && cached->version == grid.getVersion())
+        return cached;
+    std::vector<sf::Vector2i> cells;
+    std::shared_ptr<const PassMasks> built;
+    if (cached && grid.cellsChangedSince(cached->version, cells))
+        built = std::make_shared<const PassMasks>(*cached, grid, cells);
+    else
+        built = std::make_shared<const PassMasks>(grid);
+    std::atomic_store(&grid.passMasks, built);
+    return built;
+}
+
+inline BitFlood &BitFlood::scratch()
+{
+    static thread_local BitFlood flood;
+    return flood;
+}
+
+inline void BitFlood::reset(const BitBoard &pass)
+{
+    if (pass.getWidth() != width || pass.getHeight() != height)
+    {
+        width = pass.getWidth();
+        height = pass.getHeight();
+        stride = pass.getStride();
+        visited.resize(width, height);
+        trail.assign(static_cast<std::size_t>(stride) * height, 0);
+        trailNext.assign(trail.size(), 0);
+    }
+    else if (visitedLo <= visitedHi)
+    {
+        // Only the rows the last flood got to need clearing.
+        std::fill(visited.row(visitedLo), visited.row(visitedHi) + stride, 0);
+    }
+    visitedLo = 0;
+    visitedHi = -1;
+    layers.clear();
+    layerWords.clear();
+    cellsReached = 0;
+}
+
+inline int BitFlood::flood(const BitBoard &pass, sf::Vector2i from, int maxDepth, const BitBoard *targets,
+                           const Tunnels *tunnels)
+{
+    reset(pass);
+    hitDepth = -1;
+    start = from;
+    floodTargets = targets;
+    floodTunnels = tunnels;
+    if (from.x < 0 || from.x >= width || from.y < 0 || from.y >= height)
+        return -1;
+
+    // Layer 0: the start tile, walkable or not.
+    layers.push_back({from.y, from.y, 0});
+    layerWords.assign(stride, 0);
+    layerWords[from.x >> 6] = 1ULL << (from.x & 63);
+    visited.set(from.x, from.y);
+    visitedLo = visitedHi = from.y;
+    cellsReached = 1;
+    if (targets && targets->test(from.x, from.y))
+        return hitDepth = 0;
+
+    for (int depth = 1; depth <= maxDepth; ++depth)
+    {
+        const Layer prev = layers.back();
+        int lo = std::max(prev.lo - 1, 0);
+        int hi = std::min(prev.hi + 1, height - 1);
+        if (tunnels)
+        {
+            for (const auto &t : *tunnels)
+            {
+                if (inLayer(depth - 1, t.first.x, t.first.y))
+                {
+                    lo = std::min(lo, t.second.y);
+                    hi = std::max(hi, t.second.y);
+                }
+            }
+        }
+
+        const std::size_t base = layerWords.size();
+        layerWords.resize(base + static_cast<std::size_t>(hi - lo + 1) * stride, 0);
+        int newLo = height, newHi = -1;
+        bool hit = false;
+        for (int y = lo; y <= hi; ++y)
+        {
+            std::uint64_t *out = &layerWords[base + static_cast<std::size_t>(y - lo) * stride];
+            if (const std::uint64_t *r = layerRow(depth - 1, y))
+                spreadRow(r, out);
+            for (int dy = -1; dy <= 1; dy += 2)
+            {
+                if (const std::uint64_t *r = (y + dy >= 0 && y + dy < height) ? layerRow(depth - 1, y + dy) : nullptr)
+                    for (int w = 0; w < stride; ++w)
+                        out[w] |= r[w];
+            }
+            if (tunnels)
+            {
+                for (const auto &t : *tunnels)
+                    if (t.second.y == y && inLayer(depth - 1, t.first.x, t.first.y))
+                        out[t.second.x >> 6] |= 1ULL << (t.second.x & 63);
+            }
+
+            const std::uint64_t *open = pass.row(y);
+            std::uint64_t *seen = visited.row(y);
+            bool any = false;
+            for (int w = 0; w < stride; ++w)
+            {
+                out[w] &= open[w] & ~seen[w];
+                if (!out[w])
+                    continue;
+                any = true;
+                seen[w] |= out[w];
+                cellsReached += __builtin_popcountll(out[w]);
+                if (targets && (out[w] & targets->row(y)[w]))
+                    hit = true;
+            }
+            if (any)
+            {
+                newLo = std::min(newLo, y);
+                newHi = y;
+            }
+        }
+        if (newHi < 0)
+        {
+            layerWords.resize(base);
+            break; // nothing new: everything reachable is reached
+        }
+        layers.push_back({newLo, newHi, base + static_cast<std::size_t>(newLo - lo) * stride});
+        visitedLo = std::min(visitedLo, newLo);
+        visitedHi = std::max(visitedHi, newHi);
+        if (hit)
+            return hitDepth = depth;
+    }
+    return -1;
+}
+
+inline int BitFlood::firstStep()
+{
+    const int depth = hitDepth;
+    if (depth <= 0)
+        return -1;
+
+    // trail = the tiles of layer k on a shortest path to a target, from
+    // k = depth (the targets met) back down to k = 1 (the start's neighbours).
+    const Layer &last = layers[depth];
+    for (int y = last.lo; y <= last.hi; ++y)
+    {
+        const std::uint64_t *r = layerRow(depth, y);
+        const std::uint64_t *t = floodTargets->row(y);
+        for (int w = 0; w < stride; ++w)
+            trail[static_cast<std::size_t>(y) * stride + w] = r[w] & t[w];
+    }
+    for (int k = depth - 1; k >= 1; --k)
+    {
+        const Layer &l = layers[k];
+        const Layer &above = layers[k + 1];
+        for (int y = l.lo; y <= l.hi; ++y)
+        {
+            std::uint64_t *out = &trailNext[static_cast<std::size_t>(y) * stride];
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                int ty = y + dy;
+                if (ty < above.lo || ty > above.hi)
+                    continue;
+                const std::uint64_t *t = &trail[static_cast<std::size_t>(ty) * stride];
+                if (dy == 0)
+                    spreadRow(t, out);
+                else
+                    for (int w = 0; w < stride; ++w)
+                        out[w] |= t[w];
+            }
+        }
+        if (floodTunnels)
+        {
+            for (const auto &t : *floodTunnels)
+            {
+                const sf::Vector2i &from = t.first, &to = t.second;
+                if (to.y >= above.lo && to.y <= above.hi && inLayer(k, from.x, from.y) &&
+                    (trail[static_cast<std::size_t>(to.y) * stride + (to.x >> 6)] >> (to.x & 63) & 1))
+                    trailNext[static_cast<std::size_t>(from.y) * stride + (from.x >> 6)] |= 1ULL << (from.x & 63);
+            }
+        }
+        for (int y = l.lo; y <= l.hi; ++y)
+        {
+            const std::uint64_t *r = layerRow(k, y);
+            for (int w = 0; w < stride; ++w)
+                trailNext[static_cast<std::size_t>(y) * stride + w] &= r[w];
+        }
+        // Clear the rows just read, so both buffers stay zero outside use.
+        std::fill(trail.begin() + static_cast<std::ptrdiff_t>(above.lo) * stride,
+                  trail.begin() + static_cast<std::ptrdiff_t>(above.hi + 1) * stride, 0);
+        std::swap(trail, trailNext);
+    }
+
+    auto onTrail = [&](int x, int y)
+    {
+        return x >= 0 && x < width && y >= 0 && y < height &&
+               (trail[static_cast<std::size_t>(y) * stride + (x >> 6)] >> (x & 63) & 1);
+    };
+    static const int dx[4] = {0, 0, -1, 1}; // UP, DOWN, LEFT, RIGHT
+    static const int dy[4] = {-1, 1, 0, 0};
+    int step = -1;
+    for (int dir = 0; dir < 4 && step < 0; ++dir)
+    {
+        int nx = start.x + dx[dir];
+        int ny = start.y + dy[dir];
+        if (onTrail(nx, ny))
+            step = dir;
+        else if ((nx < 0 || nx >= width || ny < 0 || ny >= height) && floodTunnels)
+        {
+            // Off the edge: a warp, if the start is a tunnel mouth.
+            for (const auto &t : *floodTunnels)
+                if (t.first == start && onTrail(t.second.x, t.second.y))
+                    step = dir;
+        }
+    }
+
+    const Layer &first = layers[1];
+    std::fill(trail.begin() + static_cast<std::ptrdiff_t>(first.lo) * stride,
+              trail.begin() + static_cast<std::ptrdiff_t>(first.hi + 1) * stride, 0);
+    return step;
+}
+
+template <typename F>
+void BitFlood::forEachCell(int depth, F &&f) const
+{
+    const Layer &l = layers[depth];
+    for (int y = l.lo; y <= l.hi; ++y)
+    {
+        const std::uint64_t *r = layerRow(depth, y);
+        for (int w = 0; w < stride; ++w)
+        {
+            for (std::uint64_t bits = r[w]; bits; bits &= bits - 1)
+                f((w << 6) + __builtin_ctzll(bits), y);
+        }
+    }
+}
+
+#endif // BITFLOOD_H
@@ -0,0 +1,48 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <SFML/Graphics.hpp>
+
+// An sf::View that follows a point (the muncher) across a board that may be
+// far bigger than the window. The view is clamped so it never shows past the
+// board edge; on an axis where the whole board fits, it simply stays centred.
+class Camera
+{
+private:
+    sf::View view;
+    sf::Vector2f worldSize; // board size in pixels
+
+    static float clampAxis(float centre, float half, float world)
+    {
+        if (world <= 2.0f * half)
+            return world / 2.0f; // board fits on this axis: keep it centred
+        if (centre < half)
+            return half;
+        if (centre > world - half)
+            return world - half;
+        return centre;
+    }
+
+public:
+    Camera(float viewWidth, float viewHeight, float worldWidth, float worldHeight)
+        : view(sf::FloatRect(0.0f, 0.0f, viewWidth, viewHeight)), worldSize(worldWidth, worldHeight)
+    {
+        follow(sf::Vector2f(0.0f, 0.0f));
+    }
+
+    void follow(sf::Vector2f focus)
+    {
+        sf::Vector2f half = view.getSize() / 2.0f;
+        view.setCenter(clampAxis(focus.x, half.x, worldSize.x), clampAxis(focus.y, half.y, worldSize.y));
+    }
+
+    // True when the whole board is on screen (no scrolling needed).
+    bool showsWholeWorld() const
+    {
+        return worldSize.x <= view.getSize().x && worldSize.y <= view.getSize().y;
+    }
+
+    const sf::View &getView() const { return view; }
+};
+
+#endif // CAMERA_H
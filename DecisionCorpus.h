@@ -0,0 +1,253 @@
+#ifndef DECISIONCORPUS_H
+#define DECISIONCORPUS_H
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Grid.h"
+#include "Spookie_Chase.h"
+
+// Golden ghost decisions: scatter/chase decision points (a ghost on a tile,
+// waiting for its next move) with everything the decision depends on, and
+// what the current GhostAI made of it: the target (targetFor, the core of
+// getTargetTile) and the move (stepToward: the greedy step of
+// getBestDirection, or the hierarchical path's first step for a chase target
+// LONG_RANGE or more tiles off on a big board). tools/goldens.cpp records them from bot-played games and checks other
+// implementations of the same decision (a table-driven, a vectorised or a
+// junction-based one) against them, case by case.
+//
+// The corpus keeps the AI's quirks as they are: the ambusher facing UP aims
+// up AND left (the original arcade's overflow bug), and a faster AI that
+// "fixes" it is a mismatch like any other.
+//
+// A case needs no board to replay its target; its move also carries `open`
+// (the legal steps, by greedyFrom's rule) so grid-free implementations can
+// be checked too (routed moves still need the board). Implementations that
+// read the board get it from the file.
+//
+// File layout: FileHeader, the board (width x height flag bytes, row-major,
+// Grid::loadCells), then the cases, as written (little-endian).
+struct DecisionCase
+{
+    enum Flags : std::uint8_t
+    {
+        DOOR_OPEN = 1,   // the ghost may pass the ghost door (GhostView::doorOpen)
+        HAS_CHASER = 2,  // the line-up has a CHASER ghost (chaserX/Y hold its tile)
+        CLASSIC_SLOT = 4 // one of the line-up's first four ghosts (the four the game started with)
+    };
+
+    std::int16_t tileX, tileY;       // the ghost's tile
+    std::int16_t muncherX, muncherY; // the muncher's tile
+    std::int16_t chaserX, chaserY;   // the CHASER-personality ghost's tile (fickle ghosts aim off it)
+    std::int16_t scatterX, scatterY; // the ghost's scatter target, resolved
+    std::int16_t targetX, targetY;   // expected target
+    std::uint8_t mode;               // AIMode: SCATTER or CHASE
+    std::uint8_t heading;            // the ghost's GhostDirection
+    std::uint8_t muncherHeading;     // MuncherDirection
+    std::uint8_t personality;        // GhostPersonalities id
+    std::uint8_t type;               // GhostType
+    std::uint8_t flags;              // Flags
+    std::uint8_t open;               // bit per GhostDirection it may step to (UP=1, DOWN=2, LEFT=4, RIGHT=8)
+    std::uint8_t chosen;             // expected GhostDirection
+
+    GhostView ghostView() const
+    {
+        return GhostView{sf::Vector2i(tileX, tileY), static_cast<GhostDirection>(heading), static_cast<GhostType>(type),
+                         (flags & DOOR_OPEN) != 0, personality, sf::Vector2i(scatterX, scatterY)};
+    }
+    MuncherView muncherView() const
+    {
+        return MuncherView{sf::Vector2i(muncherX, muncherY), static_cast<MuncherDirection>(muncherHeading)};
+    }
+    sf::Vector2i chaserTile() const { return sf::Vector2i(chaserX, chaserY); }
+    const sf::Vector2i *chaser(sf::Vector2i &tile) const // null without a chaser, as GhostAI passes it
+    {
+        tile = chaserTile();
+        return (flags & HAS_CHASER) ? &tile : nullptr;
+    }
+    AIMode getMode() const { return static_cast<AIMode>(mode); }
+    sf::Vector2i target() const { return sf::Vector2i(targetX, targetY); }
+};
+static_assert(sizeof(DecisionCase) == 28, "DecisionCase is a file format");
+
+class DecisionCorpus
+{
+public:
+    static constexpr std::uint32_t FILE_MAGIC = 0x44474D50; // "PMGD"
+    static constexpr std::uint32_t FILE_VERSION = 2; // 2: CLASSIC_SLOT
+
+    struct FileHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t caseSize;
+        std::uint32_t caseCount;
+        std::int32_t width, height;
+    };
+
+    // A decision point as `ai` would see it, with its current answer; `slot`
+    // is the ghost's place in the line-up. The ghost's scatter target is
+    // resolved first (scatterFor), so the case does not depend on which
+    // GhostAI replays it.
+    static DecisionCase capture(const GhostAI &ai, const Grid &grid, GhostView ghost, const MuncherView &muncher,
+                                const sf::Vector2i *chaserTile, AIMode mode, int slot);
+
+    // The board the cases were recorded on (once, before adding cases).
+    void setBoard(const Grid &grid);
+    void add(const DecisionCase &c) { cases.push_back(c); }
+    // Drop repeated cases (games revisit the same decisions a lot); keeps
+    // first occurrences in order.
+    void dedupe();
+    // Keep `count` cases spread evenly over the corpus (a small corpus that
+    // still covers whole games, not just their openings).
+    void thin(std::size_t count);
+
+    bool save(const std::string &path) const;
+    bool load(const std::string &path);
+    void buildGrid(Grid &grid) const { grid.loadCells(width, height, cells.data()); }
+
+    const std::vector<DecisionCase> &getCases() const { return cases; }
+    std::size_t size() const { return cases.size(); }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> cells;
+    std::vector<DecisionCase> cases;
+};
+
+inline DecisionCase DecisionCorpus::capture(const GhostAI &ai, const Grid &grid, GhostView ghost,
+                                            const MuncherView &muncher, const sf::Vector2i *chaserTile, AIMode mode,
+                                            int slot)
+{
+    ghost.scatter = ai.scatterFor(ghost);
+    sf::Vector2i target = ai.targetFor(ghost, muncher, chaserTile, mode);
+
+    DecisionCase c{};
+    c.tileX = static_cast<std::int16_t>(ghost.tile.x);
+    c.tileY = static_cast<std::int16_t>(ghost.tile.y);
+    c.muncherX = static_cast<std::int16_t>(muncher.tile.x);
+    c.muncherY = static_cast<std::int16_t>(muncher.tile.y);
+    c.chaserX = static_cast<std::int16_t>(chaserTile ? chaserTile->x : 0);
+    c.chaserY = static_cast<std::int16_t>(chaserTile ? chaserTile->y : 0);
+    c.scatterX = static_cast<std::int16_t>(ghost.scatter.x);
+    c.scatterY = static_cast<std::int16_t>(ghost.scatter.y);
+    c.targetX = static_cast<std::int16_t>(target.x);
+    c.targetY = static_cast<std::int16_t>(target.y);
+    c.mode = static_cast<std::uint8_t>(mode);
+    c.heading = static_cast<std::uint8_t>(ghost.heading);
+    c.muncherHeading = static_cast<std::uint8_t>(muncher.heading);
+    c.personality = static_cast<std::uint8_t>(ghost.personality);
+    c.type = static_cast<std::uint8_t>(ghost.type);
+    c.flags = static_cast<std::uint8_t>((ghost.doorOpen ? DecisionCase::DOOR_OPEN : 0) |
+                                        (chaserTile ? DecisionCase::HAS_CHASER : 0) |
+                                        (slot < 4 ? DecisionCase::CLASSIC_SLOT : 0));
+    for (GhostDirection dir : {GhostDirection::UP, GhostDirection::DOWN, GhostDirection::LEFT, GhostDirection::RIGHT})
+    {
+        sf::Vector2i p = ghost.tile + GhostAI::getDirectionOffset(dir);
+        if (grid.isValidPosition(p.x, p.y) && (!grid.isWall(p.x, p.y) || (grid.isGhostDoor(p.x, p.y) && ghost.doorOpen)))
+            c.open |= static_cast<std::uint8_t>(1u << static_cast<int>(dir));
+    }
+    c.chosen = static_cast<std::uint8_t>(ai.stepToward(grid, ghost, target, mode));
+    return c;
+}
+
+inline void DecisionCorpus::setBoard(const Grid &grid)
+{
+    width = grid.getWidth();
+    height = grid.getHeight();
+    cells.resize(static_cast<std::size_t>(width) * height);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            cells[static_cast<std::size_t>(y) * width + x] = static_cast<std::uint8_t>(grid.getFlags(x, y));
+}
+
+inline void DecisionCorpus::dedupe()
+{
+    auto less = [](const DecisionCase &a, const DecisionCase &b) { return std::memcmp(&a, &b, sizeof(a)) < 0; };
+    std::vector<std::uint32_t> order(cases.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        order[i] = static_cast<std::uint32_t>(i);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::uint32_t a, std::uint32_t b) { return less(cases[a], cases[b]); });
+
+    // Keep the first index of each run of equal cases, then restore order.
+    std::vector<std::uint32_t> kept;
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        if (i == 0 || less(cases[order[i - 1]], cases[order[i]]))
+            kept.push_back(order[i]);
+    }
+    std::sort(kept.begin(), kept.end());
+    std::vector<DecisionCase> unique;
+    unique.reserve(kept.size());
+    for (std::uint32_t i : kept)
+        unique.push_back(cases[i]);
+    cases.swap(unique);
+}
+
+inline void DecisionCorpus::thin(std::size_t count)
+{
+    if (count >= cases.size())
+        return;
+    std::vector<DecisionCase> kept;
+    kept.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        kept.push_back(cases[i * cases.size() / count]);
+    cases.swap(kept);
+}
+
+inline bool DecisionCorpus::save(const std::string &path) const
+{
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        std::cout << "Cannot write decision corpus " << path << std::endl;
+        return false;
+    }
+    FileHeader header{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.caseSize = sizeof(DecisionCase);
+    header.caseCount = static_cast<std::uint32_t>(cases.size());
+    header.width = width;
+    header.height = height;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (cells.empty() || std::fwrite(cells.data(), 1, cells.size(), file) == cells.size()) &&
+              (cases.empty() || std::fwrite(cases.data(), sizeof(DecisionCase), cases.size(), file) == cases.size());
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok)
+        std::cout << "Failed writing decision corpus " << path << std::endl;
+    return ok;
+}
+
+inline bool DecisionCorpus::load(const std::string &path)
+{
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    FileHeader header{};
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 && header.magic == FILE_MAGIC &&
+              header.version == FILE_VERSION && header.caseSize == sizeof(DecisionCase) && header.width > 0 &&
+              header.height > 0;
+    if (ok)
+    {
+        width = header.width;
+        height = header.height;
+        cells.resize(static_cast<std::size_t>(width) * height);
+        cases.resize(header.caseCount);
+        ok = std::fread(cells.data(), 1, cells.size(), file) == cells.size() &&
+             (cases.empty() || std::fread(cases.data(), sizeof(DecisionCase), cases.size(), file) == cases.size());
+    }
+    std::fclose(file);
+    return ok;
+}
+
+#endif // DECISIONCORPUS_H
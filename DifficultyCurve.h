@@ -0,0 +1,133 @@
+#ifndef DIFFICULTYCURVE_H
+#define DIFFICULTYCURVE_H
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The knobs that make one level harder than the last.
+struct LevelDifficulty
+{
+    float ghostSecondsPerTile; // ghost move time; lower = faster (the muncher takes 0.3)
+    float scatterTime;         // seconds per scatter phase
+    float chaseTime;           // seconds per chase phase
+    float frightenedTime;      // seconds a power pellet lasts
+};
+
+// Difficulty per level. Empty, it is the hand-picked ramp the game always had
+// (standard()); loaded from a file (tools/tune.cpp writes them), level N uses
+// line N and the last line carries on for every level past the end.
+//
+// File format, one level per line in order from level 1, '#' for comments:
+//   <ghost seconds per tile> <scatter s> <chase s> <frightened s>
+class DifficultyCurve
+{
+public:
+    // The original linear ramps and clamps.
+    static LevelDifficulty standard(int level);
+
+    LevelDifficulty at(int level) const;
+    int getLevels() const { return static_cast<int>(levels.size()); }
+    void set(int level, const LevelDifficulty &d); // grows the table (filling with standard())
+
+    bool load(const std::string &path);
+    // `comments` (one per level, may be shorter) are written after each line.
+    bool save(const std::string &path, const std::vector<std::string> &comments = {}) const;
+
+private:
+    std::vector<LevelDifficulty> levels;
+};
+
+inline LevelDifficulty DifficultyCurve::standard(int level)
+{
+    int n = (level > 1) ? (level - 1) : 0; // steps above level 1
+    LevelDifficulty d;
+    d.ghostSecondsPerTile = std::max(0.2f, 0.4f - n * 0.025f);
+    d.scatterTime = std::max(3.0f, 7.0f - n * 0.5f);
+    d.chaseTime = std::min(40.0f, 20.0f + n * 2.0f);
+    d.frightenedTime = std::max(1.0f, 10.0f - n * 1.0f);
+    return d;
+}
+
+inline LevelDifficulty DifficultyCurve::at(int level) const
+{
+    if (levels.empty())
+        return standard(level);
+    int i = std::min(std::max(level, 1), getLevels()) - 1;
+    return levels[i];
+}
+
+inline void DifficultyCurve::set(int level, const LevelDifficulty &d)
+{
+    while (getLevels() < level)
+        levels.push_back(standard(getLevels() + 1));
+    levels[level - 1] = d;
+}
+
+inline bool DifficultyCurve::load(const std::string &path)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::cout << "Cannot open difficulty curve " << path << std::endl;
+        return false;
+    }
+
+    std::vector<LevelDifficulty> loaded;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+        std::istringstream fields(line);
+        LevelDifficulty d;
+        if (!(fields >> d.ghostSecondsPerTile >> d.scatterTime >> d.chaseTime >> d.frightenedTime) ||
+            d.ghostSecondsPerTile <= 0.0f || d.scatterTime <= 0.0f || d.chaseTime <= 0.0f || d.frightenedTime < 0.0f)
+        {
+            std::cout << path << ":" << lineNumber << ": expected 4 positive numbers" << std::endl;
+            return false;
+        }
+        loaded.push_back(d);
+    }
+    if (loaded.empty())
+    {
+        std::cout << path << ": no levels" << std::endl;
+        return false;
+    }
+
+    levels = loaded;
+    std::cout << "Difficulty curve: " << levels.size() << " levels from " << path << std::endl;
+    return true;
+}
+
+inline bool DifficultyCurve::save(const std::string &path, const std::vector<std::string> &comments) const
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        std::cout << "Cannot write difficulty curve " << path << std::endl;
+        return false;
+    }
+    out << "# Munch Maze difficulty curve: one line per level from level 1; the last repeats.\n"
+        << "# ghost_s_per_tile scatter_s chase_s frightened_s\n";
+    out << std::fixed;
+    for (int i = 0; i < getLevels(); ++i)
+    {
+        const LevelDifficulty &d = levels[i];
+        out << std::setprecision(3) << d.ghostSecondsPerTile << " " << std::setprecision(2) << d.scatterTime << " "
+            << d.chaseTime << " " << d.frightenedTime;
+        if (i < static_cast<int>(comments.size()) && !comments[i].empty())
+            out << "  # " << comments[i];
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+#endif // DIFFICULTYCURVE_H
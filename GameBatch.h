@@ -0,0 +1,69 @@
+#ifndef GAMEBATCH_H
+#define GAMEBATCH_H
+
+#include <SFML/System.hpp>
+#include <vector>
+#include "GameSession.h"
+#include "GreedyBatch.h"
+
+// A small set of independent headless games (one per lane, 8 or 16) stepped
+// in lockstep on one thread: each frame every game runs up to its ghost AI,
+// the scatter/chase greedy steps of all of them are scored together on
+// vector registers (GreedyBatch), then every game finishes its frame. Games
+// play exactly as they would stepped one by one; this multiplies what one
+// thread gets through on top of running one batch per core (Parallel.h),
+// for tuning and RL workloads.
+//
+// Lanes that are over (or that the caller stops stepping) just sit out.
+class GameBatch
+{
+public:
+    static constexpr int MAX_LANES = 16;
+
+    GameBatch(const Grid &grid, int lanes);
+
+    int size() const { return static_cast<int>(games.size()); }
+    GameSession &lane(int i) { return games[i]; }
+    const GameSession &lane(int i) const { return games[i]; }
+
+    // One frame of every lane in `active` (null = every lane not over).
+    void step(sf::Time dt, const std::vector<bool> *active = nullptr);
+
+    long getBatchedSteps() const { return batchedSteps; } // greedy steps scored on the batch
+
+private:
+    std::vector<GameSession> games;
+    std::vector<bool> running; // per lane, this frame
+    GreedyBatch greedy;
+    long batchedSteps = 0;
+};
+
+inline GameBatch::GameBatch(const Grid &grid, int lanes)
+{
+    lanes = lanes < 1 ? 1 : (lanes > MAX_LANES ? MAX_LANES : lanes);
+    games.reserve(lanes);
+    for (int i = 0; i < lanes; ++i)
+        games.push_back(GameSession::headless(grid));
+    running.assign(lanes, false);
+}
+
+inline void GameBatch::step(sf::Time dt, const std::vector<bool> *active)
+{
+    greedy.clear();
+    for (int i = 0; i < size(); ++i)
+    {
+        bool on = active ? (*active)[i] : !games[i].isGameOver();
+        running[i] = on && games[i].beginStep(dt, greedy, i);
+    }
+
+    greedy.solve();
+    batchedSteps += greedy.size();
+
+    for (int i = 0; i < size(); ++i)
+    {
+        if (running[i])
+            games[i].finishStep(greedy, i);
+    }
+}
+
+#endif // GAMEBATCH_H
@@ -0,0 +1,815 @@
+#ifndef GAMESESSION_H
+#define GAMESESSION_H
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Grid.h"
+#include "PelletGrid.h"
+#include "Pellet.h"
+#include "Muncher.h"
+#include "Spookies.h"
+#include "Spookie_Chase.h"
+#include "AsyncGhostAI.h"
+#include "DifficultyCurve.h"
+#include "GameConfig.h"
+#include "PausableClock.h"
+#include "TimerWheel.h"
+#include "TileEvents.h"
+#include "Zobrist.h"
+#include "StateChecksum.h"
+#include "SpriteSheet.h"
+
+// One game of Munch Maze without the window: the actors, pellets, score,
+// lives, level and every rule that moves them on. main.cpp draws it and feeds
+// it keyboard input; headless runs (bots, soak tests, benchmarks) step it on
+// simulated time with no window or sprite sheet at all.
+//
+// Input goes through setDesiredDirection, the same buffered turn the arrow
+// keys set, so anything that can play the game headless plays it exactly as a
+// person at the keyboard would.
+class GameSession
+{
+public:
+    // Windowed: runs on the wall clock; sheet supplies the sprite frames.
+    GameSession(const Grid &grid, const SpriteSheet *sheet);
+
+    // Headless: no sprites, quiet, and on simulated time from zero (advance
+    // it with step()). Sessions are independent, so one per thread is fine.
+    static GameSession headless(const Grid &grid);
+
+    // A headless copy of this exact moment (for rollouts): it continues on its
+    // own simulated time from now and never touches this session again.
+    GameSession fork() const;
+
+    // Buffered turn: taken at the next tile where it is open, as the arrow keys do.
+    void setDesiredDirection(MuncherDirection dir)
+    {
+        desiredDir = dir;
+        hasStarted = true;
+    }
+    MuncherDirection getDesiredDirection() const { return desiredDir; }
+
+    // One frame of game rules on the current clock. Does nothing once over.
+    void update();
+    // Headless: advance simulated time by dt, then update().
+    void step(sf::Time dt);
+    // step() in two halves around a shared greedy solve, for games stepped
+    // in lockstep (GameBatch): beginStep queues this game's scatter/chase
+    // steps on `batch` as `lane`; after batch.solve(), finishStep takes them
+    // and runs the rest of the frame (only if beginStep returned true).
+    bool beginStep(sf::Time dt, GreedyBatch &batch, int lane);
+    void finishStep(const GreedyBatch &batch, int lane);
+
+    void restart(); // new game after GAME OVER (level 1, fresh score and lives)
+    void setPaused(bool p);
+    void setLevel(int lvl); // jump to a level's difficulty (dev keys)
+    // Per-level ghost speed and mode times; null = the standard ramp. Not
+    // copied: the curve must outlive the session (and its forks).
+    void setDifficulty(const DifficultyCurve *curve);
+    // Ghost AI instrumentation (AITrace.h); null = off. Forks never trace.
+    void setTrace(AITrace *t)
+    {
+        trace = t;
+        ghostAI.setTrace(t);
+    }
+    // Reseed the frightened-ghost wandering (headless runs that want varied games).
+    void seed(unsigned s) { ghostAI.random().seed(s); }
+
+    // Ghost line-up: one GhostPersonalities id per ghost, any number of them
+    // (large swarms on big custom maps). Colours follow GhostType in turn, so
+    // the first four keep the classic look. Rebuilds the ghosts at their
+    // spawn tiles; the default line-up is the classic four.
+    void setRoster(const std::vector<int> &personalities);
+
+    // AI options, re-applied whenever the level changes.
+    void setSearchBudget(long micros);
+    void setAsyncAI(AsyncGhostAI *ai);
+    void setVerbose(bool v) { verbose = v; }
+    void setInvincible(bool on) { invincible = on; }
+
+    // The grid changed in place under this session (live reload): refresh the
+    // pellets on `changed` cells (everything when resized), follow the ghost
+    // homes, and put back any actor a new wall landed on.
+    void onMapChanged(bool resized, const std::vector<sf::Vector2i> &changed);
+
+    const Grid &getGrid() const { return *grid; }
+    const Muncher &getMuncher() const { return muncher; }
+    Muncher &getMuncher() { return muncher; }
+    const std::vector<Ghost> &getGhosts() const { return ghosts; }
+    std::vector<Ghost> &getGhosts() { return ghosts; }
+    const GhostAI &getGhostAI() const { return ghostAI; }
+    const PelletGrid &getPellets() const { return pelletGrid; }
+    PointSystem &getPoints() { return points; }
+    const PointSystem &getPoints() const { return points; }
+    const Pellet &getFruit() const { return fruitPellet; }
+    Pellet &getFruit() { return fruitPellet; }
+    bool isFruitShowing() const { return fruitPresent && !fruitPellet.isCollected(); }
+    int getLevel() const { return level; }
+    bool isDying() const { return muncherDying; }
+    bool isGameOver() const { return gameOver; }
+    bool isStarted() const { return hasStarted; }
+    bool isInvincible() const { return invincible; }
+    long getFrames() const { return frames; } // update() calls that ran game rules
+    sf::Time getTime() const { return simulated ? simTime : PausableClock::now(); }
+
+    // 64-bit Zobrist hash of the tile-level state that lookahead decides on:
+    // the pellets left, the muncher's and each ghost's next tile and heading,
+    // ghost states, the AI mode, level, fruit and map version. Timers and
+    // in-between-tile progress are left out. Kept incrementally: the pellets
+    // by PelletGrid as they go, the rest one key per actor or feature, and
+    // only keys that changed since the last call are XORed over.
+    std::uint64_t getHash() const;
+    // Everything that moves the game on, bit for bit, a hash per field
+    // (StateChecksum.h): for replays and desync checks, not for lookahead.
+    // Computed from scratch on each call (a few hundred ns for the classic four).
+    StateChecksum getChecksum() const;
+
+private:
+    static constexpr float DEATH_ANIM_TIME = 1.2f; // ~one full death-frame cycle, then a brief hold
+    static constexpr float FRUIT_INTERVAL = 45.0f; // seconds to the first fruit, and between fruits
+
+    const Grid *grid;
+    const SpriteSheet *sheet; // null headless
+
+    // Simulated time (headless and forks); wall clock otherwise.
+    bool simulated = false;
+    sf::Time simTime;
+
+    PelletGrid pelletGrid;
+    Muncher muncher;
+    std::vector<Ghost> ghosts;
+    GhostAI ghostAI;
+    AsyncGhostAI *asyncAI = nullptr;
+    long searchMicros = 0;
+    const DifficultyCurve *difficulty = nullptr;
+    AITrace *trace = nullptr;
+
+    PointSystem points;
+    int level = 1;                                         // drives the difficulty ramp
+    int frightenedGhostsEaten = 0;                         // resets each power pellet; drives 200/400/800/1600
+    bool muncherDying = false;                             // true while the death animation plays
+    bool gameOver = false;                                 // true once lives hit 0
+    MuncherDirection desiredDir = MuncherDirection::RIGHT; // buffered input direction
+    bool hasStarted = false;                               // muncher waits for the first input
+    bool invincible = false;                               // dev: ignore ghost catches
+    bool verbose = true;                                   // console commentary (off headless)
+    long frames = 0;
+    std::uint64_t mapVersion = 0; // live reloads so far (part of the hash)
+
+    // getHash's per-feature keys (muncher, each ghost, then mode, level,
+    // fruit and map) and their XOR, brought up to date when it is asked for.
+    mutable std::vector<std::uint64_t> hashKeys;
+    mutable std::uint64_t hashedFeatures = 0;
+
+    // Game time (stops with the pause menu) and the deadlines on it: fruit,
+    // the death animation and the actors' animation frames (TimerWheel.h).
+    PausableClock gameClock;
+    TimerWheel timers;
+    std::vector<TimerWheel::Event> firedTimers;
+    std::vector<TimerWheel::Event> dueGhostFrames; // held back while the muncher dies
+    TimerWheel::TimerId deathTimer = 0;
+    sf::Time previousUpdate; // game time of the update before this one (swept contacts)
+    std::vector<std::pair<float, int>> contacts; // (when in the interval, ghost) this update
+
+    // Tile crossings reported by the actors this update (TileEvents.h). The
+    // muncher's tile is only looked at after it changes: pellets at the end
+    // of that update, fruit at the start of the next (as the rules order them).
+    TileEvents tileEvents;
+    bool pelletCheck = true;
+    bool fruitCheck = true;
+
+    bool fruitDue = false;          // FRUIT_DUE fired, no fruit spawned since
+    bool fruitPresent = false;      // fruit initially not present
+    bool waitingForRespawn = false; // waiting state after fruit is eaten
+    int currentFruitIndex = 0;
+    Pellet fruitPellet;
+
+    void applyDifficulty(int lvl);
+    void placeGhosts();  // spawn tiles and scatter targets from the current map
+    void placeFruit();   // the fruit tile from the current map
+    void resetAI();     // fresh scatter/chase cycle (keeps the frightened RNG going)
+    void resetActors(); // everyone back to their start tiles
+    bool beginUpdate(GreedyBatch *batch, int lane);
+    void finishUpdate(const GreedyBatch *batch, int lane);
+    void updateFruit();
+    void handleTileEvents();
+    void muncherEnteredTile() { pelletCheck = fruitCheck = true; }
+    void checkGhostContacts(float interval);
+    void eatPellets();
+};
+
+// Fruit types to cycle through
+static const PelletType FRUIT_CYCLE[] = {PelletType::APPLE, PelletType::CHERRY, PelletType::STRAWBERRY,
+                                         PelletType::ORANGE, PelletType::GRAPEFRUIT, PelletType::PANCAKE};
+
+inline GameSession::GameSession(const Grid &g, const SpriteSheet *sheetPtr)
+    : grid(&g), sheet(sheetPtr), pelletGrid(g),
+      muncher(g.getPlayerStartX(), g.getPlayerStartY(), GameConfig::CELL_SIZE, sheetPtr),
+      ghostAI(g.getWidth(), g.getHeight()),
+      fruitPellet(g.getPlayerStartX(), g.getPlayerStartY(), FRUIT_CYCLE[0], sheetPtr)
+{
+    placeFruit();
+
+    // The first fruit after 45 seconds; actors start their animation timers.
+    TimerWheel::Scope scope(timers);
+    timers.schedule(sf::seconds(FRUIT_INTERVAL), FRUIT_DUE);
+    muncher.restartAnimation();
+
+    // The classic four: JACK (Red, Chaser), MIKE (Blue, Ambusher),
+    // SAM (Purple, Fickle), WILL (Yellow, Bashful)
+    setRoster({GhostPersonalities::forType(GhostType::JACK), GhostPersonalities::forType(GhostType::MIKE),
+               GhostPersonalities::forType(GhostType::SAM), GhostPersonalities::forType(GhostType::WILL)});
+}
+
+inline GameSession GameSession::headless(const Grid &g)
+{
+    // Build under simulated time zero so every clock starts on the session's timeline.
+    const sf::Time zero = sf::Time::Zero;
+    PausableClock::SimulatedTime scope(zero);
+    GameSession session(g, nullptr);
+    session.simulated = true;
+    session.simTime = zero;
+    session.verbose = false;
+    return session;
+}
+
+inline GameSession GameSession::fork() const
+{
+    GameSession copy(*this);
+    copy.simTime = getTime(); // clocks were started on this timeline; carry on from here
+    copy.simulated = true;
+    copy.asyncAI = nullptr; // the worker belongs to the original
+    copy.setTrace(nullptr);  // lookahead play is not the game being measured
+    copy.verbose = false;
+    return copy;
+}
+
+inline void GameSession::step(sf::Time dt)
+{
+    simTime += dt;
+    PausableClock::SimulatedTime scope(simTime);
+    update();
+}
+
+inline std::uint64_t GameSession::getHash() const
+{
+    auto tileBits = [](sf::Vector2i t)
+    { return static_cast<std::uint64_t>(static_cast<std::uint32_t>(t.x)) | static_cast<std::uint64_t>(static_cast<std::uint32_t>(t.y)) << 32; };
+    auto refresh = [this](std::size_t slot, std::uint64_t key)
+    {
+        hashedFeatures ^= hashKeys[slot] ^ key;
+        hashKeys[slot] = key;
+    };
+
+    const std::size_t n = ghosts.size();
+    if (hashKeys.size() != n + 4)
+    {
+        hashKeys.assign(n + 4, 0); // roster changed: start over
+        hashedFeatures = 0;
+    }
+    refresh(0, zobristKey(ZobristFeature::MUNCHER, tileBits(muncher.getNextTile()),
+                          static_cast<std::uint64_t>(muncher.getDirection())));
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Ghost &g = ghosts[i];
+        std::uint64_t traits = i << 8 | static_cast<std::uint64_t>(g.getDirection()) << 4 |
+                               static_cast<std::uint64_t>(g.getState()) << 1 | (g.getIsEaten() ? 1u : 0u);
+        refresh(i + 1, zobristKey(ZobristFeature::GHOST, traits, tileBits(g.getNextTile())));
+    }
+    refresh(n + 1, zobristKey(ZobristFeature::MODE, static_cast<std::uint64_t>(ghostAI.getCurrentMode())));
+    refresh(n + 2, zobristKey(ZobristFeature::LEVEL, static_cast<std::uint64_t>(level)));
+    refresh(n + 3, zobristKey(ZobristFeature::FRUIT, isFruitShowing() ? 1 : 0) ^ zobristKey(ZobristFeature::MAP, mapVersion));
+    return hashedFeatures ^ pelletGrid.getHash();
+}
+
+inline StateChecksum GameSession::getChecksum() const
+{
+    using F = StateChecksum;
+    StateChecksum sum;
+    sum.add(F::MUNCHER, muncher.getPosition());
+    sum.add(F::MUNCHER, muncher.getNextTile());
+    sum.add(F::MUNCHER, muncher.getRenderPosition());
+    sum.add(F::MUNCHER, static_cast<std::uint64_t>(muncher.getDirection()) << 16 |
+                            static_cast<std::uint64_t>(muncher.getState()) << 8 |
+                            static_cast<std::uint64_t>(desiredDir) << 2 | (muncher.getIsMoving() ? 2u : 0u) |
+                            (hasStarted ? 1u : 0u));
+    sum.add(F::MUNCHER, muncher.getMovementSpeed());
+
+    sum.add(F::GHOSTS, static_cast<std::uint64_t>(ghosts.size()));
+    for (const Ghost &g : ghosts)
+    {
+        sum.add(F::GHOSTS, g.getPosition());
+        sum.add(F::GHOSTS, g.getNextTile());
+        sum.add(F::GHOSTS, g.getRenderPosition());
+        sum.add(F::GHOSTS, static_cast<std::uint64_t>(g.getDirection()) << 16 |
+                               static_cast<std::uint64_t>(g.getState()) << 8 | (g.getIsMoving() ? 2u : 0u) |
+                               (g.getIsEaten() ? 1u : 0u));
+        sum.add(F::GHOSTS, g.getMovementSpeed());
+    }
+
+    sum.add(F::PELLETS, pelletGrid.getHash());
+    sum.add(F::PELLETS, static_cast<std::uint64_t>(pelletGrid.countPellets()) << 32 |
+                            static_cast<std::uint32_t>(pelletGrid.countPowerPellets()));
+
+    sum.add(F::SCORE, static_cast<std::uint64_t>(points.getTotalPoints()));
+    sum.add(F::SCORE, static_cast<std::uint64_t>(points.getLives()));
+    sum.add(F::SCORE, static_cast<std::uint64_t>(level) << 8 | static_cast<std::uint64_t>(frightenedGhostsEaten) << 2 |
+                          (muncherDying ? 2u : 0u) | (gameOver ? 1u : 0u));
+
+    // The generator's next draw stands for its state (a copy; the game's is untouched).
+    std::minstd_rand rng = ghostAI.random();
+    sum.add(F::AI, static_cast<std::uint64_t>(ghostAI.getCurrentMode()));
+    sum.add(F::AI, static_cast<std::uint64_t>(rng()));
+
+    sum.add(F::FRUIT, static_cast<std::uint64_t>(currentFruitIndex) << 8 | (fruitPresent ? 8u : 0u) |
+                          (fruitDue ? 4u : 0u) | (waitingForRespawn ? 2u : 0u) | (fruitPellet.isCollected() ? 1u : 0u));
+
+    sum.add(F::CLOCK, static_cast<std::uint64_t>(getTime().asMicroseconds()));
+    sum.add(F::CLOCK, static_cast<std::uint64_t>(frames));
+    return sum;
+}
+
+inline void GameSession::setRoster(const std::vector<int> &personalities)
+{
+    const GhostType types[4] = {GhostType::JACK, GhostType::MIKE, GhostType::SAM, GhostType::WILL};
+    TimerWheel::Scope scope(timers);
+    for (auto &ghost : ghosts)
+        timers.cancel(ghost.getAnimationTimer());
+    ghosts.clear();
+    dueGhostFrames.clear();
+    for (std::size_t i = 0; i < personalities.size(); ++i)
+    {
+        // Created at the default spawn; placeGhosts moves them home.
+        ghosts.emplace_back(grid->getGhostSpawnX(), grid->getGhostSpawnY(), types[i % 4], GameConfig::CELL_SIZE, sheet);
+        ghosts.back().setPersonality(personalities[i]);
+        ghosts.back().setIndex(static_cast<int>(i));
+        ghosts.back().restartAnimation();
+    }
+    placeGhosts();
+    for (auto &ghost : ghosts)
+        ghost.reset();
+    applyDifficulty(level);
+}
+
+// Create Ghosts' homes at green GHOST_SPAWN tiles from the grid, and give
+// each a scatter target on this map.
+inline void GameSession::placeGhosts()
+{
+    // Fallback: spawn all at the first found (or the default) location
+    std::vector<sf::Vector2i> spawns = grid->findTiles(GHOST_SPAWN);
+    std::vector<sf::Vector2i> scatter = GhostAI::scatterTargets(*grid, static_cast<int>(ghosts.size()));
+    for (std::size_t i = 0; i < ghosts.size(); ++i)
+    {
+        if (!spawns.empty())
+        {
+            const sf::Vector2i &home = spawns.size() >= ghosts.size() ? spawns[i] : spawns[0];
+            ghosts[i].setSpawnPosition(home.x, home.y);
+        }
+        ghosts[i].setScatterTile(scatter[i]);
+    }
+}
+
+// The fruit goes on the open tile nearest the muncher's start (left first,
+// so the classic board keeps it at 13,18, beside the start): somewhere the
+// muncher walks past on any board size, never in a wall or the ghost door.
+inline void GameSession::placeFruit()
+{
+    const int width = grid->getWidth();
+    const int height = grid->getHeight();
+    sf::Vector2i start(std::max(0, std::min(width - 1, grid->getPlayerStartX())),
+                       std::max(0, std::min(height - 1, grid->getPlayerStartY())));
+
+    // Breadth-first over the board from the start, through walls too (a
+    // start painted into a wall still finds the nearest open tile).
+    std::vector<bool> seen(static_cast<std::size_t>(width) * height, false);
+    std::vector<sf::Vector2i> queue{start};
+    seen[static_cast<std::size_t>(start.y) * width + start.x] = true;
+    const sf::Vector2i steps[] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    for (std::size_t head = 0; head < queue.size(); ++head)
+    {
+        const sf::Vector2i tile = queue[head];
+        if (tile != start && !grid->isWall(tile.x, tile.y) && !grid->isGhostDoor(tile.x, tile.y))
+        {
+            fruitPellet.setPosition(tile.x, tile.y);
+            return;
+        }
+        for (const sf::Vector2i &step : steps)
+        {
+            sf::Vector2i next = tile + step;
+            if (grid->isValidPosition(next.x, next.y) && !seen[static_cast<std::size_t>(next.y) * width + next.x])
+            {
+                seen[static_cast<std::size_t>(next.y) * width + next.x] = true;
+                queue.push_back(next);
+            }
+        }
+    }
+    fruitPellet.setPosition(start.x, start.y); // nowhere else open
+}
+
+inline void GameSession::setSearchBudget(long micros)
+{
+    searchMicros = micros;
+    applyDifficulty(level);
+}
+
+inline void GameSession::setDifficulty(const DifficultyCurve *curve)
+{
+    difficulty = curve;
+    applyDifficulty(level);
+}
+
+inline void GameSession::setAsyncAI(AsyncGhostAI *ai)
+{
+    asyncAI = ai;
+    applyDifficulty(level);
+}
+
+inline void GameSession::setLevel(int lvl)
+{
+    level = lvl;
+    applyDifficulty(level);
+}
+
+// Apply per-level difficulty (ghost speed + AI mode durations). Re-called after
+// every level-up / death / restart, since ghostAI is rebuilt in those spots.
+inline void GameSession::applyDifficulty(int lvl)
+{
+    LevelDifficulty d = difficulty ? difficulty->at(lvl) : DifficultyCurve::standard(lvl);
+    ghostAI.setLevel(lvl, d);
+    if (asyncAI)
+    {
+        asyncAI->configure(lvl, searchMicros); // the worker searches...
+        ghostAI.setSearchBudget(0);            // ...in-frame fallbacks stay greedy
+    }
+    else
+        ghostAI.setSearchBudget(searchMicros); // lookahead depth follows the level
+    for (auto &ghost : ghosts)
+        ghost.setMovementSpeed(d.ghostSecondsPerTile); // seconds per tile; lower = faster
+}
+
+inline void GameSession::resetAI()
+{
+    std::minstd_rand rng = ghostAI.random();
+    ghostAI = GhostAI(grid->getWidth(), grid->getHeight()); // restart the scatter/chase cycle
+    ghostAI.random() = rng;
+    ghostAI.setTrace(trace);
+    applyDifficulty(level);
+}
+
+inline void GameSession::resetActors()
+{
+    muncher.reset(grid->getPlayerStartX(), grid->getPlayerStartY());
+    muncherEnteredTile();
+    for (auto &ghost : ghosts)
+        ghost.reset();
+    resetAI();
+}
+
+inline void GameSession::restart()
+{
+    points = PointSystem();
+    level = 1;
+    pelletGrid = PelletGrid(*grid);
+    resetActors(); // back to level-1 difficulty
+    frightenedGhostsEaten = 0;
+    muncherDying = false;
+    timers.cancel(deathTimer);
+    gameOver = false;
+    hasStarted = false; // fresh game waits for the first input
+}
+
+inline void GameSession::setPaused(bool p)
+{
+    muncher.setPaused(p);
+    for (auto &ghost : ghosts)
+        ghost.setPaused(p);
+    ghostAI.setPaused(p);
+    gameClock.setPaused(p);
+}
+
+inline void GameSession::update()
+{
+    if (beginUpdate(nullptr, 0))
+        finishUpdate(nullptr, 0);
+}
+
+inline bool GameSession::beginStep(sf::Time dt, GreedyBatch &batch, int lane)
+{
+    simTime += dt;
+    PausableClock::SimulatedTime scope(simTime);
+    return beginUpdate(&batch, lane);
+}
+
+inline void GameSession::finishStep(const GreedyBatch &batch, int lane)
+{
+    PausableClock::SimulatedTime scope(simTime);
+    finishUpdate(&batch, lane);
+}
+
+// update(), up to the ghost AI. False if the frame ends there (game over,
+// or the death pause).
+inline bool GameSession::beginUpdate(GreedyBatch *batch, int lane)
+{
+    if (gameOver)
+        return false;
+    ++frames;
+
+    // Deadlines that came due this frame; actors reschedule on this wheel.
+    TimerWheel::Scope scope(timers);
+    TileEvents::Scope tileScope(tileEvents);
+    firedTimers.clear();
+    previousUpdate = timers.getNow();
+    timers.advance(gameClock.getElapsedTime(), firedTimers);
+    bool deathOver = false;
+    for (const TimerWheel::Event &e : firedTimers)
+    {
+        switch (e.kind)
+        {
+        case FRUIT_DUE:
+            fruitDue = true; // spawned by updateFruit (not during the death pause)
+            break;
+        case DEATH_OVER:
+            deathOver = e.id == deathTimer;
+            break;
+        case MUNCHER_FRAME:
+            muncher.onAnimationTimer(e.id);
+            break;
+        case GHOST_FRAME:
+            dueGhostFrames.push_back(e);
+            break;
+        }
+    }
+
+    // Death pause: freeze gameplay, play the muncher's death animation, then
+    // reset everyone to their start tiles.
+    if (muncherDying)
+    {
+        if (deathOver)
+        {
+            muncherDying = false;
+            if (points.getLives() == 0)
+                gameOver = true; // out of lives -> game over (no respawn)
+            else
+                resetActors(); // ghostAI is rebuilt -> restores this level's difficulty
+        }
+        return false;
+    }
+
+    updateFruit();
+
+    // Update game objects
+    muncher.updateMovement();
+
+    // Update Ghost AI
+    if (asyncAI)
+        asyncAI->update(ghostAI, ghosts, muncher, *grid);
+    else if (batch)
+        ghostAI.queueUpdate(ghosts, muncher, *grid, *batch, lane);
+    else
+        ghostAI.update(ghosts, muncher, *grid);
+    return true;
+}
+
+// The rest of update(): batched ghost moves, movement, contacts, pellets.
+inline void GameSession::finishUpdate(const GreedyBatch *batch, int lane)
+{
+    TimerWheel::Scope scope(timers);
+    TileEvents::Scope tileScope(tileEvents);
+    if (batch)
+        ghostAI.applyBatch(ghosts, *grid, *batch, lane);
+
+    for (const TimerWheel::Event &e : dueGhostFrames)
+    {
+        if (e.data >= 0 && e.data < static_cast<int>(ghosts.size()))
+            ghosts[e.data].onAnimationTimer(e.id);
+    }
+    dueGhostFrames.clear();
+    for (auto &ghost : ghosts)
+        ghost.updateMovement(*grid, ghosts);
+
+    // Pac-Man style movement: at each tile take the buffered turn if it's
+    // open, otherwise keep heading the current way. Stays still until the
+    // first input.
+    if (hasStarted && !muncher.getIsMoving())
+    {
+        if (muncher.canMove(*grid, desiredDir))
+            muncher.startMovement(*grid, desiredDir);             // take the buffered turn
+        else
+            muncher.startMovement(*grid, muncher.getDirection()); // otherwise keep going
+    }
+
+    handleTileEvents();
+    checkGhostContacts((timers.getNow() - previousUpdate).asSeconds());
+    if (pelletCheck)
+        eatPellets();
+
+    // Level clear: every pellet eaten -> restart the board, keep score & lives.
+    if (pelletGrid.countPellets() == 0 && pelletGrid.countPowerPellets() == 0)
+    {
+        level++;
+        if (verbose)
+            std::cout << "Level cleared! Advancing to level " << level << " (score & lives kept)." << std::endl;
+        pelletGrid = PelletGrid(*grid); // repopulate all pellets from the map
+        resetActors();                  // ramp speed + timings for the new level
+    }
+}
+
+inline void GameSession::updateFruit()
+{
+    // Fruit spawn logic: the first fruit after 45 seconds, then 45 seconds
+    // after each one is eaten (FRUIT_DUE timers).
+    if (!fruitPresent && fruitDue)
+    {
+        fruitDue = false;
+        fruitPresent = true;
+        currentFruitIndex = (currentFruitIndex + 1) % (sizeof(FRUIT_CYCLE) / sizeof(FRUIT_CYCLE[0]));
+        if (verbose)
+            std::cout << (waitingForRespawn ? "Respawning" : "Spawning") << " fruit type index: " << currentFruitIndex
+                      << std::endl;
+        waitingForRespawn = false;
+        fruitPellet.setType(FRUIT_CYCLE[currentFruitIndex]);
+        fruitPellet.reset();
+        fruitCheck = true; // the muncher may already be standing there
+    }
+
+    // Check if fruit is eaten (only once the muncher has come to a new tile)
+    bool check = fruitCheck;
+    fruitCheck = false;
+    if (check && fruitPresent && muncher.getPosition() == fruitPellet.getPosition() && !fruitPellet.isCollected())
+    {
+        fruitPellet.collect();
+        fruitPresent = false;
+        waitingForRespawn = true;
+        timers.scheduleIn(sf::seconds(FRUIT_INTERVAL), FRUIT_DUE);
+
+        switch (fruitPellet.getType())
+        {
+        case PelletType::CHERRY:
+            points.addPoints(PointSystem::CHERRY_POINTS);
+            break;
+        case PelletType::STRAWBERRY:
+            points.addPoints(PointSystem::STRAWBERRY_POINTS);
+            break;
+        case PelletType::ORANGE:
+            points.addPoints(PointSystem::ORANGE_POINTS);
+            break;
+        case PelletType::APPLE:
+            points.addPoints(PointSystem::APPLE_POINTS);
+            break;
+        case PelletType::GRAPEFRUIT:
+            points.addPoints(PointSystem::GRAPEFRUIT_POINTS);
+            break;
+        case PelletType::PANCAKE:
+            points.addPoints(PointSystem::PANCAKE_POINTS);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// Resolve this update's tile crossings: a returning ghost that got home
+// revives, and a muncher on a new tile gets its pellet and fruit checks.
+// Updates where nobody crossed a tile do no tile work at all.
+inline void GameSession::handleTileEvents()
+{
+    for (const TileEvent &e : tileEvents.pending())
+    {
+        if (e.kind != TileEvent::ENTER)
+            continue;
+        if (e.actor == TileEvent::MUNCHER)
+            muncherEnteredTile();
+        else if (e.actor >= 0 && e.actor < static_cast<int>(ghosts.size()))
+            ghosts[e.actor].enterTile(*grid);
+    }
+    tileEvents.clear();
+}
+
+inline void GameSession::checkGhostContacts(float interval)
+{
+    // Ghost contact = overlap within half a cell of the smooth render
+    // positions at any moment since the last update, not just now: each
+    // actor's path over the interval is swept (SweptContact.h), so a fast
+    // pair that crosses between two frames still meets, at any frame rate
+    // or time scale. Contacts are handled in the order they happened. A
+    // tunnel warp is not a path; the muncher's position after it is checked
+    // as a point.
+    const float contactDist = GameConfig::CELL_SIZE * 0.5f;
+    const MotionSweep muncherSweep = muncher.getSweep(interval);
+    const sf::Vector2f muncherRender = muncher.getRenderPosition();
+    contacts.clear();
+    for (std::size_t i = 0; i < ghosts.size(); ++i)
+    {
+        float when = firstContact(muncherSweep, ghosts[i].getSweep(interval), contactDist);
+        if (when < 0.0f)
+        {
+            sf::Vector2f g = ghosts[i].getRenderPosition();
+            float dx = muncherRender.x - g.x;
+            float dy = muncherRender.y - g.y;
+            if ((dx * dx + dy * dy) < (contactDist * contactDist))
+                when = 1.0f;
+        }
+        if (when >= 0.0f)
+            contacts.push_back(std::make_pair(when, static_cast<int>(i)));
+    }
+    std::stable_sort(contacts.begin(), contacts.end(),
+                     [](const std::pair<float, int> &a, const std::pair<float, int> &b) { return a.first < b.first; });
+
+    for (const auto &contact : contacts)
+    {
+        Ghost &ghost = ghosts[contact.second];
+        if (ghost.getState() == GhostState::FRIGHTENED && !ghost.getIsEaten())
+        {
+            // Escalating chain within one power pellet: 200 -> 400 -> 800 -> 1600.
+            static const int frightPoints[4] = {
+                PointSystem::First_Frightened_Ghost_Points,
+                PointSystem::Second_Frightened_Ghost_Points,
+                PointSystem::Third_Frightened_Ghost_Points,
+                PointSystem::Fourth_Frightened_Ghost_Points};
+            int idx = frightenedGhostsEaten < 4 ? frightenedGhostsEaten : 3;
+            points.addPoints(frightPoints[idx]);
+            frightenedGhostsEaten++;
+            ghost.setEaten();
+        }
+        else if (ghost.getState() == GhostState::NORMAL && !muncherDying && !invincible)
+        {
+            // Caught by a live ghost: lose a life and start the death animation
+            // (the reset happens in update() when it finishes).
+            if (verbose)
+                std::cout << "Muncher caught! Losing a life." << std::endl;
+            points.loseLife();
+            muncher.setState(MuncherState::DYING);
+            muncherDying = true;
+            deathTimer = timers.scheduleIn(sf::seconds(DEATH_ANIM_TIME), DEATH_OVER);
+        }
+    }
+}
+
+inline void GameSession::eatPellets()
+{
+    pelletCheck = false;
+    sf::Vector2i muncherPos = muncher.getPosition();
+    int gridX = muncherPos.x;
+    int gridY = muncherPos.y;
+
+    if (pelletGrid.hasPowerPellet(gridX, gridY))
+    {
+        if (verbose)
+            std::cout << "Power pellet eaten! Ghosts are now frightened!" << std::endl;
+        pelletGrid.setPowerPellet(gridX, gridY, false);
+        ghostAI.setFrightened();
+        frightenedGhostsEaten = 0; // start a fresh 200/400/800/1600 chain
+        points.addPoints(PointSystem::POINTS_PER_POWER_PELLET);
+
+        // Set all ghosts to frightened state
+        for (auto &ghost : ghosts)
+        {
+            ghost.setState(GhostState::FRIGHTENED);
+        }
+    }
+    else if (pelletGrid.hasPellet(gridX, gridY))
+    {
+        pelletGrid.setPellet(gridX, gridY, false);
+        points.addPoints(PointSystem::POINTS_PER_PELLET);
+    }
+}
+
+inline void GameSession::onMapChanged(bool resized, const std::vector<sf::Vector2i> &changed)
+{
+    ++mapVersion; // walls may have moved: nothing hashed before is the same state
+    if (resized)
+    {
+        pelletGrid = PelletGrid(*grid);
+        resetAI(); // scatter corners follow the board size
+    }
+    else
+    {
+        for (const sf::Vector2i &c : changed)
+            pelletGrid.refreshCell(*grid, c.x, c.y);
+    }
+
+    // Ghost homes follow the green tiles (same order as at startup), and
+    // scatter targets follow the walls; the fruit follows the start tile.
+    placeGhosts();
+    placeFruit();
+
+    muncherEnteredTile(); // its tile may have new pellets
+    sf::Vector2i m = muncher.getPosition();
+    if (grid->isWall(m.x, m.y))
+        muncher.reset(grid->getPlayerStartX(), grid->getPlayerStartY());
+    for (auto &ghost : ghosts)
+    {
+        sf::Vector2i g = ghost.getPosition();
+        bool walkable = grid->isValidPosition(g.x, g.y) &&
+                        (!grid->isWall(g.x, g.y) || grid->isGhostDoor(g.x, g.y) || grid->isGhostSpawn(g.x, g.y));
+        if (!walkable)
+            ghost.reset();
+    }
+}
+
+#endif // GAMESESSION_H
@@ -0,0 +1,152 @@
+#ifndef GHOSTPERSONALITIES_H
+#define GHOSTPERSONALITIES_H
+
+#include <cmath>
+#include <SFML/System.hpp>
+#include "Spookies.h"
+#include "Muncher.h"
+
+// What a steering decision needs to know, as plain values: filled from the
+// live Ghost/Muncher on the main thread, or from a snapshot on the AI worker
+// (AsyncGhostAI), so the same decision code serves both.
+struct GhostView
+{
+    sf::Vector2i tile;
+    GhostDirection heading;
+    GhostType type;
+    bool doorOpen;       // may pass the ghost door (NORMAL / RETURNING, as in Ghost::canMove)
+    int personality;     // GhostPersonalities id
+    sf::Vector2i scatter; // its scatter target; x < 0 = not assigned (GhostAI falls back to a board corner)
+};
+
+struct MuncherView
+{
+    sf::Vector2i tile;
+    MuncherDirection heading;
+};
+
+// Everything a chase policy may look at.
+struct TargetContext
+{
+    const GhostView &ghost;
+    const MuncherView &muncher;
+    const sf::Vector2i *chaserTile; // the CHASER-personality ghost's tile, if there is one
+    sf::Vector2i scatter;           // the ghost's resolved scatter target
+};
+
+// Euclidean tile distance (what the greedy step and the policies compare).
+inline float tileDistance(sf::Vector2i a, sf::Vector2i b)
+{
+    float dx = static_cast<float>(a.x - b.x);
+    float dy = static_cast<float>(a.y - b.y);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+inline sf::Vector2i headingOffset(MuncherDirection heading, int distance)
+{
+    switch (heading)
+    {
+    case MuncherDirection::UP:
+        return sf::Vector2i(0, -distance);
+    case MuncherDirection::DOWN:
+        return sf::Vector2i(0, distance);
+    case MuncherDirection::LEFT:
+        return sf::Vector2i(-distance, 0);
+    case MuncherDirection::RIGHT:
+        return sf::Vector2i(distance, 0);
+    }
+    return sf::Vector2i(0, 0);
+}
+
+// Ghost personalities as policy types. Each one only says where to aim while
+// chasing (scatter always heads for the ghost's scatter target); GhostAI runs
+// the rest of the pipeline (greedy step, lookahead, trace) around it, so the
+// policy call is inlined into that loop. New kinds are registered with
+// GhostPersonalities::add<Policy>() (Spookie_Chase.h); ids 0-3 are the classic
+// four below, in GhostType order.
+//
+// A policy is a type with:
+//   static constexpr const char *NAME;
+//   static sf::Vector2i chaseTarget(const TargetContext &c);
+
+// JACK (Red) - Targets Muncher's current position directly
+struct ChaserPolicy
+{
+    static constexpr const char *NAME = "chaser";
+    static sf::Vector2i chaseTarget(const TargetContext &c) { return c.muncher.tile; }
+};
+
+// MIKE (Blue) - Targets 4 tiles ahead of Muncher's direction
+struct AmbusherPolicy
+{
+    static constexpr const char *NAME = "ambusher";
+    static constexpr int AMBUSH_DISTANCE = 4; // Tiles ahead for ambusher
+
+    static sf::Vector2i chaseTarget(const TargetContext &c)
+    {
+        // Original bug: offset both up and left when facing up
+        if (c.muncher.heading == MuncherDirection::UP)
+            return c.muncher.tile + sf::Vector2i(-AMBUSH_DISTANCE / 2, -AMBUSH_DISTANCE / 2);
+        return c.muncher.tile + headingOffset(c.muncher.heading, AMBUSH_DISTANCE);
+    }
+};
+
+// SAM (Purple) - Double the vector from the chaser to 2 tiles ahead of Muncher
+struct FicklePolicy
+{
+    static constexpr const char *NAME = "fickle";
+
+    static sf::Vector2i chaseTarget(const TargetContext &c)
+    {
+        if (!c.chaserTile)
+            return c.muncher.tile; // Fallback
+        sf::Vector2i midPoint = c.muncher.tile + headingOffset(c.muncher.heading, 2);
+        sf::Vector2i vector = midPoint - *c.chaserTile; // Vector from chaser to midpoint
+        return midPoint + vector;
+    }
+};
+
+// WILL (Yellow) - Chases from afar, retreats to its scatter target up close
+struct BashfulPolicy
+{
+    static constexpr const char *NAME = "bashful";
+    static constexpr float RETREAT_DISTANCE = 8.0f; // Distance threshold for bashful retreat
+
+    static sf::Vector2i chaseTarget(const TargetContext &c)
+    {
+        if (tileDistance(c.ghost.tile, c.muncher.tile) < RETREAT_DISTANCE)
+            return c.scatter; // Too close - retreat
+        return c.muncher.tile; // Far enough - chase normally
+    }
+};
+
+// Leads the muncher by half the gap between them (at most 8 tiles), so it
+// closes in from in front on long corridors and hunts directly up close.
+struct InterceptorPolicy
+{
+    static constexpr const char *NAME = "interceptor";
+    static constexpr int MAX_LEAD = 8;
+
+    static sf::Vector2i chaseTarget(const TargetContext &c)
+    {
+        int lead = static_cast<int>(tileDistance(c.ghost.tile, c.muncher.tile) / 2.0f);
+        return c.muncher.tile + headingOffset(c.muncher.heading, lead < MAX_LEAD ? lead : MAX_LEAD);
+    }
+};
+
+// Holds its scatter area and only charges a muncher who comes near it, so a
+// swarm of guards spreads over a big map instead of forming one pack.
+struct GuardPolicy
+{
+    static constexpr const char *NAME = "guard";
+    static constexpr float GUARD_RADIUS = 10.0f;
+
+    static sf::Vector2i chaseTarget(const TargetContext &c)
+    {
+        if (tileDistance(c.scatter, c.muncher.tile) < GUARD_RADIUS)
+            return c.muncher.tile;
+        return c.scatter;
+    }
+};
+
+#endif // GHOSTPERSONALITIES_H
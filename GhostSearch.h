@@ -0,0 +1,269 @@
+#ifndef GHOSTSEARCH_H
+#define GHOSTSEARCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <SFML/System.hpp>
+#include "Grid.h"
+#include "Spookies.h"
+#include "Muncher.h"
+
+// Optional lookahead brain for ghosts. GhostAI::getBestDirection looks one
+// tile ahead; this looks `maxDepth` tiles ahead over forked copies of a tiny
+// game state (ghost tile + heading, muncher tile + heading) and picks the
+// first move of the best line.
+//
+// - Leaf score is the same Euclidean distance to the target tile the greedy
+//   rule uses, so a depth-1 search *is* the greedy choice.
+// - While hunting (CHASE) the muncher is played forward in a straight line; a
+//   line that lands on it (or swaps tiles with it) beats any distance, sooner
+//   captures beating later ones.
+// - Ghosts never reverse unless the tile is a dead end, as in the greedy rule,
+//   so corridors don't branch and the tree only fans out at junctions.
+// - The muncher forecast depends only on the ply, so (tile, heading, ply)
+//   fully determines a subtree: results are memoised per depth iteration,
+//   which keeps deep searches linear in the tiles within reach instead of
+//   exponential in the junctions.
+// - Iterative deepening against a wall-clock budget: depth 2, 3, ... until
+//   maxDepth or the budget runs out. An unfinished depth is thrown away, so
+//   the answer is always from a completed search, and if not even depth 2
+//   finishes the caller's greedy move stands.
+// - The memo is per-thread scratch (as PathHierarchy and BitFlood keep
+//   theirs), not part of the object: every GhostAI, and so every session,
+//   fork and RL environment, carries a GhostSearch, and copying those must
+//   stay cheap whether or not the search is ever switched on.
+class GhostSearch
+{
+public:
+    struct Result
+    {
+        GhostDirection direction;
+        int depthReached = 1; // 1 = greedy fallback
+        long nodes = 0;
+        bool timedOut = false;
+    };
+
+    // Depth in tiles; 0 or 1 switches the search off (greedy only).
+    void setMaxDepth(int depth)
+    {
+        maxDepth = std::max(0, std::min(depth, MAX_DEPTH));
+        memoSide = 2 * maxDepth + 1;
+    }
+    int getMaxDepth() const { return maxDepth; }
+
+    // Wall-clock allowance per decision, in microseconds.
+    void setBudgetMicros(long micros) { budget = std::chrono::microseconds(micros); }
+    long getBudgetMicros() const { return static_cast<long>(budget.count()); }
+
+    bool isEnabled() const { return maxDepth > 1 && budget.count() > 0; }
+
+    Result choose(const Grid &grid, sf::Vector2i ghostPos, GhostDirection ghostDir, sf::Vector2i muncherPos,
+                  MuncherDirection muncherDir, sf::Vector2i target, bool hunting, GhostDirection greedy);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr float CAPTURE = -1.0e6f; // beats any distance
+    static constexpr int CLOCK_CHECK_INTERVAL = 64; // nodes between deadline checks
+    static constexpr int MAX_DEPTH = 63;
+
+    int maxDepth = 0;
+    std::chrono::microseconds budget{0};
+
+    // Per-call search context (kept here so the recursion passes less around).
+    const Grid *grid = nullptr;
+    sf::Vector2i target;
+    bool hunting = false;
+    Clock::time_point deadline;
+    long nodes = 0;
+    bool aborted = false;
+    sf::Vector2i muncherPath[MAX_DEPTH + 1]; // predicted muncher tile per ply
+    int muncherPathLength = 0;
+
+    // Memo of subtree scores for the current depth iteration, indexed by ply,
+    // heading and tile relative to the root (everything reachable lies within
+    // maxDepth tiles). A stamp per iteration stands in for clearing it; the
+    // stamp runs on across searches, so one thread's searches of any depth
+    // can share the same (grown-to-fit) buffers.
+    struct Memo
+    {
+        std::vector<float> score;
+        std::vector<std::uint32_t> stamp;
+        std::uint32_t current = 0;
+    };
+    static Memo &memo(); // this thread's scratch
+    sf::Vector2i root;
+    int memoSide = 0;
+    Memo *memoCall = nullptr; // memo() for the running choose()
+
+    static sf::Vector2i step(sf::Vector2i p, int dir)
+    {
+        static const int dx[4] = {0, 0, -1, 1}; // UP, DOWN, LEFT, RIGHT
+        static const int dy[4] = {-1, 1, 0, 0};
+        return sf::Vector2i(p.x + dx[dir], p.y + dy[dir]);
+    }
+    static int opposite(int dir) { return dir ^ 1; } // UP<->DOWN, LEFT<->RIGHT
+
+    // Same rule as Ghost::canMove for a ghost in NORMAL state.
+    bool passable(sf::Vector2i p) const
+    {
+        if (!grid->isValidPosition(p.x, p.y))
+            return false;
+        return !grid->isWall(p.x, p.y) || grid->isGhostDoor(p.x, p.y);
+    }
+
+    static float distance(sf::Vector2i a, sf::Vector2i b)
+    {
+        float dx = static_cast<float>(a.x - b.x);
+        float dy = static_cast<float>(a.y - b.y);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    void predictMuncher(sf::Vector2i start, MuncherDirection dir, int plies);
+    float search(sf::Vector2i pos, int dir, int ply, int depth);
+};
+
+// Straight-line muncher forecast: keep heading while the next tile is open,
+// otherwise stand still. Crude, but cheap and never optimistic about escapes.
+inline void GhostSearch::predictMuncher(sf::Vector2i start, MuncherDirection dir, int plies)
+{
+    muncherPathLength = plies + 1;
+    muncherPath[0] = start;
+    for (int i = 1; i < muncherPathLength; ++i)
+    {
+        sf::Vector2i next = step(muncherPath[i - 1], static_cast<int>(dir));
+        bool open = grid->isValidPosition(next.x, next.y) && !grid->isWall(next.x, next.y);
+        muncherPath[i] = open ? next : muncherPath[i - 1];
+    }
+}
+
+// Best (lowest) score reachable from a ghost on `pos` having arrived heading
+// `dir`, `ply` moves into a `depth`-move line.
+inline float GhostSearch::search(sf::Vector2i pos, int dir, int ply, int depth)
+{
+    if (++nodes % CLOCK_CHECK_INTERVAL == 0 && Clock::now() >= deadline)
+        aborted = true;
+    if (aborted)
+        return 0.0f;
+
+    if (hunting)
+    {
+        int m = std::min(ply, muncherPathLength - 1);
+        int prev = std::min(ply - 1, muncherPathLength - 1);
+        if (pos == muncherPath[m] || (ply > 0 && pos == muncherPath[prev] && muncherPath[m] == step(pos, opposite(dir))))
+            return CAPTURE + static_cast<float>(ply);
+    }
+    if (ply == depth)
+        return distance(pos, target);
+
+    std::size_t key = ((static_cast<std::size_t>(ply) * 4 + dir) * memoSide + (pos.y - root.y + maxDepth)) * memoSide +
+                      (pos.x - root.x + maxDepth);
+    Memo &m = *memoCall;
+    if (m.stamp[key] == m.current)
+        return m.score[key];
+
+    float best = std::numeric_limits<float>::max();
+    bool moved = false;
+    for (int d = 0; d < 4; ++d)
+    {
+        if (d == opposite(dir))
+            continue;
+        sf::Vector2i next = step(pos, d);
+        if (!passable(next))
+            continue;
+        moved = true;
+        best = std::min(best, search(next, d, ply + 1, depth));
+    }
+    if (!moved)
+    {
+        // Dead end: turning round is the only move.
+        sf::Vector2i back = step(pos, opposite(dir));
+        if (passable(back))
+            best = search(back, opposite(dir), ply + 1, depth);
+        else
+            best = distance(pos, target); // boxed in
+    }
+    m.stamp[key] = m.current;
+    m.score[key] = best;
+    return best;
+}
+
+inline GhostSearch::Memo &GhostSearch::memo()
+{
+    static thread_local Memo m;
+    return m;
+}
+
+inline GhostSearch::Result GhostSearch::choose(const Grid &g, sf::Vector2i ghostPos, GhostDirection ghostDir,
+                                               sf::Vector2i muncherPos, MuncherDirection muncherDir, sf::Vector2i targetTile,
+                                               bool hunt, GhostDirection greedy)
+{
+    Result result;
+    result.direction = greedy;
+
+    grid = &g;
+    root = ghostPos;
+    target = targetTile;
+    hunting = hunt;
+    nodes = 0;
+    aborted = false;
+    deadline = Clock::now() + budget;
+    predictMuncher(muncherPos, muncherDir, maxDepth);
+
+    // Root moves, in the greedy rule's order and with its no-reversing rule.
+    const int heading = static_cast<int>(ghostDir);
+    int rootMoves[4];
+    int rootCount = 0;
+    for (int d = 0; d < 4; ++d)
+        if (d != opposite(heading) && passable(step(ghostPos, d)))
+            rootMoves[rootCount++] = d;
+    if (rootCount == 0 && passable(step(ghostPos, opposite(heading))))
+        rootMoves[rootCount++] = opposite(heading);
+    if (rootCount <= 1)
+        return result; // not a junction: nothing to decide
+
+    Memo &m = memo();
+    std::size_t memoSize = static_cast<std::size_t>(maxDepth + 1) * 4 * memoSide * memoSide;
+    if (m.score.size() < memoSize)
+    {
+        m.score.resize(memoSize, 0.0f);
+        m.stamp.resize(memoSize, 0); // never a live stamp (they start at 1)
+    }
+    memoCall = &m;
+
+    for (int depth = 2; depth <= maxDepth; ++depth)
+    {
+        if (++m.current == 0) // wrapped: old stamps could alias, so start clean
+        {
+            std::fill(m.stamp.begin(), m.stamp.end(), 0);
+            m.current = 1;
+        }
+        int bestMove = rootMoves[0];
+        float bestScore = std::numeric_limits<float>::max();
+        for (int i = 0; i < rootCount; ++i)
+        {
+            float score = search(step(ghostPos, rootMoves[i]), rootMoves[i], 1, depth);
+            if (score < bestScore)
+            {
+                bestScore = score;
+                bestMove = rootMoves[i];
+            }
+        }
+        if (aborted)
+        {
+            result.timedOut = true;
+            break; // keep the last completed depth
+        }
+        result.direction = static_cast<GhostDirection>(bestMove);
+        result.depthReached = depth;
+        if (bestScore <= CAPTURE + depth)
+            break; // a capture line never gets better with more depth
+    }
+    result.nodes = nodes;
+    return result;
+}
+
+#endif // GHOSTSEARCH_H
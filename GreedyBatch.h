@@ -0,0 +1,193 @@
+#ifndef GREEDYBATCH_H
+#define GREEDYBATCH_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <cmath>
+#include <SFML/System.hpp>
+#include "Grid.h"
+#include "GhostPersonalities.h"
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// The greedy scatter/chase step (GhostAI::greedyFrom) for many ghosts at once,
+// possibly from many games (GameBatch): one query per ghost, held as parallel
+// arrays so the distance scoring runs several queries per vector instruction
+// (8 with AVX2, 4 with SSE2, one at a time otherwise).
+//
+// Results are identical to greedyFrom: the same legal-direction rule (read
+// from the grid per query, when it is added), the same float distance and
+// square root, the same UP/DOWN/LEFT/RIGHT order with the first strict
+// minimum winning.
+class GreedyBatch
+{
+public:
+    void clear()
+    {
+        tileX.clear();
+        tileY.clear();
+        targetX.clear();
+        targetY.clear();
+        dirs.clear();
+        chosen.clear();
+        lanes.clear();
+        ghosts.clear();
+        spans.assign(spans.size(), Span{0, 0});
+    }
+
+    // Queue `ghost` of game `lane` (ghost = its index there); returns the query
+    // index. A lane's queries are added together (GameBatch does one game at a time).
+    int add(int lane, int ghostIndex, const Grid &grid, const GhostView &ghost, sf::Vector2i target);
+    // Score every query; direction(i) is valid until the next clear().
+    void solve();
+
+    int size() const { return static_cast<int>(lanes.size()); }
+    int lane(int i) const { return lanes[i]; }
+    int ghost(int i) const { return ghosts[i]; }
+    GhostDirection direction(int i) const { return static_cast<GhostDirection>(chosen[i]); }
+    // Queries of one lane: [first, last).
+    int first(int lane) const { return lane < static_cast<int>(spans.size()) ? spans[lane].first : 0; }
+    int last(int lane) const { return lane < static_cast<int>(spans.size()) ? spans[lane].last : 0; }
+
+private:
+    // Lane-interleaved query arrays (one entry per queued ghost).
+    std::vector<std::int32_t> tileX, tileY, targetX, targetY;
+    std::vector<std::uint8_t> dirs;   // bit per GhostDirection to score (preferred, else every legal one)
+    std::vector<std::uint8_t> chosen; // in: heading (kept when nothing is legal); out: the choice
+    std::vector<int> lanes, ghosts;
+    struct Span
+    {
+        int first, last;
+    };
+    std::vector<Span> spans; // by lane
+
+    void solveScalar(int begin, int end);
+};
+
+inline int GreedyBatch::add(int lane, int ghostIndex, const Grid &grid, const GhostView &ghost, sf::Vector2i target)
+{
+    // Legal directions by Ghost::canMove's rule; no reversing unless it is the only way.
+    static const sf::Vector2i offsets[4] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+    static const int opposite[4] = {1, 0, 3, 2};
+    std::uint8_t valid = 0;
+    for (int d = 0; d < 4; ++d)
+    {
+        sf::Vector2i p = ghost.tile + offsets[d];
+        if (grid.isValidPosition(p.x, p.y) && (!grid.isWall(p.x, p.y) || (grid.isGhostDoor(p.x, p.y) && ghost.doorOpen)))
+            valid |= static_cast<std::uint8_t>(1u << d);
+    }
+    std::uint8_t preferred = valid & static_cast<std::uint8_t>(~(1u << opposite[static_cast<int>(ghost.heading)]));
+
+    tileX.push_back(ghost.tile.x);
+    tileY.push_back(ghost.tile.y);
+    targetX.push_back(target.x);
+    targetY.push_back(target.y);
+    dirs.push_back(preferred ? preferred : valid);
+    chosen.push_back(static_cast<std::uint8_t>(ghost.heading));
+    lanes.push_back(lane);
+    ghosts.push_back(ghostIndex);
+
+    if (lane >= static_cast<int>(spans.size()))
+        spans.resize(lane + 1, Span{0, 0});
+    if (spans[lane].last != size() - 1)
+        spans[lane].first = size() - 1;
+    spans[lane].last = size();
+    return size() - 1;
+}
+
+// Reference path (and the tail the vector loops leave): greedyFrom's loop.
+inline void GreedyBatch::solveScalar(int begin, int end)
+{
+    static const int offsetX[4] = {0, 0, -1, 1};
+    static const int offsetY[4] = {-1, 1, 0, 0};
+    for (int i = begin; i < end; ++i)
+    {
+        float best = std::numeric_limits<float>::max();
+        for (int d = 0; d < 4; ++d)
+        {
+            if (!(dirs[i] >> d & 1))
+                continue;
+            float dx = static_cast<float>(tileX[i] + offsetX[d] - targetX[i]);
+            float dy = static_cast<float>(tileY[i] + offsetY[d] - targetY[i]);
+            float distance = std::sqrt(dx * dx + dy * dy);
+            if (distance < best)
+            {
+                best = distance;
+                chosen[i] = static_cast<std::uint8_t>(d);
+            }
+        }
+    }
+}
+
+inline void GreedyBatch::solve()
+{
+    const int n = size();
+    int i = 0;
+#if defined(__AVX2__)
+    // 8 queries per step: per direction, distance for all 8, then a masked
+    // "strictly closer" select (directions in order, so the first minimum stays).
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i tx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&tileX[i]));
+        __m256i ty = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&tileY[i]));
+        __m256i gx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&targetX[i]));
+        __m256i gy = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&targetY[i]));
+        __m256i mask = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&dirs[i])));
+        __m256i pick = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&chosen[i])));
+        __m256 best = _mm256_set1_ps(std::numeric_limits<float>::max());
+        const int offsetX[4] = {0, 0, -1, 1};
+        const int offsetY[4] = {-1, 1, 0, 0};
+        for (int d = 0; d < 4; ++d)
+        {
+            __m256 dx = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_add_epi32(tx, _mm256_set1_epi32(offsetX[d])), gx));
+            __m256 dy = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_add_epi32(ty, _mm256_set1_epi32(offsetY[d])), gy));
+            __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+            __m256i bit = _mm256_set1_epi32(1 << d);
+            __m256i allowed = _mm256_cmpeq_epi32(_mm256_and_si256(mask, bit), bit);
+            __m256i closer = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(distance, best, _CMP_LT_OQ)), allowed);
+            best = _mm256_blendv_ps(best, distance, _mm256_castsi256_ps(closer));
+            pick = _mm256_blendv_epi8(pick, _mm256_set1_epi32(d), closer);
+        }
+        alignas(32) std::int32_t out[8];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(out), pick);
+        for (int k = 0; k < 8; ++k)
+            chosen[i + k] = static_cast<std::uint8_t>(out[k]);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    // 4 queries per step (SSE2 has no blend: select with and/andnot/or).
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i tx = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&tileX[i]));
+        __m128i ty = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&tileY[i]));
+        __m128i gx = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&targetX[i]));
+        __m128i gy = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&targetY[i]));
+        __m128i mask = _mm_setr_epi32(dirs[i], dirs[i + 1], dirs[i + 2], dirs[i + 3]);
+        __m128i pick = _mm_setr_epi32(chosen[i], chosen[i + 1], chosen[i + 2], chosen[i + 3]);
+        __m128 best = _mm_set1_ps(std::numeric_limits<float>::max());
+        const int offsetX[4] = {0, 0, -1, 1};
+        const int offsetY[4] = {-1, 1, 0, 0};
+        for (int d = 0; d < 4; ++d)
+        {
+            __m128 dx = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_add_epi32(tx, _mm_set1_epi32(offsetX[d])), gx));
+            __m128 dy = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_add_epi32(ty, _mm_set1_epi32(offsetY[d])), gy));
+            __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+            __m128i bit = _mm_set1_epi32(1 << d);
+            __m128i allowed = _mm_cmpeq_epi32(_mm_and_si128(mask, bit), bit);
+            __m128i closer = _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(distance, best)), allowed);
+            __m128 closerPs = _mm_castsi128_ps(closer);
+            best = _mm_or_ps(_mm_and_ps(closerPs, distance), _mm_andnot_ps(closerPs, best));
+            pick = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(d)), _mm_andnot_si128(closer, pick));
+        }
+        alignas(16) std::int32_t out[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(out), pick);
+        for (int k = 0; k < 4; ++k)
+            chosen[i + k] = static_cast<std::uint8_t>(out[k]);
+    }
+#endif
+    solveScalar(i, n);
+}
+
+#endif // GREEDYBATCH_H
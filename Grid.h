@@ -1,70 +1,21 @@
 #ifndef GRID_H
 #define GRID_H
 
+#include <atomic>
 #include <map>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <memory>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
 #include <iostream>
 #include <SFML/Graphics.hpp>
 #include "GameConfig.h"
-
-// Enum for image tile types
-enum class ImageTileType
-{
-    WALL,         // Blue
-    PELLET,       // Orange
-    POWER_PELLET, // Red
-    EMPTY,        // Brown (walkable floor), or anything far from the legend
-    PLAYER_START, // Cyan
-    GHOST_SPAWN,  // Green
-    GHOST_DOOR,   // Magenta (ghost-only gate)
-    SCOREBOARD,   // Grey
-    TELEPORT      // Pink (side-to-side tunnel)
-};
-
-// The one canonical colour legend for authoring maps. Each map tile is drawn
-// in one of these colours; add a row here to add a tile type.
-struct MazeLegendEntry
-{
-    int r, g, b;
-    ImageTileType type;
-};
-
-static const MazeLegendEntry MAZE_LEGEND[] = {
-    {0, 14, 214, ImageTileType::WALL},          // blue
-    {255, 126, 0, ImageTileType::PELLET},       // orange
-    {70, 70, 70, ImageTileType::SCOREBOARD},    // grey
-    {156, 90, 60, ImageTileType::EMPTY},        // brown = walkable floor
-    {168, 230, 29, ImageTileType::GHOST_SPAWN}, // yellow-green
-    {237, 28, 36, ImageTileType::POWER_PELLET}, // red
-    {0, 183, 239, ImageTileType::PLAYER_START}, // cyan
-    {255, 0, 255, ImageTileType::GHOST_DOOR},   // magenta
-    {255, 163, 177, ImageTileType::TELEPORT},   // pink = side-to-side tunnel
-};
-
-// Classify a pixel to the NEAREST legend colour (squared RGB distance). This is
-// what makes maps robust: a colour only has to be *close* to a legend entry, not
-// an exact match. Anything farther than MAX_DIST from every entry is EMPTY floor.
-static inline ImageTileType getTileTypeFromColor(const sf::Color &color)
-{
-    const int MAX_DIST_SQ = 100 * 100; // ~how far a colour may stray and still match
-    int bestDistSq = MAX_DIST_SQ + 1;
-    ImageTileType best = ImageTileType::EMPTY;
-
-    for (const MazeLegendEntry &e : MAZE_LEGEND)
-    {
-        int dr = static_cast<int>(color.r) - e.r;
-        int dg = static_cast<int>(color.g) - e.g;
-        int db = static_cast<int>(color.b) - e.b;
-        int distSq = dr * dr + dg * dg + db * db;
-        if (distSq < bestDistSq)
-        {
-            bestDistSq = distSq;
-            best = e.type;
-        }
-    }
-    return best;
-}
+#include "MapFile.h"
+#include "TileClassifier.h"
+#include "Parallel.h"
 
 // Enhanced CellType enum using bit flags
 enum CellType
@@ -96,12 +47,69 @@ inline CellType operator~(CellType a)
     return static_cast<CellType>(~static_cast<int>(a));
 }
 
+// The Grid flags an authoring-image tile type becomes.
+inline int tileFlags(ImageTileType type)
+{
+    switch (type)
+    {
+    case ImageTileType::WALL:
+        return WALL;
+    case ImageTileType::PELLET:
+        return PELLET;
+    case ImageTileType::POWER_PELLET:
+        return POWER_PELLET;
+    case ImageTileType::PLAYER_START:
+        return PLAYER_START;
+    case ImageTileType::GHOST_SPAWN:
+        return GHOST_SPAWN;
+    case ImageTileType::GHOST_DOOR:
+        return GHOST_DOOR | WALL; // door blocks the player; ghosts pass via canMove()
+    case ImageTileType::SCOREBOARD:
+        return SCOREBOARD;
+    case ImageTileType::TELEPORT:
+        return TELEPORT; // also registers the tunnel end
+    case ImageTileType::EMPTY:
+    default:
+        return EMPTY; // walkable floor — no flag
+    }
+}
+
+class PelletLayout;  // PelletGrid.h
+class PathHierarchy; // PathHierarchy.h
+class PassMasks;     // BitFlood.h
+
 class Grid
 {
+public:
+    // Cells live in square chunks instead of one vector per row. A chunk is
+    // 32x32 one-byte cells (1 KiB), so neighbouring rows share cache lines and
+    // the renderer can cull and cache whole chunks at a time.
+    static constexpr int CHUNK_SHIFT = 5;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;         // tiles per chunk side
+    static constexpr int CHUNK_MASK = CHUNK_SIZE - 1;
+    static constexpr int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE; // cells per chunk
+
 private:
     int width;
     int height;
-    std::vector<std::vector<int>> cells; // Single grid using bit flags
+    int chunksX; // chunk columns (width rounded up to whole chunks)
+    int chunksY; // chunk rows
+
+    // Per chunk: >= 0 is the chunk's slot in chunkData; < 0 means the chunk is
+    // uniform and not stored at all, every cell holding ~slot (so solid wall
+    // and open floor regions of a huge board cost nothing).
+    std::vector<std::int32_t> chunkSlots;
+    std::vector<std::uint8_t> chunkData; // CHUNK_CELLS flag bytes per stored chunk
+
+    // Compiled-map view (loadCompiledMap). While mappedHeader is set the slot
+    // table and chunk bytes are read straight out of the mapped .pmm file and
+    // chunkSlots/chunkData are empty; the first write copies them out
+    // (detachMapping), so a loaded map is never written back to disk.
+    std::shared_ptr<const MappedFile> mappedFile;
+    const PmmHeader *mappedHeader = nullptr;
+    const std::int32_t *mappedSlots = nullptr;
+    const std::uint8_t *mappedData = nullptr;
+    const PmmSpecialTile *mappedSpecials = nullptr;
 
     // Spawn point tracking
     int playerStartX = -1;
@@ -112,9 +120,71 @@ private:
     // Tunnel/teleport tiles (side-to-side warp). Expected: exactly two.
     std::vector<sf::Vector2i> teleportTiles;
 
+    // Starting pellets, numbered for every PelletGrid on this map to share
+    // (PelletLayout::of builds it on first use; any cell write drops it).
+    mutable std::shared_ptr<const PelletLayout> pelletLayout;
+    friend class PelletLayout;
+    // Large boards' ghost path graph, the same way (PathHierarchy::of).
+    mutable std::shared_ptr<const PathHierarchy> pathHierarchy;
+    friend class PathHierarchy;
+    // Walkable-tile bitboards for BitFlood, the same way (PassMasks::of).
+    mutable std::shared_ptr<const PassMasks> passMasks;
+    friend class PassMasks;
+
+    // Content version: a fresh process-wide number on every write, so
+    // anything derived from the cells (ThreatMap fields, cached routes) can
+    // tell the board changed under it. Copies share it along with the cells.
+    std::uint64_t version = nextVersion();
+    static std::uint64_t nextVersion()
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+
+    // Edit journal: the cell each single-cell write since version
+    // journalBase went to, and the version it left, oldest first. Derived
+    // data built at one of those versions repairs just the cells written
+    // since (cellsChangedSince) instead of starting over. A bulk rewrite, or
+    // more than JOURNAL_LIMIT writes, starts a new journal.
+    static constexpr std::size_t JOURNAL_LIMIT = 4096;
+    struct JournalEntry
+    {
+        std::uint64_t version; // after the write
+        std::int32_t cell;     // y * width + x
+    };
+    std::vector<JournalEntry> journal;
+    std::uint64_t journalBase = version;
+
+    // A write: the pellet layout is rebuilt on next use; the path graph and
+    // pass masks stay cached and are repaired from the journal (-1 = bulk).
+    void touched(int cell = -1)
+    {
+        pelletLayout.reset();
+        version = nextVersion();
+        if (cell < 0 || journal.size() >= JOURNAL_LIMIT)
+        {
+            journal.clear();
+            journalBase = version;
+            return;
+        }
+        journal.push_back(JournalEntry{version, cell});
+    }
+
+    int chunkIndex(int x, int y) const { return (y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT); }
+    static int cellOffset(int x, int y) { return ((y & CHUNK_MASK) << CHUNK_SHIFT) | (x & CHUNK_MASK); }
+    int cellAt(int x, int y) const; // raw flags, position already validated
+    void storeCell(int x, int y, int flags); // stores a chunk on demand
+    void detachMapping();                    // copy a mapped map into owned storage
+    void assignCells(const std::uint8_t *cells); // bulk replace from a row-major flag array
+    std::int32_t slotOf(int chunk) const { return mappedHeader ? mappedSlots[chunk] : chunkSlots[chunk]; }
+    const std::uint8_t *chunkCells(std::int32_t slot) const
+    {
+        return (mappedHeader ? mappedData : chunkData.data()) + static_cast<std::size_t>(slot) * CHUNK_CELLS;
+    }
+
 public:
     // Constructor
-    Grid(int width = 28, int height = 31, bool autoInitialize = true);
+    Grid(int width = GameConfig::GRID_WIDTH, int height = GameConfig::GRID_HEIGHT, bool autoInitialize = true);
 
     // Bit flag utility methods
     bool hasFlag(int x, int y, CellType flag) const;
@@ -144,6 +214,55 @@ public:
     int getWidth() const;
     int getHeight() const;
 
+    // Chunk layout (for culling and cached rendering)
+    int getChunksX() const { return chunksX; }
+    int getChunksY() const { return chunksY; }
+    bool isChunkStored(int cx, int cy) const { return slotOf(cy * chunksX + cx) >= 0; }
+    std::size_t getStoredChunkCount() const
+    {
+        return mappedHeader ? mappedHeader->storedChunks : chunkData.size() / CHUNK_CELLS;
+    }
+    std::size_t getMemoryBytes() const
+    {
+        return static_cast<std::size_t>(chunksX) * chunksY * sizeof(std::int32_t) + getStoredChunkCount() * CHUNK_CELLS;
+    }
+
+    // Every tile carrying `flag`, in row-major order. Uniform chunks are tested
+    // once instead of per cell, and a still-mapped compiled map answers spawn /
+    // door / tunnel / power-pellet queries from its special-tile index.
+    std::vector<sf::Vector2i> findTiles(CellType flag) const;
+
+    // Cells whose flags differ from `other` (same size assumed), row-major.
+    // Chunks that are uniform and equal in both grids are skipped whole.
+    std::vector<sf::Vector2i> diffCells(const Grid &other) const;
+
+    // Bounding box of the SCOREBOARD tiles; false when the map has none.
+    bool getScoreboardBounds(int &minX, int &minY, int &maxX, int &maxY) const;
+
+    // True while cells are still served from a mapped .pmm file.
+    bool isMapped() const { return mappedHeader != nullptr; }
+    // Content hash of the compiled map this grid was loaded from (0 otherwise).
+    std::uint64_t getMapHash() const { return mappedHeader ? mappedHeader->contentHash : 0; }
+    // Changes whenever any cell is written (see `version`).
+    std::uint64_t getVersion() const { return version; }
+    // The cells written since this grid was at version `since` (each once,
+    // in row-major order). False if that isn't known: `since` is from before a bulk
+    // rewrite or too many edits ago, or from another board; rebuild then.
+    bool cellsChangedSince(std::uint64_t since, std::vector<sf::Vector2i> &cells) const;
+    // Live reload in place: give `cells` the flags they have in `from` (same
+    // size), and take its spawn and tunnel tracking. Unlike assigning the
+    // whole grid, this goes through the edit journal, so cached path data is
+    // repaired rather than rebuilt.
+    void applyCells(const Grid &from, const std::vector<sf::Vector2i> &cells);
+    // The whole board from a row-major w x h array of flags (one getFlags
+    // value per cell), spawns and tunnels found as an image load finds them.
+    // Replays (Replay.h) carry their board this way.
+    void loadCells(int w, int h, const std::uint8_t *cells)
+    {
+        resize(w, h);
+        assignCells(cells);
+    }
+
     // Spawn point methods
     bool isPlayerStart(int x, int y) const;
     bool isGhostSpawn(int x, int y) const;
@@ -163,15 +282,27 @@ public:
     // Maze initialization
     void initializeMaze();
     void clearMaze();
+    void resize(int newWidth, int newHeight); // clears the maze
+    void compact();                           // drop stored chunks that turned out uniform
 
-    // Method to load maze from image
-    bool loadMazeFromImage(const std::string &imagePath);
+    // Method to load maze from image. fitToImage sizes the grid to the image
+    // first (authoring maps are drawn one pixel per tile).
+    bool loadMazeFromImage(const std::string &imagePath, bool fitToImage = false);
+
+    // Write the maze back out as an authoring image, one pixel per tile in the
+    // MAZE_LEGEND colours (so loadMazeFromImage(path, true) round-trips it).
+    bool saveMazeToImage(const std::string &imagePath) const;
+
+    // Compiled maps (.pmm, see MapFile.h). loadCompiledMap memory-maps the file
+    // and reads cells straight from it; saveCompiledMap is what `mapc` uses.
+    bool loadCompiledMap(const std::string &mapPath);
+    bool saveCompiledMap(const std::string &mapPath) const;
 };
 
 // Inline implementations
-inline Grid::Grid(int w, int h, bool autoInitialize) : width(w), height(h)
+inline Grid::Grid(int w, int h, bool autoInitialize) : width(0), height(0), chunksX(0), chunksY(0)
 {
-    cells.resize(height, std::vector<int>(width, EMPTY));
+    resize(w, h);
 
     if (autoInitialize)
     {
@@ -179,19 +310,48 @@ inline Grid::Grid(int w, int h, bool autoInitialize) : width(w), height(h)
     }
 }
 
+inline int Grid::cellAt(int x, int y) const
+{
+    std::int32_t slot = slotOf(chunkIndex(x, y));
+    if (slot < 0)
+        return ~slot;
+    return chunkCells(slot)[cellOffset(x, y)];
+}
+
+inline void Grid::storeCell(int x, int y, int flags)
+{
+    if (cellAt(x, y) == flags)
+        return; // nothing changes: keep the version (and what was derived from it)
+    touched(y * width + x);
+    if (mappedHeader)
+        detachMapping();
+    std::int32_t &slot = chunkSlots[chunkIndex(x, y)];
+    if (slot < 0)
+    {
+        if (~slot == flags)
+            return; // uniform chunk already holds this value
+        // First differing write: give the chunk real storage, filled with its old value.
+        std::uint8_t fill = static_cast<std::uint8_t>(~slot);
+        slot = static_cast<std::int32_t>(chunkData.size() / CHUNK_CELLS);
+        chunkData.resize(chunkData.size() + CHUNK_CELLS, fill);
+    }
+    chunkData[static_cast<std::size_t>(slot) * CHUNK_CELLS + cellOffset(x, y)] = static_cast<std::uint8_t>(flags);
+}
+
 // Bit flag utility methods
 inline bool Grid::hasFlag(int x, int y, CellType flag) const
 {
     if (!isValidPosition(x, y))
         return false;
-    return (cells[y][x] & flag) != 0;
+    return (cellAt(x, y) & flag) != 0;
 }
 
 inline void Grid::addFlag(int x, int y, CellType flag)
 {
     if (isValidPosition(x, y))
     {
-        cells[y][x] |= flag;
+        bool wasSet = (cellAt(x, y) & flag) != 0;
+        storeCell(x, y, cellAt(x, y) | flag);
 
         // Update spawn point tracking
         if (flag == PLAYER_START)
@@ -204,6 +364,10 @@ inline void Grid::addFlag(int x, int y, CellType flag)
             ghostSpawnX = x;
             ghostSpawnY = y;
         }
+        else if (flag == TELEPORT && !wasSet)
+        {
+            teleportTiles.emplace_back(x, y);
+        }
     }
 }
 
@@ -211,7 +375,7 @@ inline void Grid::removeFlag(int x, int y, CellType flag)
 {
     if (isValidPosition(x, y))
     {
-        cells[y][x] &= ~flag;
+        storeCell(x, y, cellAt(x, y) & ~flag);
 
         // Clear spawn point tracking if removing spawn flags
         if (flag == PLAYER_START && playerStartX == x && playerStartY == y)
@@ -224,6 +388,11 @@ inline void Grid::removeFlag(int x, int y, CellType flag)
             ghostSpawnX = -1;
             ghostSpawnY = -1;
         }
+        else if (flag == TELEPORT)
+        {
+            teleportTiles.erase(std::remove(teleportTiles.begin(), teleportTiles.end(), sf::Vector2i(x, y)),
+                                teleportTiles.end());
+        }
     }
 }
 
@@ -231,7 +400,7 @@ inline void Grid::setFlags(int x, int y, int flags)
 {
     if (isValidPosition(x, y))
     {
-        cells[y][x] = flags;
+        storeCell(x, y, flags);
     }
 }
 
@@ -239,7 +408,7 @@ inline int Grid::getFlags(int x, int y) const
 {
     if (!isValidPosition(x, y))
         return WALL; // Treat out-of-bounds as walls
-    return cells[y][x];
+    return cellAt(x, y);
 }
 
 inline bool Grid::isWall(int x, int y) const
@@ -269,7 +438,7 @@ inline CellType Grid::getCellType(int x, int y) const
     if (!isValidPosition(x, y))
         return WALL;
 
-    int flags = cells[y][x];
+    int flags = cellAt(x, y);
 
     // Return the highest priority flag for backward compatibility
     if (flags & WALL)
@@ -293,7 +462,7 @@ inline void Grid::setCellType(int x, int y, CellType type)
     if (isValidPosition(x, y))
     {
         // Clear all flags first, then set the specific type
-        cells[y][x] = EMPTY;
+        storeCell(x, y, EMPTY);
         if (type != EMPTY)
         {
             addFlag(x, y, type);
@@ -441,7 +610,7 @@ inline void Grid::initializeMaze()
     std::cout << "Ghost spawn: (" << ghostSpawnX << ", " << ghostSpawnY << ")" << std::endl;
 }
 
-inline bool Grid::loadMazeFromImage(const std::string &filename)
+inline bool Grid::loadMazeFromImage(const std::string &filename, bool fitToImage)
 {
     sf::Image image;
     if (!image.loadFromFile(filename))
@@ -453,76 +622,183 @@ inline bool Grid::loadMazeFromImage(const std::string &filename)
     sf::Vector2u imageSize = image.getSize();
     std::cout << "Image loaded: " << imageSize.x << "x" << imageSize.y << " pixels" << std::endl;
 
+    if (fitToImage)
+        resize(static_cast<int>(imageSize.x), static_cast<int>(imageSize.y));
+
     // Scale the image to match our grid
     float scaleX = static_cast<float>(imageSize.x) / width;
     float scaleY = static_cast<float>(imageSize.y) / height;
 
-    // Sample the image to create our maze
-    for (int y = 0; y < height; y++)
-    {
-        for (int x = 0; x < width; x++)
+    // Sample the center of each cell, clamped to the image bounds. Columns are
+    // the same for every row, so they are worked out once.
+    std::vector<int> sampleX(static_cast<std::size_t>(width));
+    for (int x = 0; x < width; x++)
+        sampleX[x] = std::min(static_cast<int>((x + 0.5f) * scaleX), static_cast<int>(imageSize.x) - 1);
+    const bool oneToOne = static_cast<int>(imageSize.x) == width;
+
+    // Classify rows in parallel straight off the pixel buffer. One legend, one
+    // classification: nearest-colour matching means a map only has to be
+    // *close* to the legend colours, not exact (see TileClassifier.h).
+    const TileClassifier &classifier = TileClassifier::instance();
+    const sf::Uint8 *pixels = image.getPixelsPtr();
+    std::vector<std::uint8_t> cells(static_cast<std::size_t>(width) * height);
+    // Small maps are not worth waking threads for.
+    unsigned threads = cells.size() >= (1u << 16) ? defaultThreadCount() : 1;
+    parallelFor(0, height, threads, [&](int rowBegin, int rowEnd)
+                {
+        std::vector<sf::Uint8> gathered(oneToOne ? 0 : static_cast<std::size_t>(width) * 4);
+        std::vector<ImageTileType> types(static_cast<std::size_t>(width));
+        for (int y = rowBegin; y < rowEnd; y++)
         {
-            // Sample the center of each cell
-            int pixelX = static_cast<int>((x + 0.5f) * scaleX);
-            int pixelY = static_cast<int>((y + 0.5f) * scaleY);
-
-            // Clamp to image bounds
-            pixelX = std::min(pixelX, static_cast<int>(imageSize.x) - 1);
-            pixelY = std::min(pixelY, static_cast<int>(imageSize.y) - 1);
-
-            sf::Color pixelColor = image.getPixel(pixelX, pixelY);
+            int pixelY = std::min(static_cast<int>((y + 0.5f) * scaleY), static_cast<int>(imageSize.y) - 1);
+            const sf::Uint8 *row = pixels + static_cast<std::size_t>(pixelY) * imageSize.x * 4;
+            if (!oneToOne)
+            {
+                for (int x = 0; x < width; x++)
+                    std::copy(row + sampleX[x] * 4, row + sampleX[x] * 4 + 4, &gathered[static_cast<std::size_t>(x) * 4]);
+                row = gathered.data();
+            }
+            classifier.classifyRow(row, static_cast<std::size_t>(width), types.data());
+            std::uint8_t *out = &cells[static_cast<std::size_t>(y) * width];
+            for (int x = 0; x < width; x++)
+                out[x] = static_cast<std::uint8_t>(tileFlags(types[x]));
+        } });
+
+    assignCells(cells.data());
+    std::cout << "Maze loaded from image successfully! (" << getStoredChunkCount() << "/"
+              << chunkSlots.size() << " chunks stored)" << std::endl;
+    return true;
+}
 
-            // One legend, one classification. Nearest-colour matching means a
-            // map only has to be *close* to the legend colours, not exact.
-            switch (getTileTypeFromColor(pixelColor))
+// Replace the whole board with a row-major width x height array of flags,
+// building chunks directly (uniform ones are never stored) instead of going
+// through storeCell per cell.
+inline void Grid::assignCells(const std::uint8_t *cells)
+{
+    clearMaze();
+    for (int cy = 0; cy < chunksY; ++cy)
+    {
+        for (int cx = 0; cx < chunksX; ++cx)
+        {
+            int x0 = cx * CHUNK_SIZE;
+            int y0 = cy * CHUNK_SIZE;
+            int usedW = std::min(CHUNK_SIZE, width - x0);
+            int usedH = std::min(CHUNK_SIZE, height - y0);
+            const std::uint8_t *src = cells + static_cast<std::size_t>(y0) * width + x0;
+
+            std::uint8_t first = src[0];
+            bool uniform = true;
+            for (int y = 0; y < usedH && uniform; ++y)
+                for (int x = 0; x < usedW && uniform; ++x)
+                    uniform = (src[static_cast<std::size_t>(y) * width + x] == first);
+            if (uniform)
             {
-            case ImageTileType::WALL:
-                addFlag(x, y, WALL);
-                break;
-            case ImageTileType::PELLET:
-                addFlag(x, y, PELLET);
-                break;
-            case ImageTileType::POWER_PELLET:
-                addFlag(x, y, POWER_PELLET);
-                break;
-            case ImageTileType::PLAYER_START:
-                addFlag(x, y, PLAYER_START);
-                break;
-            case ImageTileType::GHOST_SPAWN:
-                addFlag(x, y, GHOST_SPAWN);
-                break;
-            case ImageTileType::GHOST_DOOR:
-                addFlag(x, y, GHOST_DOOR);
-                addFlag(x, y, WALL); // door blocks the player; ghosts pass via canMove()
-                break;
-            case ImageTileType::SCOREBOARD:
-                addFlag(x, y, SCOREBOARD);
-                break;
-            case ImageTileType::TELEPORT:
-                addFlag(x, y, TELEPORT);
-                teleportTiles.emplace_back(x, y);
-                break;
-            case ImageTileType::EMPTY:
-            default:
-                break; // walkable floor — no flag
+                chunkSlots[cy * chunksX + cx] = ~static_cast<std::int32_t>(first);
+                continue;
             }
+
+            chunkSlots[cy * chunksX + cx] = static_cast<std::int32_t>(chunkData.size() / CHUNK_CELLS);
+            std::size_t base = chunkData.size();
+            chunkData.resize(base + CHUNK_CELLS, EMPTY); // overhang of an edge chunk stays EMPTY
+            for (int y = 0; y < usedH; ++y)
+                std::copy(src + static_cast<std::size_t>(y) * width, src + static_cast<std::size_t>(y) * width + usedW,
+                          &chunkData[base + (static_cast<std::size_t>(y) << CHUNK_SHIFT)]);
         }
     }
 
-    std::cout << "Maze loaded from image successfully!" << std::endl;
-    return true;
+    // Spawn and tunnel tracking, with the same last-one-wins (row-major)
+    // result addFlag gives when cells are set one at a time.
+    std::vector<sf::Vector2i> starts = findTiles(PLAYER_START);
+    if (!starts.empty())
+    {
+        playerStartX = starts.back().x;
+        playerStartY = starts.back().y;
+    }
+    std::vector<sf::Vector2i> spawns = findTiles(GHOST_SPAWN);
+    if (!spawns.empty())
+    {
+        ghostSpawnX = spawns.back().x;
+        ghostSpawnY = spawns.back().y;
+    }
+    teleportTiles = findTiles(TELEPORT);
 }
 
-inline void Grid::clearMaze()
+inline bool Grid::saveMazeToImage(const std::string &filename) const
 {
-    for (int y = 0; y < GameConfig::GRID_HEIGHT; y++)
+    // Legend colour for a tile type (the first legend row of that type).
+    auto legendColor = [](ImageTileType type)
+    {
+        for (const MazeLegendEntry &e : MAZE_LEGEND)
+        {
+            if (e.type == type)
+                return sf::Color(static_cast<sf::Uint8>(e.r), static_cast<sf::Uint8>(e.g), static_cast<sf::Uint8>(e.b));
+        }
+        return sf::Color::Black;
+    };
+
+    sf::Image image;
+    image.create(static_cast<unsigned>(width), static_cast<unsigned>(height));
+    for (int y = 0; y < height; y++)
     {
-        for (int x = 0; x < GameConfig::GRID_WIDTH; x++)
+        for (int x = 0; x < width; x++)
         {
-            cells[y][x] = EMPTY;
+            int flags = cellAt(x, y);
+            ImageTileType type = ImageTileType::EMPTY;
+            if (flags & GHOST_DOOR)
+                type = ImageTileType::GHOST_DOOR; // checked before WALL: doors carry both
+            else if (flags & WALL)
+                type = ImageTileType::WALL;
+            else if (flags & POWER_PELLET)
+                type = ImageTileType::POWER_PELLET;
+            else if (flags & PELLET)
+                type = ImageTileType::PELLET;
+            else if (flags & PLAYER_START)
+                type = ImageTileType::PLAYER_START;
+            else if (flags & GHOST_SPAWN)
+                type = ImageTileType::GHOST_SPAWN;
+            else if (flags & TELEPORT)
+                type = ImageTileType::TELEPORT;
+            else if (flags & SCOREBOARD)
+                type = ImageTileType::SCOREBOARD;
+            image.setPixel(static_cast<unsigned>(x), static_cast<unsigned>(y), legendColor(type));
         }
     }
 
+    if (!image.saveToFile(filename))
+    {
+        std::cout << "Failed to save image: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+inline void Grid::detachMapping()
+{
+    const std::size_t chunks = static_cast<std::size_t>(chunksX) * chunksY;
+    chunkSlots.assign(mappedSlots, mappedSlots + chunks);
+    chunkData.assign(mappedData, mappedData + static_cast<std::size_t>(mappedHeader->storedChunks) * CHUNK_CELLS);
+    mappedHeader = nullptr;
+    mappedSlots = nullptr;
+    mappedData = nullptr;
+    mappedSpecials = nullptr;
+    mappedFile.reset();
+}
+
+inline void Grid::clearMaze()
+{
+    // Drop any compiled-map view (and what was derived from the cells); the
+    // board is about to be rewritten.
+    touched();
+    mappedHeader = nullptr;
+    mappedSlots = nullptr;
+    mappedData = nullptr;
+    mappedSpecials = nullptr;
+    mappedFile.reset();
+
+    // Every chunk back to uniform EMPTY; no per-cell work, whatever the size.
+    chunkSlots.assign(static_cast<std::size_t>(chunksX) * chunksY, ~static_cast<std::int32_t>(EMPTY));
+    chunkData.clear();
+
     // Reset spawn positions
     playerStartX = -1;
     playerStartY = -1;
@@ -531,4 +807,329 @@ inline void Grid::clearMaze()
     teleportTiles.clear();
 }
 
+inline void Grid::resize(int newWidth, int newHeight)
+{
+    width = newWidth > 0 ? newWidth : 0;
+    height = newHeight > 0 ? newHeight : 0;
+    chunksX = (width + CHUNK_MASK) >> CHUNK_SHIFT;
+    chunksY = (height + CHUNK_MASK) >> CHUNK_SHIFT;
+    clearMaze();
+}
+
+// Collapse stored chunks whose cells all ended up equal back to uniform ones,
+// then repack the survivors. Run once after bulk loading.
+inline void Grid::compact()
+{
+    if (mappedHeader)
+        return; // compiled maps are written compacted
+
+    std::vector<std::uint8_t> packed;
+    packed.reserve(chunkData.size());
+    for (int cy = 0; cy < chunksY; ++cy)
+    {
+        for (int cx = 0; cx < chunksX; ++cx)
+        {
+            std::int32_t &slot = chunkSlots[cy * chunksX + cx];
+            if (slot < 0)
+                continue;
+            const std::uint8_t *cells = &chunkData[static_cast<std::size_t>(slot) * CHUNK_CELLS];
+
+            // Only cells inside the board count; an edge chunk's overhang is padding.
+            int usedW = std::min(CHUNK_SIZE, width - cx * CHUNK_SIZE);
+            int usedH = std::min(CHUNK_SIZE, height - cy * CHUNK_SIZE);
+            bool uniform = true;
+            for (int y = 0; y < usedH && uniform; ++y)
+                for (int x = 0; x < usedW && uniform; ++x)
+                    uniform = (cells[cellOffset(x, y)] == cells[0]);
+
+            if (uniform)
+            {
+                slot = ~static_cast<std::int32_t>(cells[0]);
+            }
+            else
+            {
+                slot = static_cast<std::int32_t>(packed.size() / CHUNK_CELLS);
+                packed.insert(packed.end(), cells, cells + CHUNK_CELLS);
+            }
+        }
+    }
+    chunkData.swap(packed);
+}
+
+inline std::vector<sf::Vector2i> Grid::findTiles(CellType flag) const
+{
+    std::vector<sf::Vector2i> tiles;
+    const int indexed = GHOST_SPAWN | PLAYER_START | GHOST_DOOR | TELEPORT | POWER_PELLET;
+    if (mappedHeader && (flag & indexed) == flag)
+    {
+        for (std::uint32_t i = 0; i < mappedHeader->specialCount; ++i)
+        {
+            if (mappedSpecials[i].flags & flag)
+                tiles.emplace_back(static_cast<int>(mappedSpecials[i].x), static_cast<int>(mappedSpecials[i].y));
+        }
+        return tiles; // written in row-major order
+    }
+
+    for (int cy = 0; cy < chunksY; ++cy)
+    {
+        for (int cx = 0; cx < chunksX; ++cx)
+        {
+            std::int32_t slot = slotOf(cy * chunksX + cx);
+            if (slot < 0 && (~slot & flag) == 0)
+                continue; // uniform chunk without the flag
+            int x0 = cx * CHUNK_SIZE;
+            int y0 = cy * CHUNK_SIZE;
+            int x1 = std::min(x0 + CHUNK_SIZE, width);
+            int y1 = std::min(y0 + CHUNK_SIZE, height);
+            for (int y = y0; y < y1; ++y)
+                for (int x = x0; x < x1; ++x)
+                    if (cellAt(x, y) & flag)
+                        tiles.emplace_back(x, y);
+        }
+    }
+    // Chunk order is not row-major across chunk boundaries; callers (ghost
+    // spawn order, tunnel pairing) expect the plain top-to-bottom scan order.
+    std::sort(tiles.begin(), tiles.end(), [](const sf::Vector2i &a, const sf::Vector2i &b)
+              { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+    return tiles;
+}
+
+inline std::vector<sf::Vector2i> Grid::diffCells(const Grid &other) const
+{
+    std::vector<sf::Vector2i> changed;
+    for (int cy = 0; cy < chunksY; ++cy)
+    {
+        for (int cx = 0; cx < chunksX; ++cx)
+        {
+            std::int32_t a = slotOf(cy * chunksX + cx);
+            std::int32_t b = other.slotOf(cy * chunksX + cx);
+            if (a < 0 && a == b)
+                continue; // same uniform value on both sides
+            int x0 = cx * CHUNK_SIZE;
+            int y0 = cy * CHUNK_SIZE;
+            int x1 = std::min(x0 + CHUNK_SIZE, width);
+            int y1 = std::min(y0 + CHUNK_SIZE, height);
+            for (int y = y0; y < y1; ++y)
+                for (int x = x0; x < x1; ++x)
+                    if (cellAt(x, y) != other.cellAt(x, y))
+                        changed.emplace_back(x, y);
+        }
+    }
+    std::sort(changed.begin(), changed.end(), [](const sf::Vector2i &l, const sf::Vector2i &r)
+              { return l.y != r.y ? l.y < r.y : l.x < r.x; });
+    return changed;
+}
+
+inline bool Grid::cellsChangedSince(std::uint64_t since, std::vector<sf::Vector2i> &cells) const
+{
+    cells.clear();
+    if (since == version)
+        return true;
+    // `since` has to be a version this grid's journal passed through: its
+    // base or one of its entries. Versions are process-wide, so a number
+    // from another board never matches.
+    std::size_t from = 0;
+    if (since != journalBase)
+    {
+        auto it = std::lower_bound(journal.begin(), journal.end(), since,
+                                   [](const JournalEntry &e, std::uint64_t v) { return e.version < v; });
+        if (it == journal.end() || it->version != since)
+            return false;
+        from = static_cast<std::size_t>(it - journal.begin()) + 1;
+    }
+    std::vector<std::int32_t> written;
+    for (std::size_t i = from; i < journal.size(); ++i)
+        written.push_back(journal[i].cell);
+    std::sort(written.begin(), written.end());
+    written.erase(std::unique(written.begin(), written.end()), written.end());
+    for (std::int32_t c : written)
+        cells.emplace_back(c % width, c / width);
+    return true;
+}
+
+inline void Grid::applyCells(const Grid &from, const std::vector<sf::Vector2i> &cells)
+{
+    for (const sf::Vector2i &c : cells)
+        setFlags(c.x, c.y, from.getFlags(c.x, c.y));
+    playerStartX = from.playerStartX;
+    playerStartY = from.playerStartY;
+    ghostSpawnX = from.ghostSpawnX;
+    ghostSpawnY = from.ghostSpawnY;
+    teleportTiles = from.teleportTiles;
+}
+
+inline bool Grid::getScoreboardBounds(int &minX, int &minY, int &maxX, int &maxY) const
+{
+    if (mappedHeader)
+    {
+        minX = mappedHeader->scoreboardMinX;
+        minY = mappedHeader->scoreboardMinY;
+        maxX = mappedHeader->scoreboardMaxX;
+        maxY = mappedHeader->scoreboardMaxY;
+        return maxX >= 0;
+    }
+
+    minX = width;
+    minY = height;
+    maxX = maxY = -1;
+    for (const sf::Vector2i &t : findTiles(SCOREBOARD))
+    {
+        minX = std::min(minX, t.x);
+        minY = std::min(minY, t.y);
+        maxX = std::max(maxX, t.x);
+        maxY = std::max(maxY, t.y);
+    }
+    return maxX >= 0;
+}
+
+inline bool Grid::loadCompiledMap(const std::string &filename)
+{
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(filename))
+    {
+        std::cout << "Failed to open compiled map: " << filename << std::endl;
+        return false;
+    }
+
+    std::string error;
+    const PmmHeader *header = reinterpret_cast<const PmmHeader *>(file->data());
+    if (file->size() < sizeof(PmmHeader) || !validatePmmHeader(*header, file->size(), CHUNK_SHIFT, error))
+    {
+        std::cout << "Bad compiled map " << filename << ": " << (error.empty() ? "too small" : error) << std::endl;
+        return false;
+    }
+
+    int newChunksX = (static_cast<int>(header->width) + CHUNK_MASK) >> CHUNK_SHIFT;
+    int newChunksY = (static_cast<int>(header->height) + CHUNK_MASK) >> CHUNK_SHIFT;
+    const std::int32_t *slots = reinterpret_cast<const std::int32_t *>(file->data() + header->slotsOffset);
+    bool slotsOk = header->chunkCount == static_cast<std::uint32_t>(newChunksX * newChunksY);
+    // The slot table is tiny next to the cells; checking it means a corrupt
+    // file can never index past the mapped chunk data.
+    for (std::uint32_t i = 0; slotsOk && i < header->chunkCount; ++i)
+        slotsOk = slots[i] < static_cast<std::int32_t>(header->storedChunks) && slots[i] >= -256;
+    if (!slotsOk)
+    {
+        std::cout << "Bad compiled map " << filename << ": corrupt chunk table" << std::endl;
+        return false;
+    }
+
+    resize(static_cast<int>(header->width), static_cast<int>(header->height));
+    chunkSlots.clear();
+    chunkSlots.shrink_to_fit();
+    mappedFile = file;
+    mappedHeader = header;
+    mappedSlots = slots;
+    mappedData = file->data() + header->dataOffset;
+    mappedSpecials = reinterpret_cast<const PmmSpecialTile *>(file->data() + header->specialsOffset);
+
+    // Spawn and tunnel tracking straight from the special-tile index; same
+    // last-one-wins order as addFlag during an image load.
+    for (std::uint32_t i = 0; i < header->specialCount; ++i)
+    {
+        const PmmSpecialTile &t = mappedSpecials[i];
+        if (t.x >= header->width || t.y >= header->height)
+            continue;
+        int x = static_cast<int>(t.x);
+        int y = static_cast<int>(t.y);
+        if (t.flags & PLAYER_START)
+        {
+            playerStartX = x;
+            playerStartY = y;
+        }
+        if (t.flags & GHOST_SPAWN)
+        {
+            ghostSpawnX = x;
+            ghostSpawnY = y;
+        }
+        if (t.flags & TELEPORT)
+            teleportTiles.emplace_back(x, y);
+    }
+
+    std::cout << "Compiled map mapped: " << width << "x" << height << " (" << header->storedChunks << "/"
+              << header->chunkCount << " chunks stored, hash " << std::hex << header->contentHash << std::dec << ")"
+              << std::endl;
+    return true;
+}
+
+inline bool Grid::saveCompiledMap(const std::string &filename) const
+{
+    const std::size_t chunks = static_cast<std::size_t>(chunksX) * chunksY;
+    std::vector<std::int32_t> slots(chunks);
+    for (std::size_t i = 0; i < chunks; ++i)
+        slots[i] = slotOf(static_cast<int>(i));
+    const std::size_t stored = getStoredChunkCount();
+    const std::uint8_t *data = stored ? chunkCells(0) : nullptr;
+
+    std::vector<PmmSpecialTile> specials;
+    for (int f : {GHOST_SPAWN, PLAYER_START, GHOST_DOOR, TELEPORT, POWER_PELLET})
+    {
+        for (const sf::Vector2i &t : findTiles(static_cast<CellType>(f)))
+            specials.push_back({static_cast<std::uint32_t>(t.x), static_cast<std::uint32_t>(t.y),
+                                static_cast<std::uint32_t>(cellAt(t.x, t.y))});
+    }
+    // One entry per tile, row-major (findTiles per flag, then merged).
+    std::sort(specials.begin(), specials.end(), [](const PmmSpecialTile &a, const PmmSpecialTile &b)
+              { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+    specials.erase(std::unique(specials.begin(), specials.end(), [](const PmmSpecialTile &a, const PmmSpecialTile &b)
+                               { return a.x == b.x && a.y == b.y; }),
+                   specials.end());
+
+    PmmHeader header{};
+    std::copy(PMM_MAGIC, PMM_MAGIC + 4, header.magic);
+    header.version = PMM_VERSION;
+    header.chunkShift = CHUNK_SHIFT;
+    header.endianTag = PMM_ENDIAN_TAG;
+    header.width = static_cast<std::uint32_t>(width);
+    header.height = static_cast<std::uint32_t>(height);
+    header.chunkCount = static_cast<std::uint32_t>(chunks);
+    header.storedChunks = static_cast<std::uint32_t>(stored);
+    header.specialCount = static_cast<std::uint32_t>(specials.size());
+    if (getScoreboardBounds(header.scoreboardMinX, header.scoreboardMinY, header.scoreboardMaxX, header.scoreboardMaxY))
+        header.flags |= PMM_HAS_SCOREBOARD;
+    else
+        header.scoreboardMinX = header.scoreboardMinY = header.scoreboardMaxX = header.scoreboardMaxY = -1;
+    if (teleportTiles.size() >= 2)
+        header.flags |= PMM_HAS_TUNNEL;
+    if (!findTiles(GHOST_DOOR).empty())
+        header.flags |= PMM_HAS_GHOST_DOOR;
+
+    header.slotsOffset = sizeof(PmmHeader);
+    header.specialsOffset = header.slotsOffset + slots.size() * sizeof(std::int32_t);
+    std::uint64_t specialsEnd = header.specialsOffset + specials.size() * sizeof(PmmSpecialTile);
+    header.dataOffset = (specialsEnd + PMM_DATA_ALIGN - 1) / PMM_DATA_ALIGN * PMM_DATA_ALIGN;
+    header.fileSize = header.dataOffset + stored * CHUNK_CELLS;
+
+    std::uint64_t hash = fnv1a64(slots.data(), slots.size() * sizeof(std::int32_t));
+    hash = fnv1a64(specials.data(), specials.size() * sizeof(PmmSpecialTile), hash);
+    header.contentHash = fnv1a64(data, stored * CHUNK_CELLS, hash);
+
+    // Write a temporary and rename it over the target: a running game may
+    // have the old file mapped, and truncating that in place would pull the
+    // pages out from under it. The rename also gives watchers one clean event.
+    const std::string tempName = filename + ".tmp";
+    std::ofstream out(tempName, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cout << "Failed to write compiled map: " << filename << std::endl;
+        return false;
+    }
+    const std::vector<char> padding(header.dataOffset - specialsEnd, 0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(std::int32_t)));
+    out.write(reinterpret_cast<const char *>(specials.data()), static_cast<std::streamsize>(specials.size() * sizeof(PmmSpecialTile)));
+    out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    if (stored)
+        out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(stored * CHUNK_CELLS));
+    out.close();
+
+    std::error_code ec;
+    if (out.fail() || (std::filesystem::rename(tempName, filename, ec), ec))
+    {
+        std::cout << "Failed to write compiled map: " << filename << std::endl;
+        std::filesystem::remove(tempName, ec);
+        return false;
+    }
+    return true;
+}
+
 #endif // GRID_H
\ No newline at end of file
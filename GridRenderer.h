@@ -0,0 +1,160 @@
+#ifndef GRIDRENDERER_H
+#define GRIDRENDERER_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <algorithm>
+#include "Grid.h"
+#include "PelletGrid.h"
+#include "SpriteSheet.h"
+#include "GameConfig.h"
+
+// Draws the board one Grid chunk at a time. The static part of a chunk (floor
+// and walls) is baked once into a vertex array and re-used every frame; only
+// chunks that intersect the current view are touched, so the draw cost follows
+// the window size, not the board size.
+class GridRenderer
+{
+private:
+    struct ChunkLayer
+    {
+        sf::VertexArray tiles{sf::Triangles};
+        bool built = false;
+    };
+
+    std::vector<ChunkLayer> layers;
+    int chunksX = 0;
+    int chunksY = 0;
+
+    static void appendQuad(sf::VertexArray &va, float left, float top, float right, float bottom, sf::Color color)
+    {
+        va.append(sf::Vertex(sf::Vector2f(left, top), color));
+        va.append(sf::Vertex(sf::Vector2f(right, top), color));
+        va.append(sf::Vertex(sf::Vector2f(right, bottom), color));
+        va.append(sf::Vertex(sf::Vector2f(left, top), color));
+        va.append(sf::Vertex(sf::Vector2f(right, bottom), color));
+        va.append(sf::Vertex(sf::Vector2f(left, bottom), color));
+    }
+
+    void buildChunk(const Grid &grid, int cx, int cy);
+
+public:
+    // Forget every cached chunk (new or resized board).
+    void invalidateAll()
+    {
+        layers.clear();
+        chunksX = chunksY = 0;
+    }
+
+    // Rebuild the chunk holding (x, y) the next time it is visible.
+    void invalidateCell(int x, int y)
+    {
+        int cx = x >> Grid::CHUNK_SHIFT;
+        int cy = y >> Grid::CHUNK_SHIFT;
+        if (cx >= 0 && cx < chunksX && cy >= 0 && cy < chunksY)
+            layers[cy * chunksX + cx].built = false;
+    }
+
+    void draw(sf::RenderTarget &target, const Grid &grid, const PelletGrid &pelletGrid, const SpriteSheet &sheet);
+};
+
+// Bake one chunk: a dark floor tile with a faint grid line on its top/left
+// edge for open cells, a solid blue block for walls. Ghost-spawn, player-start,
+// tunnel, and scoreboard tiles are NOT drawn — they drive logic only ("the
+// magnet under the table"), leaving a clean all-black-and-blue board.
+inline void GridRenderer::buildChunk(const Grid &grid, int cx, int cy)
+{
+    ChunkLayer &layer = layers[cy * chunksX + cx];
+    layer.tiles.clear();
+
+    const float cell = static_cast<float>(GameConfig::CELL_SIZE);
+    const sf::Color gridLine(20, 20, 20);
+    const sf::Color floor(10, 10, 10); // Very dark background
+    const sf::Color wall = sf::Color::Blue; // Classic Pac-Man blue walls
+
+    int x0 = cx * Grid::CHUNK_SIZE;
+    int y0 = cy * Grid::CHUNK_SIZE;
+    int x1 = std::min(x0 + Grid::CHUNK_SIZE, grid.getWidth());
+    int y1 = std::min(y0 + Grid::CHUNK_SIZE, grid.getHeight());
+
+    // One backdrop quad supplies the grid lines between all floor cells.
+    appendQuad(layer.tiles, x0 * cell, y0 * cell, x1 * cell, y1 * cell, gridLine);
+
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            float left = x * cell;
+            float top = y * cell;
+            if (grid.isWall(x, y))
+                appendQuad(layer.tiles, left, top, left + cell, top + cell, wall);
+            else
+                appendQuad(layer.tiles, left + 0.5f, top + 0.5f, left + cell, top + cell, floor);
+        }
+    }
+    layer.built = true;
+}
+
+inline void GridRenderer::draw(sf::RenderTarget &target, const Grid &grid, const PelletGrid &pelletGrid, const SpriteSheet &sheet)
+{
+    if (chunksX != grid.getChunksX() || chunksY != grid.getChunksY())
+    {
+        chunksX = grid.getChunksX();
+        chunksY = grid.getChunksY();
+        layers.assign(static_cast<std::size_t>(chunksX) * chunksY, ChunkLayer());
+    }
+
+    // Visible tile range from the current view (one tile of slack for rounding).
+    const sf::View &view = target.getView();
+    const float cell = static_cast<float>(GameConfig::CELL_SIZE);
+    sf::Vector2f topLeft = view.getCenter() - view.getSize() / 2.0f;
+    sf::Vector2f bottomRight = view.getCenter() + view.getSize() / 2.0f;
+    int tx0 = std::max(0, static_cast<int>(topLeft.x / cell) - 1);
+    int ty0 = std::max(0, static_cast<int>(topLeft.y / cell) - 1);
+    int tx1 = std::min(grid.getWidth(), static_cast<int>(bottomRight.x / cell) + 2);
+    int ty1 = std::min(grid.getHeight(), static_cast<int>(bottomRight.y / cell) + 2);
+    if (tx0 >= tx1 || ty0 >= ty1)
+        return;
+
+    // Static layer: only the chunks the view overlaps.
+    for (int cy = ty0 >> Grid::CHUNK_SHIFT; cy <= (ty1 - 1) >> Grid::CHUNK_SHIFT; ++cy)
+    {
+        for (int cx = tx0 >> Grid::CHUNK_SHIFT; cx <= (tx1 - 1) >> Grid::CHUNK_SHIFT; ++cx)
+        {
+            if (!layers[cy * chunksX + cx].built)
+                buildChunk(grid, cx, cy);
+            target.draw(layers[cy * chunksX + cx].tiles);
+        }
+    }
+
+    // Pellet dots drawn from the shared sheet (row 2 cells) instead of circles.
+    sf::Sprite pelletSprite(sheet.getTexture(), SpriteSheet::frameRect(PelletFrame::PELLET));
+    pelletSprite.setScale(GameConfig::SPRITE_SCALE, GameConfig::SPRITE_SCALE);
+
+    // Power pellet drawn much bigger (and centred) so it's unmistakable next to a normal dot.
+    sf::Sprite powerSprite(sheet.getTexture(), SpriteSheet::frameRect(PelletFrame::POWER));
+    powerSprite.setScale(GameConfig::SPRITE_SCALE * 2.5f, GameConfig::SPRITE_SCALE * 2.5f);
+    powerSprite.setOrigin(50.0f, 50.0f); // centre of the 100x100 cell art so it scales in place
+
+    // Dynamic layer: pellets change every frame, so they are drawn per visible cell.
+    for (int y = ty0; y < ty1; ++y)
+    {
+        for (int x = tx0; x < tx1; ++x)
+        {
+            float pixelX = x * cell;
+            float pixelY = y * cell;
+            if (pelletGrid.hasPowerPellet(x, y))
+            {
+                powerSprite.setPosition(pixelX + cell / 2.0f, pixelY + cell / 2.0f);
+                target.draw(powerSprite);
+            }
+            else if (pelletGrid.hasPellet(x, y))
+            {
+                pelletSprite.setPosition(pixelX, pixelY);
+                target.draw(pelletSprite);
+            }
+        }
+    }
+}
+
+#endif // GRIDRENDERER_H
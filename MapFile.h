@@ -0,0 +1,221 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Compiled map format (.pmm) — what `mapc` writes and the game mmaps.
+//
+// The body is the Grid's own chunk layout, byte for byte, so loading is "map
+// the file and point the Grid at it": no PNG decode, no colour matching, and
+// pages of a huge board are only read when something touches them.
+//
+//   [PmmHeader, 128 bytes]
+//   [chunk slot table: int32 per chunk, same meaning as Grid::chunkSlots]
+//   [special-tile index: PmmSpecialTile per spawn / door / tunnel / power tile]
+//   [padding to 4 KiB]
+//   [chunk data: CHUNK_CELLS flag bytes per stored chunk]
+//
+// All fields are little-endian. Bump PMM_VERSION on any layout change; old
+// files are then rejected and simply recompiled from their PNGs.
+// ---------------------------------------------------------------------------
+
+static const char PMM_MAGIC[4] = {'P', 'M', 'M', 'A'};
+static constexpr std::uint16_t PMM_VERSION = 1;
+static constexpr std::uint32_t PMM_ENDIAN_TAG = 0x01020304u; // reads back swapped on a big-endian host
+static constexpr std::uint64_t PMM_DATA_ALIGN = 4096;       // chunk data starts on a page
+
+// File-level flags (PmmHeader::flags).
+enum PmmFlags : std::uint32_t
+{
+    PMM_HAS_SCOREBOARD = 1u << 0,
+    PMM_HAS_TUNNEL = 1u << 1,
+    PMM_HAS_GHOST_DOOR = 1u << 2,
+};
+
+struct PmmHeader
+{
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t chunkShift;    // must match Grid::CHUNK_SHIFT
+    std::uint32_t endianTag;
+    std::uint32_t flags;         // PmmFlags
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t chunkCount;    // chunksX * chunksY
+    std::uint32_t storedChunks;  // chunks with real data
+    std::uint32_t specialCount;  // entries in the special-tile index
+    std::int32_t scoreboardMinX; // scoreboard bounds in tiles, -1 when absent
+    std::int32_t scoreboardMinY;
+    std::int32_t scoreboardMaxX;
+    std::int32_t scoreboardMaxY;
+    std::uint32_t reserved0;
+    std::uint64_t slotsOffset;
+    std::uint64_t specialsOffset;
+    std::uint64_t dataOffset;
+    std::uint64_t fileSize;
+    std::uint64_t contentHash;   // FNV-1a 64 over slots, specials and data
+    std::uint8_t reserved[32];
+};
+static_assert(sizeof(PmmHeader) == 128, "PmmHeader layout changed; bump PMM_VERSION");
+
+struct PmmSpecialTile
+{
+    std::uint32_t x;
+    std::uint32_t y;
+    std::uint32_t flags; // the tile's full CellType flags
+};
+static_assert(sizeof(PmmSpecialTile) == 12, "PmmSpecialTile layout changed; bump PMM_VERSION");
+
+// FNV-1a, 64-bit. Chainable: pass the previous result as `hash`.
+inline std::uint64_t fnv1a64(const void *data, std::size_t size, std::uint64_t hash = 0xcbf29ce484222325ull)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= p[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// The content hash of a mapped file, recomputed from its sections (touches
+// every page, so it is for tools and verification, not the load path).
+inline std::uint64_t pmmContentHash(const unsigned char *file, const PmmHeader &h, int chunkShift)
+{
+    std::uint64_t hash = fnv1a64(file + h.slotsOffset, 4ull * h.chunkCount);
+    hash = fnv1a64(file + h.specialsOffset, sizeof(PmmSpecialTile) * h.specialCount, hash);
+    return fnv1a64(file + h.dataOffset, (std::size_t{1} << (2 * chunkShift)) * h.storedChunks, hash);
+}
+
+// Read-only view of a whole file: mmap on POSIX, a file mapping on Windows.
+// Non-copyable; share it through a shared_ptr.
+class MappedFile
+{
+private:
+    const unsigned char *base = nullptr;
+    std::size_t length = 0;
+#if defined(_WIN32)
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string &path)
+    {
+        close();
+#if defined(_WIN32)
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0)
+        {
+            close();
+            return false;
+        }
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mappingHandle)
+        {
+            close();
+            return false;
+        }
+        base = static_cast<const unsigned char *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        length = static_cast<std::size_t>(size.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps the file alive
+        if (p == MAP_FAILED)
+            return false;
+        base = static_cast<const unsigned char *>(p);
+        length = static_cast<std::size_t>(st.st_size);
+#endif
+        if (!base)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+#if defined(_WIN32)
+        if (base)
+            UnmapViewOfFile(base);
+        if (mappingHandle)
+            CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (base)
+            munmap(const_cast<unsigned char *>(base), length);
+#endif
+        base = nullptr;
+        length = 0;
+    }
+
+    const unsigned char *data() const { return base; }
+    std::size_t size() const { return length; }
+};
+
+// Sanity-check a header against the file it came from (not the hash: that
+// would touch every page and defeat lazy mapping; `mapc --info` verifies it).
+inline bool validatePmmHeader(const PmmHeader &h, std::size_t fileSize, int chunkShift, std::string &error)
+{
+    const std::uint64_t chunkCells = 1ull << (2 * chunkShift);
+    if (std::memcmp(h.magic, PMM_MAGIC, sizeof(PMM_MAGIC)) != 0)
+        error = "not a compiled map";
+    else if (h.endianTag != PMM_ENDIAN_TAG)
+        error = "byte order mismatch";
+    else if (h.version != PMM_VERSION)
+        error = "format version " + std::to_string(h.version) + ", expected " + std::to_string(PMM_VERSION) + " (recompile it)";
+    else if (h.chunkShift != chunkShift)
+        error = "chunk size mismatch (recompile it)";
+    else if (h.fileSize != fileSize)
+        error = "truncated file";
+    else if (h.slotsOffset + 4ull * h.chunkCount > fileSize ||
+             h.specialsOffset + sizeof(PmmSpecialTile) * h.specialCount > fileSize ||
+             h.dataOffset + chunkCells * h.storedChunks > fileSize || h.slotsOffset % 4 != 0 || h.specialsOffset % 4 != 0)
+        error = "section out of bounds";
+    else
+        return true;
+    return false;
+}
+
+#endif // MAPFILE_H
@@ -0,0 +1,141 @@
+#ifndef MAPWATCHER_H
+#define MAPWATCHER_H
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <climits>
+#define MAPWATCHER_INOTIFY 1
+#endif
+
+// Watches one map file so the game can hot-swap it while running. On Linux
+// this is inotify on the file's *directory* (paint programs and mapc replace
+// files by writing a new one and renaming it over the old, which a watch on
+// the file itself would miss); elsewhere it polls the modification time.
+//
+// changed() is called once per frame and fires once per burst of writes,
+// after the file has been quiet for DEBOUNCE, so a half-written PNG is not
+// picked up mid-save.
+class MapWatcher
+{
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::chrono::milliseconds DEBOUNCE{250};
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{500}; // mtime fallback only
+
+    std::filesystem::path path;
+    bool pending = false;
+    Clock::time_point lastEvent;
+
+#ifdef MAPWATCHER_INOTIFY
+    int fd = -1;
+    int watch = -1;
+#endif
+    std::filesystem::file_time_type lastWrite{};
+    Clock::time_point lastPoll;
+
+    bool sawEvent();
+
+public:
+    explicit MapWatcher(const std::string &file);
+    MapWatcher(const MapWatcher &) = delete;
+    MapWatcher &operator=(const MapWatcher &) = delete;
+    ~MapWatcher();
+
+    // True once per finished change to the file.
+    bool changed();
+
+    const std::filesystem::path &getPath() const { return path; }
+};
+
+inline MapWatcher::MapWatcher(const std::string &file) : path(file), lastEvent(Clock::now()), lastPoll(Clock::now())
+{
+    std::error_code ec;
+    lastWrite = std::filesystem::last_write_time(path, ec);
+
+#ifdef MAPWATCHER_INOTIFY
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0)
+    {
+        std::filesystem::path dir = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+        watch = inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watch < 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd < 0)
+        std::cout << "inotify unavailable; polling " << path << " for changes" << std::endl;
+#endif
+    std::cout << "Watching " << path << " for live reload" << std::endl;
+}
+
+inline MapWatcher::~MapWatcher()
+{
+#ifdef MAPWATCHER_INOTIFY
+    if (fd >= 0)
+        close(fd);
+#endif
+}
+
+// Drain pending notifications; true if any of them named our file.
+inline bool MapWatcher::sawEvent()
+{
+#ifdef MAPWATCHER_INOTIFY
+    if (fd >= 0)
+    {
+        bool hit = false;
+        alignas(inotify_event) char buffer[sizeof(inotify_event) + NAME_MAX + 1];
+        const std::string name = path.filename().string();
+        for (;;)
+        {
+            ssize_t len = read(fd, buffer, sizeof(buffer));
+            if (len <= 0)
+                break; // EAGAIN: nothing more queued
+            for (char *p = buffer; p < buffer + len;)
+            {
+                const inotify_event *ev = reinterpret_cast<const inotify_event *>(p);
+                if (ev->len > 0 && name == ev->name)
+                    hit = true;
+                p += sizeof(inotify_event) + ev->len;
+            }
+        }
+        return hit;
+    }
+#endif
+
+    // Fallback: compare the modification time every POLL_INTERVAL.
+    if (Clock::now() - lastPoll < POLL_INTERVAL)
+        return false;
+    lastPoll = Clock::now();
+    std::error_code ec;
+    auto stamp = std::filesystem::last_write_time(path, ec);
+    if (ec || stamp == lastWrite)
+        return false;
+    lastWrite = stamp;
+    return true;
+}
+
+inline bool MapWatcher::changed()
+{
+    if (sawEvent())
+    {
+        pending = true;
+        lastEvent = Clock::now();
+    }
+    if (pending && Clock::now() - lastEvent >= DEBOUNCE)
+    {
+        pending = false;
+        return true;
+    }
+    return false;
+}
+
+#endif // MAPWATCHER_H
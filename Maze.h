@@ -6,6 +6,7 @@
 #include <iostream>
 #include <SFML/Graphics.hpp>
 #include "GameConfig.h"
+#include "TileClassifier.h"
 
 // Simple maze structure that focuses only on static layout
 class Maze
@@ -81,6 +82,8 @@ inline bool Maze::loadFromImage(const std::string &filename)
 
     std::cout << "Scale factors: " << scaleX << "x" << scaleY << std::endl;
 
+    const TileClassifier &classifier = TileClassifier::instance();
+
     // Sample the image to create our maze
     for (int y = 0; y < height; y++)
     {
@@ -96,44 +99,15 @@ inline bool Maze::loadFromImage(const std::string &filename)
 
             sf::Color pixelColor = image.getPixel(pixelX, pixelY);
 
-            // Enhanced color analysis for better tile type detection
-            int brightness = (pixelColor.r + pixelColor.g + pixelColor.b) / 3;
-
-            // Debug output for spawn points and some sample pixels
-            if ((x < 5 && y < 5) || (x == 14 && (y == 15 || y == 23)))
-            {
-                std::cout << "Pixel (" << x << "," << y << ") RGB("
-                          << (int)pixelColor.r << "," << (int)pixelColor.g << "," << (int)pixelColor.b
-                          << ") brightness=" << brightness << std::endl;
-            }
-
-            // Color-based tile type detection
-            if (brightness < 50)
-            {
-                // Very dark pixels = walls
-                walls[y][x] = true;
-            }
-            else if (pixelColor.r > 200 && pixelColor.g > 200 && pixelColor.b < 100)
-            {
-                // Yellow-ish pixels = special areas (could be power pellet spots)
-                walls[y][x] = false;
-                std::cout << "Found yellow area at (" << x << "," << y << ")" << std::endl;
-            }
-            else if (pixelColor.r < 100 && pixelColor.g < 100 && pixelColor.b > 200)
-            {
-                // Blue-ish pixels = corridors
-                walls[y][x] = false;
-            }
-            else if (brightness > 200)
-            {
-                // Very bright pixels = special corridors or spawn areas
-                walls[y][x] = false;
-            }
-            else
-            {
-                // Medium brightness = regular corridor
-                walls[y][x] = false;
-            }
+            // Same legend and classifier as Grid::loadMazeFromImage, so a map
+            // means the same thing to both loaders. Only walls matter here; the
+            // ghost door blocks like a wall for this static layout. Old
+            // dark-walled Maze.png files also count near-black as wall, where no
+            // legend colour claims it (Grid maps keep reading that as floor).
+            ImageTileType type = classifier.classify(pixelColor.r, pixelColor.g, pixelColor.b);
+            bool dark = (pixelColor.r + pixelColor.g + pixelColor.b) / 3 < 50;
+            walls[y][x] = (type == ImageTileType::WALL || type == ImageTileType::GHOST_DOOR ||
+                           (type == ImageTileType::EMPTY && dark));
         }
     }
 
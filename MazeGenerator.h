@@ -0,0 +1,351 @@
+#ifndef MAZEGENERATOR_H
+#define MAZEGENERATOR_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Grid.h"
+
+// ---------------------------------------------------------------------------
+// MazeGenerator — seeded, procedural Pac-Man-style boards of any size.
+//
+// The left half is carved on a lattice of corridor "nodes" (odd x, odd y):
+// a random spanning tree, a few extra loops, then every dead end is knocked
+// through (Pac-Man mazes have none). The half is mirrored, and the fixed
+// furniture is placed the way the hand-painted map has it: a ghost house with
+// a magenta door in the middle, ringed by a corridor; a side-to-side tunnel on
+// the house row; the player start below the house; a power pellet near each
+// corner; and a grey scoreboard strip along the bottom.
+//
+// Same seed + same size = same maze, on every platform (own RNG, no
+// std::distribution), so a generated corpus is a fixed benchmark set.
+// ---------------------------------------------------------------------------
+class MazeGenerator
+{
+public:
+    static constexpr int MIN_WIDTH = 24;
+    static constexpr int MIN_HEIGHT = 21;
+    static constexpr int MAX_SIDE = 4096;
+
+    explicit MazeGenerator(std::uint64_t seed = 1) : seed(seed), rngState(seed) {}
+
+    // Build a width x height maze straight into grid (resizing it; sizes are
+    // clamped to MIN_*..MAX_SIDE).
+    void generate(Grid &grid, int width, int height);
+
+private:
+    static constexpr std::uint8_t LINK_RIGHT = 1; // node -> node to the right (or across the middle)
+    static constexpr std::uint8_t LINK_DOWN = 2;  // node -> node below
+
+    std::uint64_t seed;
+    std::uint64_t rngState;
+
+    // splitmix64: tiny, fast, and identical everywhere.
+    std::uint64_t next()
+    {
+        std::uint64_t z = (rngState += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    int nextInt(int n) { return static_cast<int>(next() % static_cast<std::uint64_t>(n)); }
+    bool chance(int percent) { return nextInt(100) < percent; }
+};
+
+inline void MazeGenerator::generate(Grid &grid, int width, int height)
+{
+    rngState = seed;
+    width = std::max(MIN_WIDTH, std::min(width, MAX_SIDE));
+    height = std::max(MIN_HEIGHT, std::min(height, MAX_SIDE));
+
+    // Scoreboard: five grey rows plus a closing wall under the maze (31+ rows only).
+    const int scoreboardRows = (height >= 31) ? 6 : 0;
+    const int playHeight = height - scoreboardRows; // maze rows, bottom one is its wall
+
+    // Left-half lattice. Node (i, j) is the corridor cell (2i+1, 2j+1). The last
+    // node column stops short of the middle so the centre stays solid except
+    // where a row is deliberately bridged across to the mirrored half.
+    int half = (width - 3) / 2;
+    const int lastNodeX = (half % 2 == 1) ? half : half - 1;
+    const int lastNodeY = ((playHeight - 2) % 2 == 1) ? playHeight - 2 : playHeight - 3;
+    const int nx = (lastNodeX + 1) / 2;
+    const int ny = (lastNodeY + 1) / 2;
+
+    // Ghost house: the ring corridor's left side is node column iRing, its rows
+    // jTop..jBottom; the house itself is the three rows inside the ring.
+    const int ringX = std::max(3, (width / 2 - 7) | 1);
+    const int iRing = (ringX - 1) / 2;
+    const int ringTop = std::max(3, (playHeight / 2 - 3) | 1);
+    const int jTop = (ringTop - 1) / 2;
+    const int jMid = jTop + 1; // house / tunnel row
+    const int jBottom = jTop + 2;
+    int jStart = jBottom + 2; // player start row, bridged across the middle
+    if (jStart >= ny)
+        jStart = jBottom + 1;
+
+    auto node = [&](int i, int j)
+    { return j * nx + i; };
+    auto reserved = [&](int i, int j) // lattice nodes swallowed by the house
+    { return j == jMid && i > iRing; };
+    auto canLinkRight = [&](int i, int j)
+    {
+        if (reserved(i, j))
+            return false;
+        if (i == nx - 1)
+            return true; // a bridge across the middle
+        return !reserved(i + 1, j);
+    };
+    auto canLinkDown = [&](int i, int j)
+    { return j + 1 < ny && !reserved(i, j) && !reserved(i, j + 1); };
+
+    std::vector<std::uint8_t> links(static_cast<std::size_t>(nx) * ny, 0);
+
+    // 1. Random spanning tree (iterative depth-first search, no bridges).
+    {
+        std::vector<std::uint8_t> visited(links.size(), 0);
+        std::vector<int> stack;
+        stack.push_back(node(0, 0));
+        visited[0] = 1;
+        while (!stack.empty())
+        {
+            int cur = stack.back();
+            int i = cur % nx;
+            int j = cur / nx;
+            int options[4];
+            int count = 0;
+            if (i + 1 < nx && canLinkRight(i, j) && !visited[node(i + 1, j)])
+                options[count++] = 0;
+            if (i > 0 && canLinkRight(i - 1, j) && !visited[node(i - 1, j)])
+                options[count++] = 1;
+            if (canLinkDown(i, j) && !visited[node(i, j + 1)])
+                options[count++] = 2;
+            if (j > 0 && canLinkDown(i, j - 1) && !visited[node(i, j - 1)])
+                options[count++] = 3;
+            if (count == 0)
+            {
+                stack.pop_back();
+                continue;
+            }
+            int nextNode = 0;
+            switch (options[nextInt(count)])
+            {
+            case 0:
+                links[cur] |= LINK_RIGHT;
+                nextNode = node(i + 1, j);
+                break;
+            case 1:
+                links[node(i - 1, j)] |= LINK_RIGHT;
+                nextNode = node(i - 1, j);
+                break;
+            case 2:
+                links[cur] |= LINK_DOWN;
+                nextNode = node(i, j + 1);
+                break;
+            default:
+                links[node(i, j - 1)] |= LINK_DOWN;
+                nextNode = node(i, j - 1);
+                break;
+            }
+            visited[nextNode] = 1;
+            stack.push_back(nextNode);
+        }
+    }
+
+    // 2. Fixed corridors: the ring round the house (bridged top and bottom),
+    // the tunnel out to the left edge, and the player start row.
+    for (int i = iRing; i < nx; ++i)
+    {
+        links[node(i, jTop)] |= LINK_RIGHT;
+        links[node(i, jBottom)] |= LINK_RIGHT;
+    }
+    links[node(iRing, jTop)] |= LINK_DOWN;
+    links[node(iRing, jMid)] |= LINK_DOWN;
+    for (int i = 0; i < iRing; ++i)
+        links[node(i, jMid)] |= LINK_RIGHT;
+    links[node(nx - 1, jStart)] |= LINK_RIGHT;
+
+    // 3. Extra loops and bridges so it plays like an arcade maze, not a labyrinth.
+    for (int j = 0; j < ny; ++j)
+    {
+        for (int i = 0; i < nx; ++i)
+        {
+            if (i + 1 < nx && canLinkRight(i, j) && chance(6))
+                links[node(i, j)] |= LINK_RIGHT;
+            if (canLinkDown(i, j) && chance(6))
+                links[node(i, j)] |= LINK_DOWN;
+        }
+        if ((j < jTop || j > jBottom) && chance(20))
+            links[node(nx - 1, j)] |= LINK_RIGHT;
+    }
+
+    // 4. Braid: knock every dead end through to a neighbour, preferring one
+    // that is itself a dead end (one opening fixes both).
+    auto degree = [&](int i, int j)
+    {
+        int d = 0;
+        if (links[node(i, j)] & LINK_RIGHT)
+            d++;
+        if (links[node(i, j)] & LINK_DOWN)
+            d++;
+        if (i > 0 && (links[node(i - 1, j)] & LINK_RIGHT))
+            d++;
+        if (j > 0 && (links[node(i, j - 1)] & LINK_DOWN))
+            d++;
+        if (i == 0 && j == jMid)
+            d++; // the tunnel mouth
+        return d;
+    };
+    for (int j = 0; j < ny; ++j)
+    {
+        for (int i = 0; i < nx; ++i)
+        {
+            if (reserved(i, j) || degree(i, j) > 1)
+                continue;
+
+            // Candidate openings: 0 right/bridge, 1 left, 2 down, 3 up.
+            int options[4];
+            int count = 0;
+            int preferred[4];
+            int preferredCount = 0;
+            auto consider = [&](int dir, bool closedAndAllowed, int ni, int nj)
+            {
+                if (!closedAndAllowed)
+                    return;
+                options[count++] = dir;
+                if (ni >= 0 && degree(ni, nj) <= 1)
+                    preferred[preferredCount++] = dir;
+            };
+            consider(0, canLinkRight(i, j) && !(links[node(i, j)] & LINK_RIGHT), i + 1 < nx ? i + 1 : -1, j);
+            consider(1, i > 0 && canLinkRight(i - 1, j) && !(links[node(i - 1, j)] & LINK_RIGHT), i - 1, j);
+            consider(2, canLinkDown(i, j) && !(links[node(i, j)] & LINK_DOWN), i, j + 1);
+            consider(3, j > 0 && canLinkDown(i, j - 1) && !(links[node(i, j - 1)] & LINK_DOWN), i, j - 1);
+            if (count == 0)
+                continue;
+
+            int dir = preferredCount > 0 ? preferred[nextInt(preferredCount)] : options[nextInt(count)];
+            if (dir == 0)
+                links[node(i, j)] |= LINK_RIGHT;
+            else if (dir == 1)
+                links[node(i - 1, j)] |= LINK_RIGHT;
+            else if (dir == 2)
+                links[node(i, j)] |= LINK_DOWN;
+            else
+                links[node(i, j - 1)] |= LINK_DOWN;
+        }
+    }
+
+    // 5. Carve the left half into a flag buffer, then mirror it.
+    std::vector<std::uint8_t> cells(static_cast<std::size_t>(width) * height, WALL);
+    auto at = [&](int x, int y) -> std::uint8_t &
+    { return cells[static_cast<std::size_t>(y) * width + x]; };
+
+    for (int j = 0; j < ny; ++j)
+    {
+        for (int i = 0; i < nx; ++i)
+        {
+            if (reserved(i, j))
+                continue;
+            int x = 2 * i + 1;
+            int y = 2 * j + 1;
+            at(x, y) = EMPTY;
+            if (links[node(i, j)] & LINK_DOWN)
+                at(x, y + 1) = EMPTY;
+            if (links[node(i, j)] & LINK_RIGHT)
+            {
+                if (i + 1 < nx)
+                    at(x + 1, y) = EMPTY;
+                else
+                    for (int bx = x + 1; bx < width - 1 - x; ++bx)
+                        at(bx, y) = EMPTY; // bridge over the middle
+            }
+        }
+    }
+    const int tunnelY = 2 * jMid + 1;
+    at(0, tunnelY) = TELEPORT;
+    for (int y = 0; y < playHeight; ++y)
+        for (int x = 0; x <= lastNodeX; ++x)
+            at(width - 1 - x, y) = at(x, y);
+
+    // 6. Ghost house: walls, a magenta door in the top wall, four spawn tiles.
+    const int ringRight = width - 1 - ringX;
+    for (int y = ringTop + 1; y <= ringTop + 3; ++y)
+        for (int x = ringX + 1; x < ringRight; ++x)
+            at(x, y) = (y == ringTop + 2 && x > ringX + 1 && x < ringRight - 1) ? EMPTY : WALL;
+    if (width % 2 == 0)
+    {
+        at(width / 2 - 1, ringTop + 1) = WALL | GHOST_DOOR;
+        at(width / 2, ringTop + 1) = WALL | GHOST_DOOR;
+    }
+    else
+    {
+        at(width / 2, ringTop + 1) = WALL | GHOST_DOOR;
+    }
+    at(ringX + 3, tunnelY) = GHOST_SPAWN;
+    at(ringX + 5, tunnelY) = GHOST_SPAWN;
+    at(ringRight - 5, tunnelY) = GHOST_SPAWN;
+    at(ringRight - 3, tunnelY) = GHOST_SPAWN;
+
+    // 7. Pellets on every open corridor tile except the house and the tunnel.
+    for (int y = 0; y < playHeight; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (at(x, y) != EMPTY)
+                continue;
+            bool inTunnel = (y == tunnelY && (x < ringX || x > ringRight));
+            bool inHouse = (y == tunnelY && x > ringX && x < ringRight);
+            if (!inTunnel && !inHouse)
+                at(x, y) = PELLET;
+        }
+    }
+
+    // Player start: the middle of the start row (two tiles on even widths).
+    const int startY = 2 * jStart + 1;
+    at(width / 2, startY) = PLAYER_START;
+    if (width % 2 == 0)
+        at(width / 2 - 1, startY) = PLAYER_START;
+
+    // Power pellets: one near each corner, plus mirrored extras on big boards.
+    auto placePower = [&](int x, int y)
+    {
+        if (at(x, y) == PELLET)
+        {
+            at(x, y) = POWER_PELLET;
+            at(width - 1 - x, y) = POWER_PELLET;
+        }
+    };
+    placePower(1, 3);
+    placePower(1, 2 * std::max(0, ny - 3) + 1);
+    int extraPower = (nx * ny) / 400;
+    for (int k = 0; k < extraPower; ++k)
+        placePower(2 * nextInt(nx) + 1, 2 * nextInt(ny) + 1);
+
+    // 8. Scoreboard strip under the maze.
+    for (int y = playHeight; y < height - 1; ++y)
+        for (int x = 1; x < width - 1; ++x)
+            at(x, y) = SCOREBOARD;
+
+    // Hand the buffer to the grid. Spawn/tunnel flags go through addFlag so the
+    // grid's spawn points and tunnel pair are registered.
+    const int tracked = PLAYER_START | GHOST_SPAWN | TELEPORT;
+    grid.resize(width, height);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            int flags = at(x, y);
+            if (flags == EMPTY)
+                continue;
+            grid.setFlags(x, y, flags & ~tracked);
+            if (flags & PLAYER_START)
+                grid.addFlag(x, y, PLAYER_START);
+            if (flags & GHOST_SPAWN)
+                grid.addFlag(x, y, GHOST_SPAWN);
+            if (flags & TELEPORT)
+                grid.addFlag(x, y, TELEPORT);
+        }
+    }
+    grid.compact();
+}
+
+#endif // MAZEGENERATOR_H
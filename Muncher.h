@@ -8,6 +8,9 @@
 #include "GameConfig.h"
 #include "SpriteSheet.h"
 #include "PausableClock.h"
+#include "TimerWheel.h"
+#include "SweptContact.h"
+#include "TileEvents.h"
 
 enum class MuncherDirection // Direction enum for Muncher
 {
@@ -37,8 +40,8 @@ private:
     const SpriteSheet *sheet = nullptr;
     sf::Sprite sprite;
 
-    // Animation timing
-    PausableClock animationClock;
+    // Animation timing: the next frame is a timer on the game's wheel
+    TimerWheel::TimerId animationTimer = 0;
     float animationSpeed; // Time between frames in seconds
     int currentFrame;
 
@@ -48,13 +51,18 @@ private:
     float movementSpeed; // Time to complete one grid movement
     bool isMoving;
 
+    // This update's path for swept ghost contact (SweptContact.h)
+    sf::Vector2f sweepFrom, sweepTo;
+    float arrivedAgo = 0.0f; // seconds since the tile was reached, if it was this update
+
 public:
     // Constructor
-    Muncher(int startX, int startY, int gridSize, const SpriteSheet &sheetRef);
+    Muncher(int startX, int startY, int gridSize, const SpriteSheet *sheetPtr); // null sheet = headless (no sprite frames)
 
     // Animation methods
     void applyFrame(); // set texture-rect + rotation from state/direction
-    void updateAnimation();
+    void restartAnimation(); // hold this frame for animationSpeed (GameSession's wheel)
+    void onAnimationTimer(TimerWheel::TimerId id);
     void updateMovement();
     void setState(MuncherState newState);
 
@@ -87,11 +95,24 @@ public:
     {
         return isMoving;
     }
+    // Tile being walked into while moving, else the current tile: where the
+    // buffered turn (desiredDir) will next be taken.
+    sf::Vector2i getNextTile() const
+    {
+        return isMoving ? sf::Vector2i(static_cast<int>(targetPosition.x / size), static_cast<int>(targetPosition.y / size))
+                        : position;
+    }
+    float getMovementSpeed() const { return movementSpeed; } // seconds per tile
+    // Path walked in the last updateMovement, which ran `interval` seconds after the one before.
+    MotionSweep getSweep(float interval) const
+    {
+        float end = interval > 0.0f ? 1.0f - arrivedAgo / interval : 1.0f;
+        return MotionSweep{sweepFrom, sweepTo, std::clamp(end, 0.0f, 1.0f)};
+    }
 
     // Freeze/unfreeze this entity's timers for the pause menu.
     void setPaused(bool p)
     {
-        animationClock.setPaused(p);
         movementClock.setPaused(p);
     }
 
@@ -101,6 +122,8 @@ public:
         position = sf::Vector2i(startX, startY);
         renderPosition = sf::Vector2f(startX * size, startY * size);
         targetPosition = renderPosition;
+        sweepFrom = sweepTo = renderPosition;
+        arrivedAgo = 0.0f;
         direction = MuncherDirection::RIGHT;
         isMoving = false;
         currentFrame = 0;
@@ -111,13 +134,14 @@ public:
 };
 
 // Constructor implementation
-inline Muncher::Muncher(int startX, int startY, int gridSize, const SpriteSheet &sheetRef)
+inline Muncher::Muncher(int startX, int startY, int gridSize, const SpriteSheet *sheetPtr)
     : position(startX, startY), renderPosition(startX * gridSize, startY * gridSize),
       direction(MuncherDirection::RIGHT), state(MuncherState::IDLE),
-      size(gridSize), sheet(&sheetRef), animationSpeed(0.2f), currentFrame(0),
+      size(gridSize), sheet(sheetPtr), animationSpeed(0.2f), currentFrame(0),
       movementSpeed(0.3f), isMoving(false)
 {
     targetPosition = renderPosition;
+    sweepFrom = sweepTo = renderPosition;
     sprite.setOrigin(50.0f, 50.0f); // centre of a 100x100 cell (rotation pivot)
     sprite.setPosition(renderPosition.x + gridSize / 2.0f, renderPosition.y + gridSize / 2.0f);
     applyFrame();
@@ -179,20 +203,32 @@ inline void Muncher::applyFrame()
     }
 }
 
-// Update animation frames
-inline void Muncher::updateAnimation()
+// Next animation frame in animationSpeed, on the active wheel (GameSession
+// installs it while it updates); without one the frame holds.
+inline void Muncher::restartAnimation()
 {
-    if (animationClock.getElapsedTime().asSeconds() >= animationSpeed)
+    if (TimerWheel *wheel = TimerWheel::active())
     {
-        currentFrame++;
-        applyFrame();
-        animationClock.restart();
+        wheel->cancel(animationTimer);
+        animationTimer = wheel->scheduleIn(sf::seconds(animationSpeed), MUNCHER_FRAME);
     }
 }
 
+// Animation timer fired: advance a frame (unless a state change restarted it since)
+inline void Muncher::onAnimationTimer(TimerWheel::TimerId id)
+{
+    if (id != animationTimer)
+        return;
+    currentFrame++;
+    applyFrame();
+    restartAnimation();
+}
+
 // Update smooth movement between grid positions
 inline void Muncher::updateMovement()
 {
+    sweepFrom = renderPosition;
+    arrivedAgo = 0.0f;
     if (isMoving)
     {
         float elapsed = movementClock.getElapsedTime().asSeconds();
@@ -200,10 +236,12 @@ inline void Muncher::updateMovement()
 
         if (progress >= 1.0f)
         {
-            // Movement complete
+            // Movement complete (the tile was reached `arrivedAgo` seconds ago)
             renderPosition = targetPosition;
             position = sf::Vector2i(targetPosition.x / size, targetPosition.y / size);
             isMoving = false;
+            arrivedAgo = elapsed - movementSpeed;
+            TileEvents::emit(TileEvent::ENTER, TileEvent::MUNCHER, position);
             setState(MuncherState::IDLE);
         }
         else
@@ -217,6 +255,7 @@ inline void Muncher::updateMovement()
         // Adjust position for rotated sprite (add half cell size to account for origin at center)
         sprite.setPosition(renderPosition.x + size / 2.0f, renderPosition.y + size / 2.0f);
     }
+    sweepTo = renderPosition;
 }
 
 // Set animation state
@@ -226,7 +265,7 @@ inline void Muncher::setState(MuncherState newState)
     {
         state = newState;
         currentFrame = 0;
-        animationClock.restart();
+        restartAnimation();
         applyFrame();
     }
 }
@@ -303,6 +342,8 @@ inline void Muncher::startMovement(const Grid &grid, MuncherDirection dir)
         if (partner.x != -1)
         {
             direction = dir;
+            TileEvents::emit(TileEvent::LEAVE, TileEvent::MUNCHER, position);
+            TileEvents::emit(TileEvent::ENTER, TileEvent::MUNCHER, partner);
             position = partner;
             renderPosition = sf::Vector2f(partner.x * size, partner.y * size);
             targetPosition = renderPosition;
@@ -323,6 +364,7 @@ inline void Muncher::startMovement(const Grid &grid, MuncherDirection dir)
     isMoving = true;
     setState(MuncherState::MOVING);
     movementClock.restart();
+    TileEvents::emit(TileEvent::LEAVE, TileEvent::MUNCHER, position);
 }
 
 #endif
@@ -0,0 +1,393 @@
+#ifndef MUNCHERBOT_H
+#define MUNCHERBOT_H
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+#include "GameSession.h"
+#include "Grid.h"
+#include "Muncher.h"
+#include "Spookies.h"
+#include "ThreatMap.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+
+// Autoplayer for the muncher. It only ever calls
+// GameSession::setDesiredDirection — the buffered turn the arrow keys set —
+// so it plays by exactly the rules a person does, windowed or headless.
+//
+// Each frame it plans the turn for the tile the muncher is walking into:
+// - Danger: a BFS from every nearby live ghost (through the ghost door, as
+//   ghosts walk) gives the earliest time a ghost can stand on each tile,
+//   using that ghost's own speed. A tile is safe if the muncher gets there a
+//   margin sooner. The BFS fields live in a ThreatMap and are only redone
+//   when a ghost changes tile or state.
+// - Routing: a BFS from the muncher over safe tiles only, tagged by first
+//   move, finds the nearest pellet (or frightened ghost) down each opening
+//   and how much safe room lies behind it; dead ends are scored down.
+// - Rollouts (optional): at a fresh decision, each opening is also played out
+//   on a fork of the game for a second or two by the plain bot, and losing a
+//   life there outweighs any pellet. Playouts keep passing through states
+//   earlier ones (and the real game) already scored, so with rollouts on the
+//   opening scores are kept in a transposition table keyed by the game's
+//   Zobrist hash and looked up instead of rescored.
+//
+// Strength 0..1 sets how far away ghosts are noticed and how often the bot
+// fumbles a turn on purpose; 1 plays as well as it can.
+class MuncherBot
+{
+public:
+    // scoreOpenings for one state, as a transposition table payload.
+    struct OpeningScores
+    {
+        float score[4];
+        std::uint32_t open; // bit per direction
+        std::uint32_t unused;
+    };
+    using OpeningTable = TranspositionTable<OpeningScores>;
+
+    struct Settings
+    {
+        float strength = 1.0f; // 0 = careless, 1 = best effort
+        int rolloutFrames = 0; // > 0: play each opening out this many frames on a fork
+        unsigned seed = 1;     // for deliberate mistakes
+        // Opening scores to share (e.g. between games on one map and curve,
+        // any number of threads); null = a table of the bot's own when
+        // rollouts are on, none otherwise.
+        OpeningTable *table = nullptr;
+    };
+
+    MuncherBot();
+    explicit MuncherBot(const Settings &s);
+
+    // Plan and set this frame's buffered turn (no-op while dying / game over).
+    void play(GameSession &game);
+
+    // The turn the bot would take at the muncher's next tile.
+    MuncherDirection choose(const GameSession &game);
+
+    long getRollouts() const { return rollouts; }
+    const OpeningTable *getTable() const { return table; }
+
+private:
+    static constexpr int INF = std::numeric_limits<int>::max() / 4;
+    static constexpr float FRAME = 1.0f / 60.0f;
+
+    Settings settings;
+    std::minstd_rand rng;
+
+    // Scratch, reused between frames (sized to the board on demand).
+    std::vector<int> dist;        // muncher BFS distance per tile
+    std::vector<int> firstMove;   // opening each tile was reached through
+    std::vector<int> queue;
+
+    // Ghost reach per tile (ThreatMap.h), and the ghosts close enough to count.
+    ThreatMap threats;
+    std::vector<int> nearGhosts;
+    int reach = 0; // steps; twice the danger radius
+
+    // The plan only changes when something it looks at does: the muncher's or
+    // a ghost's next tile, ghost states, the AI mode or the pellet count.
+    std::vector<int> planKey, lastPlanKey;
+    MuncherDirection lastPlan = MuncherDirection::RIGHT;
+
+    // Rollout values are worked out once per decision tile.
+    sf::Vector2i rolloutTile{-1, -1};
+    MuncherDirection rolloutHeading = MuncherDirection::RIGHT;
+    float rolloutValue[4] = {0, 0, 0, 0};
+    long rollouts = 0;
+
+    // Opening scores by state hash; shared with this bot's rollout players.
+    std::shared_ptr<OpeningTable> ownTable;
+    OpeningTable *table = nullptr;
+
+    int dangerRadius() const { return 3 + static_cast<int>(17.0f * settings.strength); } // tiles
+    float mistakeRate() const { return 0.25f * (1.0f - settings.strength); }
+
+    static sf::Vector2i step(sf::Vector2i p, int dir)
+    {
+        static const int dx[4] = {0, 0, -1, 1}; // UP, DOWN, LEFT, RIGHT
+        static const int dy[4] = {-1, 1, 0, 0};
+        return sf::Vector2i(p.x + dx[dir], p.y + dy[dir]);
+    }
+    static bool muncherCanEnter(const Grid &grid, sf::Vector2i p)
+    {
+        return grid.isValidPosition(p.x, p.y) && !grid.isWall(p.x, p.y);
+    }
+    static bool ghostCanEnter(const Grid &grid, sf::Vector2i p)
+    {
+        return grid.isValidPosition(p.x, p.y) && (!grid.isWall(p.x, p.y) || grid.isGhostDoor(p.x, p.y));
+    }
+
+    void buildDanger(const GameSession &game, sf::Vector2i around);
+    // Earliest time a near ghost can stand on a cell, seconds (max = never).
+    float ghostTime(int cell) const
+    {
+        float best = std::numeric_limits<float>::max();
+        for (int i : nearGhosts)
+        {
+            int steps = threats.steps(i, cell);
+            if (steps <= reach)
+                best = std::min(best, steps * threats.getSecondsPerTile(i));
+        }
+        return best;
+    }
+    void scoreOpenings(const GameSession &game, sf::Vector2i from, float score[4], bool open[4]);
+    void runRollouts(const GameSession &game, sf::Vector2i from, const bool open[4]);
+};
+
+inline MuncherBot::MuncherBot() : MuncherBot(Settings()) {}
+
+inline MuncherBot::MuncherBot(const Settings &s) : settings(s), rng(s.seed)
+{
+    settings.strength = std::max(0.0f, std::min(1.0f, settings.strength));
+    table = settings.table;
+    if (!table && settings.rolloutFrames > 0)
+    {
+        ownTable = std::make_shared<OpeningTable>();
+        table = ownTable.get();
+    }
+}
+
+inline void MuncherBot::play(GameSession &game)
+{
+    if (game.isDying() || game.isGameOver())
+        return;
+    game.setDesiredDirection(choose(game));
+}
+
+// Live ghosts near `around` (within twice the danger radius): the only ones
+// the danger check counts. Their fields come from the threat map, which only
+// redoes a ghost's BFS when that ghost changes tile or state.
+inline void MuncherBot::buildDanger(const GameSession &game, sf::Vector2i around)
+{
+    const Grid &grid = game.getGrid();
+    const std::size_t cells = static_cast<std::size_t>(grid.getWidth()) * grid.getHeight();
+    dist.resize(cells);
+    queue.resize(cells);
+    threats.update(grid, game.getGhosts(), false); // far ghosts' fields are never built
+
+    reach = 2 * dangerRadius();
+    nearGhosts.clear();
+    for (int i = 0; i < threats.getGhostCount(); ++i)
+    {
+        sf::Vector2i start = threats.getSource(i);
+        if (threats.isThreat(i) && std::abs(start.x - around.x) + std::abs(start.y - around.y) <= reach)
+        {
+            threats.prepare(i, reach);
+            nearGhosts.push_back(i);
+        }
+    }
+}
+
+inline MuncherDirection MuncherBot::choose(const GameSession &game)
+{
+    const Muncher &muncher = game.getMuncher();
+    const sf::Vector2i from = muncher.getNextTile();
+    const MuncherDirection heading = muncher.getDirection();
+
+    planKey.clear();
+    planKey.insert(planKey.end(), {from.x, from.y, static_cast<int>(heading), static_cast<int>(game.getGhostAI().getCurrentMode()),
+                                   game.getPellets().countPellets(), game.getPellets().countPowerPellets()});
+    for (const Ghost &ghost : game.getGhosts())
+        planKey.insert(planKey.end(), {ghost.getNextTile().x, ghost.getNextTile().y, static_cast<int>(ghost.getState()),
+                                       ghost.getIsEaten() ? 1 : 0});
+    if (planKey == lastPlanKey)
+        return lastPlan;
+    lastPlanKey.swap(planKey);
+
+    // The scores read only what the hash covers (tiles, ghost states, mode,
+    // level for speeds, pellets) plus how far this bot looks.
+    float score[4];
+    bool open[4];
+    OpeningScores known;
+    const std::uint64_t key = table ? game.getHash() ^ zobristKey(ZobristFeature::SALT, static_cast<std::uint64_t>(dangerRadius())) : 0;
+    if (table && table->probe(key, known))
+    {
+        for (int d = 0; d < 4; ++d)
+        {
+            score[d] = known.score[d];
+            open[d] = (known.open >> d & 1) != 0;
+        }
+    }
+    else
+    {
+        scoreOpenings(game, from, score, open);
+        if (table)
+        {
+            known = OpeningScores{{score[0], score[1], score[2], score[3]}, 0, 0};
+            for (int d = 0; d < 4; ++d)
+                known.open |= open[d] ? 1u << d : 0u;
+            table->store(key, known);
+        }
+    }
+
+    int openCount = 0;
+    for (int d = 0; d < 4; ++d)
+        openCount += open[d];
+    if (openCount == 0)
+        return lastPlan = heading;
+
+    // A fresh decision tile: maybe fumble it, maybe play the openings out.
+    bool freshTile = from != rolloutTile || heading != rolloutHeading;
+    if (freshTile)
+    {
+        rolloutTile = from;
+        rolloutHeading = heading;
+        std::fill(rolloutValue, rolloutValue + 4, 0.0f);
+        if (settings.rolloutFrames > 0 && openCount > 1)
+            runRollouts(game, from, open);
+        if (mistakeRate() > 0.0f && std::uniform_real_distribution<float>(0.0f, 1.0f)(rng) < mistakeRate())
+        {
+            int pick = std::uniform_int_distribution<int>(0, openCount - 1)(rng);
+            for (int d = 0; d < 4; ++d)
+                if (open[d] && pick-- == 0)
+                    rolloutValue[d] += 5000.0f; // deliberate mistake, kept for this tile
+        }
+    }
+
+    // Best opening; ties keep the current heading so the bot doesn't dither.
+    int best = -1;
+    float bestScore = -std::numeric_limits<float>::max();
+    for (int d = 0; d < 4; ++d)
+    {
+        if (!open[d])
+            continue;
+        float s = score[d] + rolloutValue[d] + (d == static_cast<int>(heading) ? 0.5f : 0.0f);
+        if (s > bestScore)
+        {
+            bestScore = s;
+            best = d;
+        }
+    }
+    return lastPlan = static_cast<MuncherDirection>(best);
+}
+
+// Heuristic value of each opening out of `from`.
+inline void MuncherBot::scoreOpenings(const GameSession &game, sf::Vector2i from, float score[4], bool open[4])
+{
+    const Grid &grid = game.getGrid();
+    const PelletGrid &pellets = game.getPellets();
+    const int w = grid.getWidth();
+    const float secondsPerTile = game.getMuncher().getMovementSpeed();
+    const float margin = secondsPerTile * 1.5f; // arrive this much before any ghost
+
+    buildDanger(game, from);
+
+    // Frightened ghosts still worth chasing count as targets too.
+    std::vector<int> prey;
+    if (game.getGhostAI().getCurrentMode() == AIMode::FRIGHTENED)
+    {
+        for (const Ghost &ghost : game.getGhosts())
+            if (ghost.getState() == GhostState::FRIGHTENED && !ghost.getIsEaten())
+                prey.push_back(ghost.getNextTile().y * w + ghost.getNextTile().x);
+    }
+
+    std::fill(dist.begin(), dist.end(), INF);
+    firstMove.assign(dist.size(), -1);
+    int nearestTarget[4] = {INF, INF, INF, INF};
+    int room[4] = {0, 0, 0, 0};
+
+    int head = 0, tail = 0;
+    for (int d = 0; d < 4; ++d)
+    {
+        sf::Vector2i n = step(from, d);
+        open[d] = muncherCanEnter(grid, n);
+        score[d] = 0.0f;
+        if (!open[d])
+            continue;
+        int cell = n.y * w + n.x;
+        if (secondsPerTile + margin >= ghostTime(cell))
+        {
+            score[d] = -100000.0f; // a ghost gets there first
+            continue;
+        }
+        if (dist[cell] != INF)
+            continue;
+        dist[cell] = 1;
+        firstMove[cell] = d;
+        queue[tail++] = cell;
+    }
+
+    const int maxRoom = 48;
+    while (head < tail)
+    {
+        int cell = queue[head++];
+        int d = dist[cell];
+        int move = firstMove[cell];
+        ++room[move];
+
+        sf::Vector2i p(cell % w, cell / w);
+        if (nearestTarget[move] == INF &&
+            (pellets.hasPellet(p.x, p.y) || pellets.hasPowerPellet(p.x, p.y) ||
+             std::find(prey.begin(), prey.end(), cell) != prey.end()))
+            nearestTarget[move] = d;
+        if (room[move] >= maxRoom && nearestTarget[move] != INF)
+            continue; // enough known about this opening
+
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            sf::Vector2i n = step(p, dir);
+            if (!muncherCanEnter(grid, n))
+                continue;
+            int nc = n.y * w + n.x;
+            if (dist[nc] != INF || (d + 1) * secondsPerTile + margin >= ghostTime(nc))
+                continue;
+            dist[nc] = d + 1;
+            firstMove[nc] = move;
+            queue[tail++] = nc;
+        }
+    }
+
+    for (int d = 0; d < 4; ++d)
+    {
+        if (!open[d] || score[d] < 0.0f)
+            continue;
+        if (nearestTarget[d] != INF)
+            score[d] += 1000.0f - 10.0f * nearestTarget[d];
+        score[d] += 2.0f * std::min(room[d], maxRoom);
+        if (room[d] < 8)
+            score[d] -= 500.0f; // a small pocket: easy to get cornered in
+    }
+}
+
+// Play each opening forward on a fork with the plain bot (no rollouts, no
+// mistakes). Losing a life dominates; otherwise points gained break ties.
+inline void MuncherBot::runRollouts(const GameSession &game, sf::Vector2i from, const bool open[4])
+{
+    Settings plain;
+    plain.strength = 1.0f;
+    plain.table = table;
+    for (int d = 0; d < 4; ++d)
+    {
+        if (!open[d])
+            continue;
+        GameSession sim = game.fork();
+        MuncherBot inner(plain);
+        const int livesBefore = sim.getPoints().getLives();
+        const int pointsBefore = sim.getPoints().getTotalPoints();
+        sim.setDesiredDirection(static_cast<MuncherDirection>(d));
+        const sf::Vector2i taken = step(from, d);
+        bool committed = false;
+        int frame = 0;
+        for (; frame < settings.rolloutFrames; ++frame)
+        {
+            sim.step(sf::seconds(FRAME));
+            if (sim.isDying() || sim.getPoints().getLives() < livesBefore)
+                break;
+            // Hold the opening under test until the muncher has taken it.
+            committed = committed || sim.getMuncher().getNextTile() == taken;
+            if (committed)
+                inner.play(sim);
+        }
+        bool died = sim.isDying() || sim.getPoints().getLives() < livesBefore;
+        rolloutValue[d] = died ? -50000.0f + 10.0f * frame : 0.1f * (sim.getPoints().getTotalPoints() - pointsBefore);
+        ++rollouts;
+    }
+}
+
+#endif // MUNCHERBOT_H
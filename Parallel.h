@@ -0,0 +1,59 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Worker count to use when the caller does not care: one per hardware thread
+// (hardware_concurrency may report 0 when it cannot tell).
+inline unsigned defaultThreadCount()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+// Split [begin, end) into one contiguous band per worker and run
+// fn(bandBegin, bandEnd) on each, the calling thread taking the first band.
+// Bands never overlap, so workers may write disjoint slices of shared output
+// without locking. Falls back to a plain call for tiny ranges or threads <= 1.
+template <typename Fn>
+void parallelFor(int begin, int end, unsigned threads, Fn fn)
+{
+    int count = end - begin;
+    if (count <= 0)
+        return;
+    int workers = static_cast<int>(std::min<unsigned>(threads ? threads : defaultThreadCount(), static_cast<unsigned>(count)));
+    if (workers <= 1)
+    {
+        fn(begin, end);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    int band = (count + workers - 1) / workers;
+    for (int w = 1; w < workers; ++w)
+    {
+        int b = begin + w * band;
+        int e = std::min(end, b + band);
+        if (b < e)
+        {
+            // No thread to spare: run the band here rather than unwind past
+            // the running ones (a joinable std::thread terminates the process).
+            try
+            {
+                pool.emplace_back(fn, b, e);
+            }
+            catch (...)
+            {
+                fn(b, e);
+            }
+        }
+    }
+    fn(begin, std::min(end, begin + band));
+    for (std::thread &t : pool)
+        t.join();
+}
+
+#endif // PARALLEL_H
@@ -0,0 +1,688 @@
+#ifndef PATHHIERARCHY_H
+#define PATHHIERARCHY_H
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Grid.h"
+
+// Hierarchical pathfinding (HPA*) for ghosts on large boards, where a BFS
+// over the whole map per decision gets expensive.
+//
+// The board is cut into CLUSTER x CLUSTER squares. Where two neighbouring
+// squares share a run of open border tiles, one crossing (two for a long
+// run) becomes a pair of nodes joined by a 1-step edge; inside each square
+// its nodes are joined by their in-square walking distance. A query walks
+// only the start's and goal's squares tile by tile and runs A* over the
+// nodes in between, so its cost and the graph's memory follow the number of
+// border crossings rather than tiles. Paths are near-shortest: legs are
+// exact, but a path is forced through the chosen crossings.
+//
+// Walkable is the returning eyes' rule: open tiles, the ghost door and the
+// ghost house. Tunnel warps are not edges (ghosts don't path through them).
+// Built once per map and cached on the grid, so every session on a map
+// shares one; queries are const and safe from several threads. When a few
+// tiles change mid-game (a door toggled, a wall knocked out, a live reload)
+// the cached graph is repaired rather than rebuilt: only the squares holding
+// those tiles, and the neighbours across a border they sit on, redo their
+// walks; the rest keep their edges.
+class PathHierarchy
+{
+public:
+    static constexpr int CLUSTER = 16;       // tiles per square side
+    static constexpr int MIN_TILES = 64 * 64; // smaller boards: a plain BFS is cheaper
+    static constexpr int REPAIR_SHARE = 4;    // more than 1/4 of the squares touched: rebuild
+
+    static bool worthwhile(const Grid &grid) { return grid.getWidth() * grid.getHeight() >= MIN_TILES; }
+    static std::shared_ptr<const PathHierarchy> of(const Grid &grid);
+
+    explicit PathHierarchy(const Grid &grid);
+    // `old` (built on this board before) brought up to date after `changed`
+    // tiles were written.
+    PathHierarchy(const PathHierarchy &old, const Grid &grid, const std::vector<sf::Vector2i> &changed);
+
+    // First step of a near-shortest walk from `from` to `goal`, as a
+    // GhostDirection (0 UP, 1 DOWN, 2 LEFT, 3 RIGHT); -1 if there is none or
+    // from == goal. `grid` must be the map this was built for. Tiles and
+    // nodes looked at are added to *expanded.
+    int firstStep(const Grid &grid, sf::Vector2i from, sf::Vector2i goal, long *expanded = nullptr) const;
+    // The same, to the nearest ghost home: any GHOST_SPAWN tile, or `spawn`.
+    int firstStepHome(const Grid &grid, sf::Vector2i from, sf::Vector2i spawn, long *expanded = nullptr) const;
+
+    int getNodeCount() const { return static_cast<int>(nodes.size()); }
+    int getEdgeCount() const { return static_cast<int>(edges.size()); }
+    int getRebuiltSquares() const { return rebuiltSquares; } // squares walked when this was made
+    std::uint64_t getVersion() const { return version; }      // the grid's, when this was made
+
+private:
+    static constexpr int INF = std::numeric_limits<int>::max() / 4;
+
+    struct Node
+    {
+        sf::Vector2i tile;
+        int cluster;
+        int firstEdge, lastEdge; // into `edges`
+        int homeCost;            // in-square steps to a GHOST_SPAWN tile (INF if none)
+    };
+    struct Edge
+    {
+        int to;
+        int cost;
+    };
+
+    int width = 0;
+    int height = 0;
+    int clustersX = 0;
+    int clustersY = 0;
+    std::uint64_t version = 0;
+    int rebuiltSquares = 0;
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+    std::vector<int> clusterFirst; // nodes of square c: clusterNodes[clusterFirst[c] .. clusterFirst[c + 1])
+    std::vector<int> clusterNodes;
+    std::vector<int> homeNodes; // nodes with a finite homeCost
+    sf::Vector2i homeMin{0, 0}, homeMax{-1, -1}; // bounding box of the GHOST_SPAWN tiles
+
+    // Per-query scratch (one set per thread, so a shared hierarchy is fine).
+    struct Scratch
+    {
+        std::vector<int> local;       // in-square BFS distance per square cell
+        std::vector<int> goalLocal;   // ...from a goal, for seedGoal
+        std::vector<std::int8_t> via; // ...and the direction it was reached by
+        std::vector<int> queue;
+        std::vector<int> g, parent, goalCost;
+        std::vector<std::uint32_t> seen, goalSeen;
+        std::uint32_t stamp = 0;
+    };
+    static Scratch &scratch();
+
+    static bool walkable(const Grid &grid, int x, int y)
+    {
+        return grid.isValidPosition(x, y) && (!grid.isWall(x, y) || grid.isGhostDoor(x, y) || grid.isGhostSpawn(x, y));
+    }
+    int clusterOf(sf::Vector2i t) const { return (t.y / CLUSTER) * clustersX + t.x / CLUSTER; }
+    sf::Vector2i clusterOrigin(int c) const { return sf::Vector2i((c % clustersX) * CLUSTER, (c / clustersX) * CLUSTER); }
+
+    // BFS from `start` without leaving its square; distances (and the step
+    // each cell was reached by) land in `local`/`via`, indexed in-square.
+    // Returns the cells reached.
+    int squareBfs(const Grid &grid, sf::Vector2i start, std::vector<int> &local, std::vector<std::int8_t> *via,
+                  std::vector<int> &queue) const;
+
+    // A* over the nodes from `from` to whatever goalCost marks, or straight
+    // to `goal` (with `homes`, any home tile) inside the start's square.
+    // boxMin/boxMax bound every goal tile, for the heuristic.
+    int search(const Grid &grid, sf::Vector2i from, sf::Vector2i goal, bool homes, sf::Vector2i boxMin,
+               sf::Vector2i boxMax, Scratch &s, long *expanded) const;
+    void seedGoal(const Grid &grid, sf::Vector2i goal, Scratch &s, long *expanded) const;
+    void beginQuery(Scratch &s) const;
+
+    // Crossings, nodes and edges. With `old`, squares not marked in `redo`
+    // copy their home costs and in-square edges from it instead of walking.
+    void build(const Grid &grid, const PathHierarchy *old, const std::vector<char> &redo,
+               const std::vector<sf::Vector2i> &changed);
+};
+
+inline std::shared_ptr<const PathHierarchy> PathHierarchy::of(const Grid &grid)
+{
+    std::shared_ptr<const PathHierarchy> cached = std::atomic_load(&grid.pathHierarchy);
+    if (cached && cached->version == grid.getVersion())
+        return cached;
+    std::vector<sf::Vector2i> changed;
+    std::shared_ptr<const PathHierarchy> built;
+    if (cached && grid.cellsChangedSince(cached->version, changed))
+        built = std::make_shared<const PathHierarchy>(*cached, grid, changed);
+    else
+        built = std::make_shared<const PathHierarchy>(grid);
+    std::atomic_store(&grid.pathHierarchy, built);
+    return built;
+}
+
+inline PathHierarchy::Scratch &PathHierarchy::scratch()
+{
+    static thread_local Scratch s;
+    return s;
+}
+
+inline PathHierarchy::PathHierarchy(const Grid &grid)
+    : width(grid.getWidth()), height(grid.getHeight()), clustersX((grid.getWidth() + CLUSTER - 1) / CLUSTER),
+      clustersY((grid.getHeight() + CLUSTER - 1) / CLUSTER), version(grid.getVersion())
+{
+    build(grid, nullptr, std::vector<char>(static_cast<std::size_t>(clustersX) * clustersY, 1), {});
+}
+
+inline PathHierarchy::PathHierarchy(const PathHierarchy &old, const Grid &grid, const std::vector<sf::Vector2i> &changed)
+    : width(grid.getWidth()), height(grid.getHeight()), clustersX((grid.getWidth() + CLUSTER - 1) / CLUSTER),
+      clustersY((grid.getHeight() + CLUSTER - 1) / CLUSTER), version(grid.getVersion())
+{
+    // A tile's square redoes its walks; so does the square across a border
+    // the tile sits on, whose crossings may have moved.
+    std::vector<char> redo(static_cast<std::size_t>(clustersX) * clustersY, 0);
+    int marked = 0;
+    auto mark = [&](int x, int y)
+    {
+        if (x < 0 || y < 0 || x >= width || y >= height)
+            return;
+        char &r = redo[clusterOf(sf::Vector2i(x, y))];
+        marked += !r;
+        r = 1;
+    };
+    for (const sf::Vector2i &t : changed)
+    {
+        mark(t.x, t.y);
+        if (t.x % CLUSTER == 0)
+            mark(t.x - 1, t.y);
+        if (t.x % CLUSTER == CLUSTER - 1)
+            mark(t.x + 1, t.y);
+        if (t.y % CLUSTER == 0)
+            mark(t.x, t.y - 1);
+        if (t.y % CLUSTER == CLUSTER - 1)
+            mark(t.x, t.y + 1);
+    }
+    const bool sameBoard = old.width == width && old.height == height;
+    if (!sameBoard || marked * REPAIR_SHARE > clustersX * clustersY)
+    {
+        build(grid, nullptr, std::vector<char>(redo.size(), 1), {}); // too much changed: start over
+        return;
+    }
+    build(grid, &old, redo, changed);
+}
+
+inline void PathHierarchy::build(const Grid &grid, const PathHierarchy *old, const std::vector<char> &redo,
+                                 const std::vector<sf::Vector2i> &changed)
+{
+    // Crossings: maximal runs of tiles open on both sides of a square border.
+    // Only a tile next to a square corner can sit on a crossing of both a
+    // side-by-side and an over-and-under border, so only those are looked up.
+    std::unordered_map<int, int> cornerNodes; // tile -> node
+    std::vector<std::pair<int, int>> links;
+    auto nearEdge = [](int v) { return v % CLUSTER == 0 || v % CLUSTER == CLUSTER - 1; };
+    auto nodeFor = [&](int x, int y)
+    {
+        const bool corner = nearEdge(x) && nearEdge(y);
+        if (corner)
+        {
+            auto found = cornerNodes.find(y * width + x);
+            if (found != cornerNodes.end())
+                return found->second;
+        }
+        int id = static_cast<int>(nodes.size());
+        nodes.push_back(Node{sf::Vector2i(x, y), clusterOf(sf::Vector2i(x, y)), 0, 0, INF});
+        if (corner)
+            cornerNodes[y * width + x] = id;
+        return id;
+    };
+    auto addRun = [&](int a, int b, bool vertical, int line)
+    {
+        // A short run gets one crossing in its middle; a long one, one at each end.
+        int picks[2] = {(a + b) / 2, -1};
+        if (b - a + 1 >= 6)
+        {
+            picks[0] = a;
+            picks[1] = b;
+        }
+        for (int p : picks)
+        {
+            if (p < 0)
+                continue;
+            int n1 = vertical ? nodeFor(line, p) : nodeFor(p, line);
+            int n2 = vertical ? nodeFor(line + 1, p) : nodeFor(p, line + 1);
+            links.emplace_back(n1, n2);
+        }
+    };
+    for (int x = CLUSTER - 1; x + 1 < width; x += CLUSTER) // borders between squares side by side
+    {
+        int runStart = -1;
+        for (int y = 0; y <= height; ++y)
+        {
+            bool continues = y < height && walkable(grid, x, y) && walkable(grid, x + 1, y);
+            if (runStart >= 0 && (!continues || y % CLUSTER == 0))
+            {
+                addRun(runStart, y - 1, true, x); // runs stop at square corners too
+                runStart = -1;
+            }
+            if (runStart < 0 && continues)
+                runStart = y;
+        }
+    }
+    for (int y = CLUSTER - 1; y + 1 < height; y += CLUSTER) // borders between squares one above the other
+    {
+        int runStart = -1;
+        for (int x = 0; x <= width; ++x)
+        {
+            bool continues = x < width && walkable(grid, x, y) && walkable(grid, x, y + 1);
+            if (runStart >= 0 && (!continues || x % CLUSTER == 0))
+            {
+                addRun(runStart, x - 1, false, y);
+                runStart = -1;
+            }
+            if (runStart < 0 && continues)
+                runStart = x;
+        }
+    }
+
+    // Nodes by square.
+    const int clusters = clustersX * clustersY;
+    clusterFirst.assign(clusters + 1, 0);
+    for (const Node &n : nodes)
+        ++clusterFirst[n.cluster + 1];
+    for (int c = 0; c < clusters; ++c)
+        clusterFirst[c + 1] += clusterFirst[c];
+    clusterNodes.resize(nodes.size());
+    std::vector<int> fill(clusterFirst.begin(), clusterFirst.end() - 1);
+    for (int i = 0; i < static_cast<int>(nodes.size()); ++i)
+        clusterNodes[fill[nodes[i].cluster]++] = i;
+
+    // With an old graph, the squares that keep theirs: their nodes are the
+    // same tiles in the same order as before, so match them up by position
+    // (and walk a square again if they somehow don't line up).
+    std::vector<char> walk(redo);
+    std::vector<int> oldToNew;
+    if (old)
+    {
+        oldToNew.assign(old->nodes.size(), -1);
+        for (int c = 0; c < clusters; ++c)
+        {
+            if (walk[c])
+                continue;
+            const int count = clusterFirst[c + 1] - clusterFirst[c];
+            bool lined = count == old->clusterFirst[c + 1] - old->clusterFirst[c];
+            for (int k = 0; lined && k < count; ++k)
+                lined = nodes[clusterNodes[clusterFirst[c] + k]].tile == old->nodes[old->clusterNodes[old->clusterFirst[c] + k]].tile;
+            if (!lined)
+            {
+                walk[c] = 1;
+                continue;
+            }
+            for (int k = 0; k < count; ++k)
+                oldToNew[old->clusterNodes[old->clusterFirst[c] + k]] = clusterNodes[clusterFirst[c] + k];
+        }
+    }
+
+    // Home tiles: their bounding box (the A* heuristic) and, per square that
+    // has some, every node's distance to the nearest (a multi-source BFS).
+    // A repair grows the old box by any new home tile; a box a little too
+    // big only makes the heuristic weaker, never wrong.
+    std::vector<std::vector<sf::Vector2i>> homesIn(clusters);
+    auto addHome = [&](const sf::Vector2i &h)
+    {
+        if (homeMax.x < homeMin.x)
+            homeMin = homeMax = h;
+        homeMin = sf::Vector2i(std::min(homeMin.x, h.x), std::min(homeMin.y, h.y));
+        homeMax = sf::Vector2i(std::max(homeMax.x, h.x), std::max(homeMax.y, h.y));
+    };
+    if (old)
+    {
+        homeMin = old->homeMin;
+        homeMax = old->homeMax;
+        for (const sf::Vector2i &t : changed)
+            if (grid.isGhostSpawn(t.x, t.y))
+                addHome(t);
+        for (int c = 0; c < clusters; ++c)
+        {
+            if (!walk[c])
+                continue;
+            const sf::Vector2i o = clusterOrigin(c);
+            for (int y = o.y; y < std::min(o.y + CLUSTER, height); ++y)
+                for (int x = o.x; x < std::min(o.x + CLUSTER, width); ++x)
+                    if (grid.isGhostSpawn(x, y))
+                        homesIn[c].emplace_back(x, y);
+        }
+    }
+    else
+    {
+        for (const sf::Vector2i &h : grid.findTiles(GHOST_SPAWN))
+        {
+            addHome(h);
+            homesIn[clusterOf(h)].push_back(h);
+        }
+    }
+
+    std::vector<int> local(CLUSTER * CLUSTER), queue(CLUSTER * CLUSTER);
+    for (int c = 0; c < clusters; ++c)
+    {
+        if (!walk[c])
+        {
+            for (int k = old->clusterFirst[c]; k < old->clusterFirst[c + 1]; ++k)
+                nodes[oldToNew[old->clusterNodes[k]]].homeCost = old->nodes[old->clusterNodes[k]].homeCost;
+            continue;
+        }
+        ++rebuiltSquares;
+        if (homesIn[c].empty())
+            continue;
+        const sf::Vector2i o = clusterOrigin(c);
+        std::fill(local.begin(), local.end(), INF);
+        int head = 0, tail = 0;
+        for (const sf::Vector2i &h : homesIn[c])
+        {
+            int li = (h.y - o.y) * CLUSTER + (h.x - o.x);
+            local[li] = 0;
+            queue[tail++] = li;
+        }
+        while (head < tail)
+        {
+            int li = queue[head++];
+            int x = o.x + li % CLUSTER, y = o.y + li / CLUSTER;
+            static const int dx[4] = {0, 0, -1, 1};
+            static const int dy[4] = {-1, 1, 0, 0};
+            for (int d = 0; d < 4; ++d)
+            {
+                int nx = x + dx[d], ny = y + dy[d];
+                if (nx < o.x || ny < o.y || nx >= o.x + CLUSTER || ny >= o.y + CLUSTER || !walkable(grid, nx, ny))
+                    continue;
+                int ni = (ny - o.y) * CLUSTER + (nx - o.x);
+                if (local[ni] != INF)
+                    continue;
+                local[ni] = local[li] + 1;
+                queue[tail++] = ni;
+            }
+        }
+        for (int k = clusterFirst[c]; k < clusterFirst[c + 1]; ++k)
+        {
+            Node &n = nodes[clusterNodes[k]];
+            n.homeCost = local[(n.tile.y - o.y) * CLUSTER + (n.tile.x - o.x)];
+        }
+    }
+    for (int c = 0; c < clusters; ++c)
+        for (int k = clusterFirst[c]; k < clusterFirst[c + 1]; ++k)
+            if (nodes[clusterNodes[k]].homeCost != INF)
+                homeNodes.push_back(clusterNodes[k]);
+
+    // Edges, node by node: its crossings, then the in-square distances to
+    // the other nodes of its square (copied, in the same order, for a square
+    // that kept its nodes).
+    std::vector<int> linkFirst(nodes.size() + 1, 0), linkTo(links.size() * 2);
+    for (const auto &link : links)
+    {
+        ++linkFirst[link.first + 1];
+        ++linkFirst[link.second + 1];
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        linkFirst[i + 1] += linkFirst[i];
+    std::vector<int> linkFill(linkFirst.begin(), linkFirst.end() - 1);
+    for (const auto &link : links)
+    {
+        linkTo[linkFill[link.first]++] = link.second;
+        linkTo[linkFill[link.second]++] = link.first;
+    }
+
+    std::vector<int> oldNode(old ? nodes.size() : 0, -1); // new -> old, kept squares only
+    for (std::size_t i = 0; i < oldToNew.size(); ++i)
+        if (oldToNew[i] >= 0)
+            oldNode[oldToNew[i]] = static_cast<int>(i);
+    edges.reserve(old ? old->edges.size() : links.size() * 2);
+    for (int i = 0; i < static_cast<int>(nodes.size()); ++i)
+    {
+        nodes[i].firstEdge = static_cast<int>(edges.size());
+        for (int k = linkFirst[i]; k < linkFirst[i + 1]; ++k)
+            edges.push_back(Edge{linkTo[k], 1});
+
+        const int c = nodes[i].cluster;
+        if (!walk[c])
+        {
+            const Node &was = old->nodes[oldNode[i]];
+            for (int e = was.firstEdge; e < was.lastEdge; ++e)
+            {
+                const Edge &edge = old->edges[e];
+                if (old->nodes[edge.to].cluster == c)
+                    edges.push_back(Edge{oldToNew[edge.to], edge.cost});
+            }
+        }
+        else
+        {
+            squareBfs(grid, nodes[i].tile, local, nullptr, queue);
+            const sf::Vector2i o = clusterOrigin(c);
+            for (int k = clusterFirst[c]; k < clusterFirst[c + 1]; ++k)
+            {
+                int j = clusterNodes[k];
+                int d = local[(nodes[j].tile.y - o.y) * CLUSTER + (nodes[j].tile.x - o.x)];
+                if (j != i && d != INF)
+                    edges.push_back(Edge{j, d});
+            }
+        }
+        nodes[i].lastEdge = static_cast<int>(edges.size());
+    }
+}
+
+inline int PathHierarchy::squareBfs(const Grid &grid, sf::Vector2i start, std::vector<int> &local,
+                                    std::vector<std::int8_t> *via, std::vector<int> &queue) const
+{
+    static const int dx[4] = {0, 0, -1, 1}; // UP, DOWN, LEFT, RIGHT
+    static const int dy[4] = {-1, 1, 0, 0};
+    const sf::Vector2i o = clusterOrigin(clusterOf(start));
+    local.assign(CLUSTER * CLUSTER, INF);
+    queue.resize(CLUSTER * CLUSTER);
+    if (via)
+        via->assign(CLUSTER * CLUSTER, -1);
+    int head = 0, tail = 0;
+    int si = (start.y - o.y) * CLUSTER + (start.x - o.x);
+    local[si] = 0;
+    queue[tail++] = si;
+    while (head < tail)
+    {
+        int li = queue[head++];
+        int x = o.x + li % CLUSTER, y = o.y + li / CLUSTER;
+        for (int d = 0; d < 4; ++d)
+        {
+            int nx = x + dx[d], ny = y + dy[d];
+            if (nx < o.x || ny < o.y || nx >= o.x + CLUSTER || ny >= o.y + CLUSTER || !walkable(grid, nx, ny))
+                continue;
+            int ni = (ny - o.y) * CLUSTER + (nx - o.x);
+            if (local[ni] != INF)
+                continue;
+            local[ni] = local[li] + 1;
+            if (via)
+                (*via)[ni] = static_cast<std::int8_t>(d);
+            queue[tail++] = ni;
+        }
+    }
+    return tail;
+}
+
+inline void PathHierarchy::beginQuery(Scratch &s) const
+{
+    if (s.g.size() != nodes.size())
+    {
+        s.g.assign(nodes.size(), INF);
+        s.parent.assign(nodes.size(), -1);
+        s.goalCost.assign(nodes.size(), INF);
+        s.seen.assign(nodes.size(), 0);
+        s.goalSeen.assign(nodes.size(), 0);
+        s.stamp = 0;
+    }
+    if (++s.stamp == 0) // wrapped: clear old stamps
+    {
+        std::fill(s.seen.begin(), s.seen.end(), 0);
+        std::fill(s.goalSeen.begin(), s.goalSeen.end(), 0);
+        s.stamp = 1;
+    }
+}
+
+// Mark the nodes of the goal's square with their distance to it (kept
+// alongside any goal costs already marked in this query).
+inline void PathHierarchy::seedGoal(const Grid &grid, sf::Vector2i goal, Scratch &s, long *expanded) const
+{
+    std::vector<int> &local = s.goalLocal;
+    int reached = squareBfs(grid, goal, local, nullptr, s.queue);
+    if (expanded)
+        *expanded += reached;
+    const int c = clusterOf(goal);
+    const sf::Vector2i o = clusterOrigin(c);
+    for (int k = clusterFirst[c]; k < clusterFirst[c + 1]; ++k)
+    {
+        int n = clusterNodes[k];
+        int d = local[(nodes[n].tile.y - o.y) * CLUSTER + (nodes[n].tile.x - o.x)];
+        if (d == INF)
+            continue;
+        if (s.goalSeen[n] != s.stamp || d < s.goalCost[n])
+            s.goalCost[n] = d;
+        s.goalSeen[n] = s.stamp;
+    }
+}
+
+inline int PathHierarchy::firstStep(const Grid &grid, sf::Vector2i from, sf::Vector2i goal, long *expanded) const
+{
+    if (from == goal || !grid.isValidPosition(from.x, from.y) || !grid.isValidPosition(goal.x, goal.y))
+        return -1;
+    Scratch &s = scratch();
+    beginQuery(s);
+    seedGoal(grid, goal, s, expanded);
+    return search(grid, from, goal, false, goal, goal, s, expanded);
+}
+
+inline int PathHierarchy::firstStepHome(const Grid &grid, sf::Vector2i from, sf::Vector2i spawn, long *expanded) const
+{
+    if (!grid.isValidPosition(from.x, from.y) || grid.isGhostSpawn(from.x, from.y) || from == spawn)
+        return -1;
+    Scratch &s = scratch();
+    beginQuery(s);
+    for (int n : homeNodes)
+    {
+        s.goalCost[n] = nodes[n].homeCost;
+        s.goalSeen[n] = s.stamp;
+    }
+    sf::Vector2i boxMin = homeMin, boxMax = homeMax;
+    if (grid.isValidPosition(spawn.x, spawn.y) && !grid.isGhostSpawn(spawn.x, spawn.y))
+    {
+        seedGoal(grid, spawn, s, expanded);
+        if (boxMax.x < boxMin.x)
+            boxMin = boxMax = spawn;
+        boxMin = sf::Vector2i(std::min(boxMin.x, spawn.x), std::min(boxMin.y, spawn.y));
+        boxMax = sf::Vector2i(std::max(boxMax.x, spawn.x), std::max(boxMax.y, spawn.y));
+    }
+    if (boxMax.x < boxMin.x)
+        return -1; // no home anywhere
+
+    return search(grid, from, spawn, true, boxMin, boxMax, s, expanded);
+}
+
+inline int PathHierarchy::search(const Grid &grid, sf::Vector2i from, sf::Vector2i goal, bool homes,
+                                 sf::Vector2i boxMin, sf::Vector2i boxMax, Scratch &s, long *expanded) const
+{
+    // Walk the start's square: distances to its nodes and to any goal in it.
+    const int startCluster = clusterOf(from);
+    const sf::Vector2i o = clusterOrigin(startCluster);
+    int reached = squareBfs(grid, from, s.local, &s.via, s.queue);
+    if (expanded)
+        *expanded += reached;
+    auto localOf = [&](sf::Vector2i t) { return (t.y - o.y) * CLUSTER + (t.x - o.x); };
+    auto inStart = [&](sf::Vector2i t)
+    { return t.x >= o.x && t.y >= o.y && t.x < o.x + CLUSTER && t.y < o.y + CLUSTER; };
+
+    // Goals inside the start's square, reached without leaving it: the goal
+    // tile itself, or (going home) the nearest home tile. BFS order is
+    // nearest first.
+    int direct = INF;
+    sf::Vector2i directGoal = goal;
+    for (int k = 0; k < reached; ++k)
+    {
+        int li = s.queue[k];
+        sf::Vector2i t(o.x + li % CLUSTER, o.y + li / CLUSTER);
+        if (t == goal || (homes && grid.isGhostSpawn(t.x, t.y)))
+        {
+            direct = s.local[li];
+            directGoal = t;
+            break;
+        }
+    }
+
+    auto heuristic = [&](sf::Vector2i t)
+    {
+        int hx = t.x < boxMin.x ? boxMin.x - t.x : (t.x > boxMax.x ? t.x - boxMax.x : 0);
+        int hy = t.y < boxMin.y ? boxMin.y - t.y : (t.y > boxMax.y ? t.y - boxMax.y : 0);
+        return hx + hy;
+    };
+
+    using Item = std::pair<int, int>; // (f, node)
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+    for (int k = clusterFirst[startCluster]; k < clusterFirst[startCluster + 1]; ++k)
+    {
+        int n = clusterNodes[k];
+        int d = s.local[localOf(nodes[n].tile)];
+        if (d == INF)
+            continue;
+        s.g[n] = d;
+        s.parent[n] = -1;
+        s.seen[n] = s.stamp;
+        open.push(Item(d + heuristic(nodes[n].tile), n));
+    }
+
+    int best = direct;
+    int bestNode = -1;
+    while (!open.empty())
+    {
+        Item top = open.top();
+        open.pop();
+        int n = top.second;
+        if (top.first >= best)
+            break; // nothing left can beat what is found
+        if (top.first > s.g[n] + heuristic(nodes[n].tile))
+            continue; // stale entry
+        if (expanded)
+            ++*expanded;
+        if (s.goalSeen[n] == s.stamp && s.g[n] + s.goalCost[n] < best)
+        {
+            best = s.g[n] + s.goalCost[n];
+            bestNode = n;
+        }
+        for (int e = nodes[n].firstEdge; e < nodes[n].lastEdge; ++e)
+        {
+            int m = edges[e].to;
+            int g = s.g[n] + edges[e].cost;
+            if (s.seen[m] == s.stamp && g >= s.g[m])
+                continue;
+            s.seen[m] = s.stamp;
+            s.g[m] = g;
+            s.parent[m] = n;
+            open.push(Item(g + heuristic(nodes[m].tile), m));
+        }
+    }
+    if (best == INF)
+        return -1;
+
+    // Where the path first heads: the goal in this square, or the first node
+    // on the abstract path that isn't the start tile itself.
+    sf::Vector2i waypoint = directGoal;
+    if (bestNode >= 0)
+    {
+        std::vector<int> path;
+        for (int n = bestNode; n >= 0; n = s.parent[n])
+            path.push_back(n);
+        std::reverse(path.begin(), path.end());
+        std::size_t i = 0;
+        while (i + 1 < path.size() && nodes[path[i]].tile == from)
+            ++i;
+        waypoint = nodes[path[i]].tile;
+        if (waypoint == from)
+            return -1;
+        if (!inStart(waypoint)) // across the border from a start that is a node
+        {
+            sf::Vector2i d = waypoint - from;
+            return d.y < 0 ? 0 : (d.y > 0 ? 1 : (d.x < 0 ? 2 : 3));
+        }
+    }
+
+    // Back along the square walk to the step taken out of `from`.
+    static const int dx[4] = {0, 0, -1, 1};
+    static const int dy[4] = {-1, 1, 0, 0};
+    sf::Vector2i t = waypoint;
+    int step = -1;
+    while (t != from)
+    {
+        step = s.via[localOf(t)];
+        if (step < 0)
+            return -1;
+        t = sf::Vector2i(t.x - dx[step], t.y - dy[step]);
+    }
+    return step;
+}
+
+#endif // PATHHIERARCHY_H
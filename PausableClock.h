@@ -8,23 +8,54 @@
 // game time can be frozen for a pause menu and continue seamlessly afterwards.
 //
 // How it works: `base` banks the un-paused time accumulated before the current
-// running segment; while running, elapsed = base + (time since last resume).
+// running segment; while running, elapsed = base + (now() - start).
+//
+// now() is the wall clock unless a SimulatedTime is installed on this thread:
+// headless games (GameSession) run on their own simulated time so they can go
+// faster than real time, and so a forked copy of a game keeps consistent timers.
 class PausableClock
 {
-    sf::Clock clock;                // measures time since the last restart/resume
+    sf::Time start = now();         // now() at the last restart/resume
     sf::Time base = sf::Time::Zero; // un-paused time banked before this segment
     bool running = true;
 
+    static const sf::Time *&simulated()
+    {
+        static thread_local const sf::Time *source = nullptr;
+        return source;
+    }
+
 public:
+    // Current game time: the installed simulated time, or seconds since startup.
+    static sf::Time now()
+    {
+        if (const sf::Time *sim = simulated())
+            return *sim;
+        static const sf::Clock wall; // first use starts the wall-clock epoch
+        return wall.getElapsedTime();
+    }
+
+    // While alive, clocks on this thread read `time` instead of the wall clock.
+    class SimulatedTime
+    {
+        const sf::Time *previous;
+
+    public:
+        explicit SimulatedTime(const sf::Time &time) : previous(simulated()) { simulated() = &time; }
+        ~SimulatedTime() { simulated() = previous; }
+        SimulatedTime(const SimulatedTime &) = delete;
+        SimulatedTime &operator=(const SimulatedTime &) = delete;
+    };
+
     sf::Time getElapsedTime() const
     {
-        return running ? base + clock.getElapsedTime() : base;
+        return running ? base + (now() - start) : base;
     }
 
     void restart()
     {
         base = sf::Time::Zero;
-        clock.restart();
+        start = now();
         running = true;
     }
 
@@ -32,7 +63,7 @@ public:
     {
         if (running)
         {
-            base += clock.getElapsedTime(); // bank what has run so far, then stop
+            base += now() - start; // bank what has run so far, then stop
             running = false;
         }
     }
@@ -41,7 +72,7 @@ public:
     {
         if (!running)
         {
-            clock.restart(); // future elapsed is measured from now, added onto base
+            start = now(); // future elapsed is measured from now, added onto base
             running = true;
         }
     }
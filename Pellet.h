@@ -28,13 +28,18 @@ private:
 
 public:
     // Constructor
-    Pellet(int x, int y, PelletType pelletType, const SpriteSheet &sheetRef);
+    Pellet(int x, int y, PelletType pelletType, const SpriteSheet *sheetPtr); // null sheet = headless (no sprite frames)
 
     // Methods
     void setType(PelletType pelletType);
     bool isCollected() const { return collected; }
     void collect() { collected = true; }
     void reset() { collected = false; }
+    void setPosition(int x, int y)
+    {
+        position = sf::Vector2i(x, y);
+        sprite.setPosition(x * GameConfig::CELL_SIZE, y * GameConfig::CELL_SIZE);
+    }
 
     // Getters
     sf::Vector2i getPosition() const { return position; }
@@ -47,8 +52,8 @@ public:
 };
 
 // Constructor implementation for pellet, power pellet, and fruit types
-inline Pellet::Pellet(int x, int y, PelletType pelletType, const SpriteSheet &sheetRef)
-    : position(x, y), type(pelletType), sheet(&sheetRef), collected(false)
+inline Pellet::Pellet(int x, int y, PelletType pelletType, const SpriteSheet *sheetPtr)
+    : position(x, y), type(pelletType), sheet(sheetPtr), collected(false)
 {
     setType(pelletType);
     sprite.setPosition(x * GameConfig::CELL_SIZE, y * GameConfig::CELL_SIZE);
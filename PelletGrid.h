@@ -1,85 +1,253 @@
 #ifndef PELLETGRID_H
 #define PELLETGRID_H
 
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
 #include <vector>
-#define PELLETGRID_H
-
-#include <vector>
+#include <SFML/System.hpp>
 #include "GameConfig.h"
 #include "Grid.h"
+#include "Zobrist.h"
+
+// Where a map's pellets and power pellets start, numbered: read-only and
+// shared by every PelletGrid on that map (hundreds of simulations in one
+// process share one copy). Each kind is a bitmap over the board's cells plus
+// a running count per 64-cell word, so a cell's pellet number is one popcount
+// away, and the slot -> cell table lets a PelletGrid list what it holds.
+class PelletLayout
+{
+public:
+    struct CellSet
+    {
+        std::vector<std::uint64_t> bits; // bit per cell (row-major)
+        std::vector<std::uint32_t> rank; // set bits before each word
+        std::vector<std::int32_t> cells; // slot -> cell index
+        std::uint64_t hash = 0;          // Zobrist keys of every cell in the set
+        int count() const { return static_cast<int>(cells.size()); }
+
+        // Slot number of a cell, or -1 if the set doesn't hold it.
+        int slotOf(int cell) const
+        {
+            std::uint64_t word = bits[cell >> 6];
+            std::uint64_t bit = 1ULL << (cell & 63);
+            if (!(word & bit))
+                return -1;
+            return static_cast<int>(rank[cell >> 6]) + __builtin_popcountll(word & (bit - 1));
+        }
+    };
+
+    int width = 0;
+    int height = 0;
+    CellSet pellets;
+    CellSet powerPellets;
+
+    // From row-major cell indices, ascending.
+    PelletLayout(int w, int h, const std::vector<std::int32_t> &pelletCells, const std::vector<std::int32_t> &powerCells);
+
+    // The layout of `grid`'s PELLET / POWER_PELLET flags, built once per map
+    // version and cached on the grid (any cell write drops it). Safe to call
+    // from several threads on a shared const Grid.
+    static std::shared_ptr<const PelletLayout> of(const Grid &grid);
+
+private:
+    static void fill(CellSet &set, ZobristFeature kind, int cellCount, const std::vector<std::int32_t> &cells);
+};
+
+inline PelletLayout::PelletLayout(int w, int h, const std::vector<std::int32_t> &pelletCells,
+                                  const std::vector<std::int32_t> &powerCells)
+    : width(w), height(h)
+{
+    fill(pellets, ZobristFeature::PELLET, w * h, pelletCells);
+    fill(powerPellets, ZobristFeature::POWER_PELLET, w * h, powerCells);
+}
+
+inline void PelletLayout::fill(CellSet &set, ZobristFeature kind, int cellCount, const std::vector<std::int32_t> &cells)
+{
+    std::size_t words = (static_cast<std::size_t>(cellCount) + 63) / 64;
+    set.bits.assign(words, 0);
+    set.rank.assign(words, 0);
+    set.cells = cells;
+    set.hash = 0;
+    for (std::int32_t c : cells)
+    {
+        set.bits[c >> 6] |= 1ULL << (c & 63);
+        set.hash ^= zobristKey(kind, static_cast<std::uint64_t>(c));
+    }
+    std::uint32_t total = 0;
+    for (std::size_t i = 0; i < words; ++i)
+    {
+        set.rank[i] = total;
+        total += static_cast<std::uint32_t>(__builtin_popcountll(set.bits[i]));
+    }
+}
+
+inline std::shared_ptr<const PelletLayout> PelletLayout::of(const Grid &grid)
+{
+    if (std::shared_ptr<const PelletLayout> cached = std::atomic_load(&grid.pelletLayout))
+        return cached;
 
-// PelletGrid manages pellet and power pellet locations based on Grid flags (from PNG)
+    // Uniform chunks and a still-mapped compiled map answer findTiles without
+    // visiting every cell.
+    std::vector<std::int32_t> pelletCells, powerCells;
+    for (const sf::Vector2i &p : grid.findTiles(PELLET))
+        pelletCells.push_back(p.y * grid.getWidth() + p.x);
+    for (const sf::Vector2i &p : grid.findTiles(POWER_PELLET))
+        powerCells.push_back(p.y * grid.getWidth() + p.x);
+    auto layout = std::make_shared<const PelletLayout>(grid.getWidth(), grid.getHeight(), pelletCells, powerCells);
+    std::atomic_store(&grid.pelletLayout, std::shared_ptr<const PelletLayout>(layout));
+    return layout;
+}
+
+// PelletGrid manages pellet and power pellet locations based on Grid flags (from PNG).
+// The layout is shared (PelletLayout); a game only owns a bit per pellet saying
+// whether it is still there, so a copy (GameSession::fork) is a few hundred bytes.
 class PelletGrid
 {
 private:
-    std::vector<std::vector<bool>> pellets;
-    std::vector<std::vector<bool>> powerPellets;
+    std::shared_ptr<const PelletLayout> layout;
+    std::vector<std::uint64_t> pellets;      // bit per layout slot: still there
+    std::vector<std::uint64_t> powerPellets; // ...and for the power pellets
     int width;
     int height;
+    int pelletCount = 0;      // running totals, so the per-frame "level clear?"
+    int powerPelletCount = 0; // check is O(1) instead of a full-board scan
+    std::uint64_t hash = 0;   // Zobrist keys of what is still on the board
+
+    // Change journal for incremental readers (PlaneEncoder): every cell whose
+    // pellet state changed since this board was built, in order. A rebuilt
+    // board gets a new generation, so readers know to start over.
+    std::vector<sf::Vector2i> changes;
+    std::uint64_t generation;
+
+    static std::uint64_t nextGeneration()
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+
+    static bool test(const std::vector<std::uint64_t> &bits, int slot) { return bits[slot >> 6] >> (slot & 63) & 1; }
+    static void flip(std::vector<std::uint64_t> &bits, int slot) { bits[slot >> 6] ^= 1ULL << (slot & 63); }
+
+    // Set one kind at one cell; true if that changed it.
+    bool assign(bool power, int x, int y, bool has);
+    // A pellet where the layout has none (live reload, dev edits): move to a
+    // private layout of what is on the board now, plus that cell.
+    void rebase(bool power, int cell);
 
 public:
     PelletGrid(const Grid &grid)
+        : layout(PelletLayout::of(grid)), width(grid.getWidth()), height(grid.getHeight()), generation(nextGeneration())
     {
-        width = grid.getWidth();
-        height = grid.getHeight();
-        pellets.resize(height, std::vector<bool>(width, false));
-        powerPellets.resize(height, std::vector<bool>(width, false));
-        for (int y = 0; y < height; ++y)
-        {
-            for (int x = 0; x < width; ++x)
-            {
-                if (grid.hasFlag(x, y, PELLET))
-                    pellets[y][x] = true;
-                if (grid.hasFlag(x, y, POWER_PELLET))
-                    powerPellets[y][x] = true;
-            }
-        }
+        pelletCount = layout->pellets.count();
+        powerPelletCount = layout->powerPellets.count();
+        hash = layout->pellets.hash ^ layout->powerPellets.hash;
+        pellets.assign((pelletCount + 63) / 64, ~0ULL);
+        powerPellets.assign((powerPelletCount + 63) / 64, ~0ULL);
     }
 
     bool hasPellet(int x, int y) const // Check if there's a pellet at (x, y)
     {
-        return isValidPosition(x, y) ? pellets[y][x] : false;
+        if (!isValidPosition(x, y))
+            return false;
+        int slot = layout->pellets.slotOf(y * width + x);
+        return slot >= 0 && test(pellets, slot);
     }
     bool hasPowerPellet(int x, int y) const // Check if there's a power pellet at (x, y)
     {
-        return isValidPosition(x, y) ? powerPellets[y][x] : false;
+        if (!isValidPosition(x, y))
+            return false;
+        int slot = layout->powerPellets.slotOf(y * width + x);
+        return slot >= 0 && test(powerPellets, slot);
     }
     void setPellet(int x, int y, bool has) // Set or clear a pellet at (x, y)
     {
-        if (isValidPosition(x, y))
-            pellets[y][x] = has;
+        if (isValidPosition(x, y) && assign(false, x, y, has))
+            changes.emplace_back(x, y);
     }
     void setPowerPellet(int x, int y, bool has) // Set or clear a power pellet at (x, y)
     {
         if (isValidPosition(x, y))
         {
-            powerPellets[y][x] = has;
+            if (assign(true, x, y, has))
+                changes.emplace_back(x, y);
             if (has)
-                pellets[y][x] = false;
+                setPellet(x, y, false);
         }
     }
+    // Re-read one cell from the map (live reload): pellets appear or vanish
+    // with the tile, while untouched cells keep their eaten/uneaten state.
+    void refreshCell(const Grid &grid, int x, int y)
+    {
+        if (!isValidPosition(x, y))
+            return;
+        bool pellet = assign(false, x, y, grid.hasFlag(x, y, PELLET));
+        bool power = assign(true, x, y, grid.hasFlag(x, y, POWER_PELLET));
+        if (pellet || power)
+            changes.emplace_back(x, y);
+    }
     bool isValidPosition(int x, int y) const // Check if (x, y) is within grid bounds
     {
         return (x >= 0 && x < width && y >= 0 && y < height);
     }
     int countPellets() const // Count total pellets
     {
-        int count = 0;
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                if (pellets[y][x])
-                    ++count;
-        return count;
+        return pelletCount;
     }
     int countPowerPellets() const // Count total power pellets
     {
-        int count = 0;
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                if (powerPellets[y][x])
-                    ++count;
-        return count;
+        return powerPelletCount;
     }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    std::uint64_t getGeneration() const { return generation; }
+    // Zobrist hash of the pellets still on the board (Zobrist.h), kept up to
+    // date on every change: part of GameSession::getHash.
+    std::uint64_t getHash() const { return hash; }
+    const std::vector<sf::Vector2i> &getChanges() const { return changes; }
+    const PelletLayout &getLayout() const { return *layout; }
 };
 
-#endif // PELLETGRID_H
\ No newline at end of file
+inline bool PelletGrid::assign(bool power, int x, int y, bool has)
+{
+    const int cell = y * width + x;
+    const ZobristFeature kind = power ? ZobristFeature::POWER_PELLET : ZobristFeature::PELLET;
+    int slot = (power ? layout->powerPellets : layout->pellets).slotOf(cell);
+    if (slot < 0)
+    {
+        if (!has)
+            return false; // nothing there to clear
+        rebase(power, cell);
+        hash ^= zobristKey(kind, static_cast<std::uint64_t>(cell));
+        return true;
+    }
+    std::vector<std::uint64_t> &bits = power ? powerPellets : pellets;
+    if (test(bits, slot) == has)
+        return false;
+    flip(bits, slot);
+    hash ^= zobristKey(kind, static_cast<std::uint64_t>(cell));
+    (power ? powerPelletCount : pelletCount) += has ? 1 : -1;
+    return true;
+}
+
+inline void PelletGrid::rebase(bool power, int cell)
+{
+    std::vector<std::int32_t> pelletCells, powerCells;
+    for (int s = 0; s < layout->pellets.count(); ++s)
+        if (test(pellets, s))
+            pelletCells.push_back(layout->pellets.cells[s]);
+    for (int s = 0; s < layout->powerPellets.count(); ++s)
+        if (test(powerPellets, s))
+            powerCells.push_back(layout->powerPellets.cells[s]);
+
+    std::vector<std::int32_t> &added = power ? powerCells : pelletCells;
+    added.insert(std::upper_bound(added.begin(), added.end(), cell), cell);
+    (power ? powerPelletCount : pelletCount) += 1;
+
+    layout = std::make_shared<const PelletLayout>(width, height, pelletCells, powerCells);
+    pellets.assign((layout->pellets.count() + 63) / 64, ~0ULL);
+    powerPellets.assign((layout->powerPellets.count() + 63) / 64, ~0ULL);
+}
+
+#endif // PELLETGRID_H
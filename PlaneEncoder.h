@@ -0,0 +1,186 @@
+#ifndef PLANEENCODER_H
+#define PLANEENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <SFML/System.hpp>
+#include "Grid.h"
+#include "PelletGrid.h"
+#include "GameSession.h"
+
+// Writes a game's state as fixed-layout bit planes straight into a caller's
+// buffer (for agents and analysis tools).
+//
+// Layout: PLANE_COUNT planes back to back, each getPlaneBytes() long. Cell
+// (x, y) is bit i % 8 of byte i / 8 of its plane, i = y * width + x (numpy:
+// unpackbits(bitorder="little")). Planes are padded to whole 64-bit words.
+//
+// Incremental: the buffer is assumed to still hold what the last encode()
+// wrote, so only cells that changed since are touched: pellets from the
+// PelletGrid's change journal, and the old and new tiles of each actor. The
+// first call, a different buffer, a new board or `full` rewrites everything.
+class PlaneEncoder
+{
+public:
+    enum Plane
+    {
+        WALLS,
+        PELLETS,
+        POWER_PELLETS,
+        DOORS,
+        TUNNELS,
+        FRUIT,
+        MUNCHER,
+        GHOSTS_DANGEROUS,  // any ghost that kills on contact
+        GHOSTS_FRIGHTENED, // edible
+        GHOSTS_EYES,       // eaten, heading home
+        GHOST_0,           // one plane per ghost (in spawn order), any state
+        PLANE_COUNT = GHOST_0 + 4
+    };
+    static constexpr int IDENTITY_GHOSTS = PLANE_COUNT - GHOST_0;
+
+    PlaneEncoder(int width, int height);
+
+    std::size_t getPlaneBytes() const { return planeBytes; }
+    std::size_t getBytes() const { return planeBytes * PLANE_COUNT; }
+
+    // Bring `out` (getBytes() long) up to date with `session`.
+    void encode(const GameSession &session, std::uint8_t *out, bool full = false);
+
+    long getCellsTouched() const { return cellsTouched; } // since construction, for measuring
+
+private:
+    int width, height;
+    std::size_t planeBytes;
+
+    // What the buffer holds now.
+    const std::uint8_t *lastOut = nullptr;
+    const Grid *lastGrid = nullptr;
+    std::uint64_t pelletGeneration = 0;
+    std::size_t pelletChangesSeen = 0;
+    std::vector<std::uint32_t> actorBits; // (plane << 24) | cell for every actor bit set
+    long cellsTouched = 0;
+
+    void setBit(std::uint8_t *out, int plane, std::uint32_t cell, bool on)
+    {
+        std::uint8_t &byte = out[plane * planeBytes + (cell >> 3)];
+        std::uint8_t mask = static_cast<std::uint8_t>(1u << (cell & 7));
+        byte = on ? (byte | mask) : (byte & ~mask);
+        ++cellsTouched;
+    }
+    void writeBoard(const Grid &grid, std::uint8_t *out);
+    void writePelletCell(const PelletGrid &pellets, std::uint8_t *out, int x, int y);
+    void addActor(int plane, sf::Vector2i tile);
+};
+
+inline PlaneEncoder::PlaneEncoder(int w, int h)
+    : width(w), height(h),
+      planeBytes((static_cast<std::size_t>(w) * h + 63) / 64 * 8)
+{
+    actorBits.reserve(16);
+}
+
+inline void PlaneEncoder::encode(const GameSession &session, std::uint8_t *out, bool full)
+{
+    const Grid &grid = session.getGrid();
+    const PelletGrid &pellets = session.getPellets();
+    full = full || out != lastOut || &grid != lastGrid || grid.getWidth() != width || grid.getHeight() != height;
+
+    if (full)
+    {
+        width = grid.getWidth();
+        height = grid.getHeight();
+        planeBytes = (static_cast<std::size_t>(width) * height + 63) / 64 * 8;
+        std::memset(out, 0, getBytes());
+        writeBoard(grid, out);
+        actorBits.clear();
+        lastOut = out;
+        lastGrid = &grid;
+        pelletGeneration = 0; // force the pellet planes below
+    }
+
+    // Pellets: replay the journal, or rebuild both planes for a new board.
+    if (pellets.getGeneration() != pelletGeneration)
+    {
+        std::memset(out + PELLETS * planeBytes, 0, planeBytes);
+        std::memset(out + POWER_PELLETS * planeBytes, 0, planeBytes);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                if (pellets.hasPellet(x, y) || pellets.hasPowerPellet(x, y))
+                    writePelletCell(pellets, out, x, y);
+            }
+        }
+        pelletGeneration = pellets.getGeneration();
+    }
+    else
+    {
+        const std::vector<sf::Vector2i> &changes = pellets.getChanges();
+        for (std::size_t i = pelletChangesSeen; i < changes.size(); ++i)
+            writePelletCell(pellets, out, changes[i].x, changes[i].y);
+    }
+    pelletChangesSeen = pellets.getChanges().size();
+
+    // Actors: clear every bit set last time, then set the current ones (two
+    // ghosts may share a tile, so clearing has to finish before setting).
+    for (std::uint32_t bit : actorBits)
+        setBit(out, static_cast<int>(bit >> 24), bit & 0xFFFFFFu, false);
+    actorBits.clear();
+
+    if (session.isFruitShowing())
+        addActor(FRUIT, session.getFruit().getPosition());
+    addActor(MUNCHER, session.getMuncher().getPosition());
+    const std::vector<Ghost> &ghosts = session.getGhosts();
+    for (std::size_t i = 0; i < ghosts.size(); ++i)
+    {
+        const Ghost &ghost = ghosts[i];
+        GhostState state = ghost.getState();
+        int plane = GHOSTS_DANGEROUS;
+        if (ghost.getIsEaten() || state == GhostState::EATEN || state == GhostState::RETURNING)
+            plane = GHOSTS_EYES;
+        else if (state == GhostState::FRIGHTENED)
+            plane = GHOSTS_FRIGHTENED;
+        addActor(plane, ghost.getPosition());
+        if (static_cast<int>(i) < IDENTITY_GHOSTS)
+            addActor(GHOST_0 + static_cast<int>(i), ghost.getPosition());
+    }
+    for (std::uint32_t bit : actorBits)
+        setBit(out, static_cast<int>(bit >> 24), bit & 0xFFFFFFu, true);
+}
+
+// Static planes: walls, the ghost-house door and tunnel tiles.
+inline void PlaneEncoder::writeBoard(const Grid &grid, std::uint8_t *out)
+{
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            int flags = grid.getFlags(x, y);
+            std::uint32_t cell = static_cast<std::uint32_t>(y * width + x);
+            if (flags & WALL)
+                setBit(out, WALLS, cell, true);
+            if (flags & GHOST_DOOR)
+                setBit(out, DOORS, cell, true);
+            if (flags & TELEPORT)
+                setBit(out, TUNNELS, cell, true);
+        }
+    }
+}
+
+inline void PlaneEncoder::writePelletCell(const PelletGrid &pellets, std::uint8_t *out, int x, int y)
+{
+    std::uint32_t cell = static_cast<std::uint32_t>(y * width + x);
+    setBit(out, PELLETS, cell, pellets.hasPellet(x, y));
+    setBit(out, POWER_PELLETS, cell, pellets.hasPowerPellet(x, y));
+}
+
+inline void PlaneEncoder::addActor(int plane, sf::Vector2i tile)
+{
+    if (tile.x >= 0 && tile.x < width && tile.y >= 0 && tile.y < height)
+        actorBits.push_back(static_cast<std::uint32_t>(plane) << 24 | static_cast<std::uint32_t>(tile.y * width + tile.x));
+}
+
+#endif // PLANEENCODER_H
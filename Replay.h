@@ -0,0 +1,261 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <SFML/System.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DifficultyCurve.h"
+#include "GameSession.h"
+#include "Grid.h"
+#include "StateChecksum.h"
+
+// A recorded headless game (.pmr, `munch_maze --headless --record`): all it
+// takes to play the game again with no bot, map file or options (the board's
+// cells, the ghost roster, the difficulty curve, the frame length and one
+// input byte per frame), plus a StateChecksum every `checksumEvery` frames
+// and after the last. tools/replay.cpp plays replays back on other builds and
+// threads and reports the first frame and field that disagree.
+//
+// Recording, around each frame of the game:
+//   replay.begin(session, ...);
+//   bot.play(session); replay.recordInput(session); session.step(frame); replay.recordFrame(session);
+//   replay.finish(session); replay.save(path);
+//
+// Only a deterministic game replays: a ghost search budget (--ghost-search)
+// or the async AI decide on wall-clock time.
+//
+// File layout: FileHeader, the cells (width x height flag bytes, row-major),
+// the roster (int32 each), the curve (LevelDifficulty each), the inputs, then
+// the checkpoints, as written (little-endian, no padding beyond what is
+// spelled out).
+class Replay
+{
+public:
+    static constexpr std::uint32_t FILE_MAGIC = 0x50524D50; // "PMRP"
+    static constexpr std::uint32_t FILE_VERSION = 1;
+
+    struct FileHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::int32_t width, height;
+        std::int32_t playerStartX, playerStartY; // as the recording board had them,
+        std::int32_t ghostSpawnX, ghostSpawnY;   // to check the reloaded cells against
+        std::uint32_t rosterSize;                // 0 = the classic four
+        std::uint32_t curveLevels;               // 0 = the standard ramp
+        std::uint32_t checksumEvery;             // frames between checkpoints
+        std::uint32_t frameCount;                // inputs
+        std::uint32_t checkpointCount;
+        std::int32_t frameMicros; // simulated time per step
+        std::int64_t searchMicros; // GameSession::setSearchBudget
+        std::uint64_t seed;        // the recording's --seed (for the record only)
+    };
+    static_assert(sizeof(FileHeader) == 72, "Replay::FileHeader is a file format");
+
+    // The game's checksum after `frame` steps.
+    struct Checkpoint
+    {
+        std::uint32_t frame;
+        std::uint32_t reserved;
+        std::uint64_t parts[StateChecksum::FIELDS];
+
+        StateChecksum checksum() const
+        {
+            StateChecksum sum;
+            for (int f = 0; f < StateChecksum::FIELDS; ++f)
+                sum.parts[f] = parts[f];
+            return sum;
+        }
+    };
+    static_assert(sizeof(Checkpoint) == 8 + 8 * StateChecksum::FIELDS, "Replay::Checkpoint is a file format");
+
+    // Recording. `roster` and `curve` as handed to the session (empty = the
+    // defaults); call before the first step.
+    void begin(const GameSession &session, const std::vector<int> &roster, const DifficultyCurve &curve,
+               long searchMicros, sf::Time frame, int checksumEvery, std::uint64_t seed = 0);
+    // The input the next step runs on (after the bot or player has set it).
+    void recordInput(const GameSession &session)
+    {
+        inputs.push_back(static_cast<std::uint8_t>(static_cast<int>(session.getDesiredDirection()) |
+                                                   (session.isStarted() ? STARTED : 0)));
+    }
+    // After each step: a checkpoint every checksumEvery frames. True if one
+    // was taken (it is getCheckpoints().back()).
+    bool recordFrame(const GameSession &session)
+    {
+        if (frameCount() % header.checksumEvery != 0)
+            return false;
+        checkpoint(session);
+        return true;
+    }
+    // After the last step: a closing checkpoint, if the last frame had none.
+    bool finish(const GameSession &session)
+    {
+        if (!checkpoints.empty() && checkpoints.back().frame == frameCount())
+            return false;
+        checkpoint(session);
+        return true;
+    }
+
+    bool save(const std::string &path) const;
+    bool load(const std::string &path);
+
+    // Playback: the recorded board, a session set up as the recording was,
+    // and each frame's input before stepping it. The curve must outlive the
+    // session (GameSession::setDifficulty).
+    void buildGrid(Grid &grid) const;
+    bool gridMatches(const Grid &grid) const; // spawns as recorded
+    DifficultyCurve makeCurve() const;
+    void setUp(GameSession &session, const DifficultyCurve &curve) const;
+    void applyInput(GameSession &session, std::uint32_t frame) const
+    {
+        std::uint8_t input = inputs[frame];
+        if (input & STARTED)
+            session.setDesiredDirection(static_cast<MuncherDirection>(input & DIRECTION_MASK));
+    }
+
+    const FileHeader &getHeader() const { return header; }
+    std::uint32_t frameCount() const { return static_cast<std::uint32_t>(inputs.size()); }
+    sf::Time getFrameTime() const { return sf::microseconds(header.frameMicros); }
+    const std::vector<Checkpoint> &getCheckpoints() const { return checkpoints; }
+    const std::vector<int> &getRoster() const { return roster; }
+
+private:
+    static constexpr std::uint8_t DIRECTION_MASK = 3;
+    static constexpr std::uint8_t STARTED = 4; // the muncher has had its first input
+
+    FileHeader header{};
+    std::vector<std::uint8_t> cells;
+    std::vector<int> roster;
+    std::vector<LevelDifficulty> curve;
+    std::vector<std::uint8_t> inputs;
+    std::vector<Checkpoint> checkpoints;
+
+    void checkpoint(const GameSession &session);
+};
+
+inline void Replay::begin(const GameSession &session, const std::vector<int> &gameRoster, const DifficultyCurve &gameCurve,
+                          long searchMicros, sf::Time frame, int checksumEvery, std::uint64_t seed)
+{
+    const Grid &grid = session.getGrid();
+    header = FileHeader{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.width = grid.getWidth();
+    header.height = grid.getHeight();
+    header.playerStartX = grid.getPlayerStartX();
+    header.playerStartY = grid.getPlayerStartY();
+    header.ghostSpawnX = grid.getGhostSpawnX();
+    header.ghostSpawnY = grid.getGhostSpawnY();
+    header.checksumEvery = static_cast<std::uint32_t>(checksumEvery > 0 ? checksumEvery : 1);
+    header.frameMicros = static_cast<std::int32_t>(frame.asMicroseconds());
+    header.searchMicros = searchMicros;
+    header.seed = seed;
+
+    cells.resize(static_cast<std::size_t>(grid.getWidth()) * grid.getHeight());
+    for (int y = 0; y < grid.getHeight(); ++y)
+        for (int x = 0; x < grid.getWidth(); ++x)
+            cells[static_cast<std::size_t>(y) * grid.getWidth() + x] = static_cast<std::uint8_t>(grid.getFlags(x, y));
+    roster = gameRoster;
+    curve.clear();
+    for (int level = 1; level <= gameCurve.getLevels(); ++level)
+        curve.push_back(gameCurve.at(level));
+    inputs.clear();
+    checkpoints.clear();
+}
+
+inline void Replay::checkpoint(const GameSession &session)
+{
+    StateChecksum sum = session.getChecksum();
+    Checkpoint c{};
+    c.frame = frameCount();
+    for (int f = 0; f < StateChecksum::FIELDS; ++f)
+        c.parts[f] = sum.parts[f];
+    checkpoints.push_back(c);
+}
+
+inline bool Replay::save(const std::string &path) const
+{
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        std::cout << "Cannot write replay " << path << std::endl;
+        return false;
+    }
+
+    FileHeader out = header;
+    out.rosterSize = static_cast<std::uint32_t>(roster.size());
+    out.curveLevels = static_cast<std::uint32_t>(curve.size());
+    out.frameCount = frameCount();
+    out.checkpointCount = static_cast<std::uint32_t>(checkpoints.size());
+    std::vector<std::int32_t> ids(roster.begin(), roster.end());
+    auto write = [file](const void *data, std::size_t size, std::size_t count)
+    { return count == 0 || std::fwrite(data, size, count, file) == count; };
+    bool ok = write(&out, sizeof(out), 1) && write(cells.data(), 1, cells.size()) &&
+              write(ids.data(), sizeof(std::int32_t), ids.size()) &&
+              write(curve.data(), sizeof(LevelDifficulty), curve.size()) && write(inputs.data(), 1, inputs.size()) &&
+              write(checkpoints.data(), sizeof(Checkpoint), checkpoints.size());
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok)
+        std::cout << "Failed writing replay " << path << std::endl;
+    return ok;
+}
+
+inline bool Replay::load(const std::string &path)
+{
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    auto read = [file](void *data, std::size_t size, std::size_t count)
+    { return count == 0 || std::fread(data, size, count, file) == count; };
+    bool ok = read(&header, sizeof(header), 1) && header.magic == FILE_MAGIC && header.version == FILE_VERSION &&
+              header.width > 0 && header.height > 0 && header.checksumEvery > 0;
+    std::vector<std::int32_t> ids;
+    if (ok)
+    {
+        cells.resize(static_cast<std::size_t>(header.width) * header.height);
+        ids.resize(header.rosterSize);
+        curve.resize(header.curveLevels);
+        inputs.resize(header.frameCount);
+        checkpoints.resize(header.checkpointCount);
+        ok = read(cells.data(), 1, cells.size()) && read(ids.data(), sizeof(std::int32_t), ids.size()) &&
+             read(curve.data(), sizeof(LevelDifficulty), curve.size()) && read(inputs.data(), 1, inputs.size()) &&
+             read(checkpoints.data(), sizeof(Checkpoint), checkpoints.size());
+    }
+    std::fclose(file);
+    roster.assign(ids.begin(), ids.end());
+    return ok;
+}
+
+inline void Replay::buildGrid(Grid &grid) const
+{
+    grid.loadCells(header.width, header.height, cells.data());
+}
+
+inline bool Replay::gridMatches(const Grid &grid) const
+{
+    return grid.getPlayerStartX() == header.playerStartX && grid.getPlayerStartY() == header.playerStartY &&
+           grid.getGhostSpawnX() == header.ghostSpawnX && grid.getGhostSpawnY() == header.ghostSpawnY;
+}
+
+inline DifficultyCurve Replay::makeCurve() const
+{
+    DifficultyCurve out;
+    for (std::size_t i = 0; i < curve.size(); ++i)
+        out.set(static_cast<int>(i) + 1, curve[i]);
+    return out;
+}
+
+// The same calls, in the same order, that runHeadless makes on a new game.
+inline void Replay::setUp(GameSession &session, const DifficultyCurve &gameCurve) const
+{
+    if (!roster.empty())
+        session.setRoster(roster);
+    session.setSearchBudget(static_cast<long>(header.searchMicros));
+    session.setDifficulty(&gameCurve);
+}
+
+#endif // REPLAY_H
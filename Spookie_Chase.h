@@ -5,9 +5,19 @@
 #include "Grid.h"
 #include "Muncher.h"
 #include "PausableClock.h"
+#include "GameConfig.h"
+#include "GhostSearch.h"
+#include "DifficultyCurve.h"
+#include "AITrace.h"
+#include "GhostPersonalities.h"
+#include "TimerWheel.h"
+#include "GreedyBatch.h"
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <random>
+#include <limits>
+#include <string>
 #include <SFML/System.hpp>
 
 // AI Modes that ghosts cycle through
@@ -18,7 +28,8 @@ enum class AIMode
     FRIGHTENED // Ghosts move randomly when Pac-Man eats power pellet
 };
 
-// Individual ghost behavior types (personalities)
+// The classic personalities: their ids in GhostPersonalities, in GhostType
+// order (policies in GhostPersonalities.h; more kinds can be registered).
 enum class GhostPersonality
 {
     CHASER,   // JACK (Red) - Targets Muncher's current position directly
@@ -31,43 +42,138 @@ enum class GhostPersonality
 class GhostAI
 {
 private:
-    // Per-level mode durations in seconds (recomputed by setLevel; base = level 1).
+    // Per-level mode durations in seconds (set by setLevel; base = level 1).
     float scatterTime = 7.0f;
     float chaseTime = 20.0f;
     float frightenedTime = 10.0f;
 
-    // Targeting parameters
-    static constexpr int AMBUSH_DISTANCE = 4;               // Tiles ahead for ambusher
-    static constexpr float BASHFUL_RETREAT_DISTANCE = 8.0f; // Distance threshold for bashful retreat
-
     // Current AI state
     AIMode currentMode;
     AIMode modeBeforeFrightened; // phase to resume when frightened ends
-    PausableClock modeTimer;
-    PausableClock frightenedTimer;
     bool modeJustChanged;
 
-    // Corner positions for scatter mode (each ghost has a specific corner)
+    // Mode deadlines on a timer wheel over the AI's own game-time clock: one
+    // clock read a frame, and a frame with no deadline due does no timing work.
+    enum TimerKind
+    {
+        MODE_END,      // the scatter or chase phase is over
+        FRIGHTENED_END // power pellet wore off
+    };
+    PausableClock clock;
+    TimerWheel timers;
+    std::vector<TimerWheel::Event> firedTimers;
+    sf::Time modeStart;       // on `clock`, when the current scatter/chase phase began
+    sf::Time frightenedStart; // ...and when the last power pellet was eaten
+    TimerWheel::TimerId modeTimer = 0;
+    TimerWheel::TimerId frightenedTimer = 0;
+    void scheduleModeEnd();
+    void scheduleFrightenedEnd();
+
+    // Corner positions for scatter mode, for ghosts without a scatter target
+    // of their own (GameSession assigns map-derived ones; see scatterTargets)
     sf::Vector2i scatterCorners[4];
 
     // Reference to the chaser ghost for fickle ghost calculations
     Ghost *chaserGhost;
 
+    // update()'s ghost indices grouped by personality (reused every frame).
+    std::vector<int> kindOrder;
+    std::vector<int> kindStart;
+    std::vector<int> kindFill;
+
+    // Optional lookahead at junctions (off until setSearchBudget; depth set by setLevel).
+    static constexpr int MAX_SEARCH_DEPTH = 24;
+    GhostSearch search;
+    long searchCalls = 0;
+    long searchTimeouts = 0;
+    long searchNodes = 0;
+
+    // Frightened wandering. Each game owns its generator (not the global
+    // rand()), so headless games on worker threads stay independent and
+    // reproducible.
+    std::minstd_rand rng;
+
+    // Optional instrumentation (null = off).
+    AITrace *trace = nullptr;
+    void traceDecision(int ghostIndex, const Grid &grid, const GhostView &ghost, sf::Vector2i target, AIMode mode,
+                       GhostDirection chosen, std::uint8_t flags, std::uint64_t nanos, long nodes);
+    static std::uint8_t candidateMask(const Grid &grid, const GhostView &ghost);
+
+    // The part of a decision after the target: greedy step, lookahead, trace.
+    GhostDirection decideToward(const Grid &grid, const GhostView &ghost, const MuncherView &muncher,
+                                sf::Vector2i targetTile, AIMode mode, int ghostIndex, std::uint64_t start);
+
 public:
-    GhostAI();
+    GhostAI(int gridWidth = GameConfig::GRID_WIDTH, int gridHeight = GameConfig::GRID_HEIGHT);
 
     // Main update function
     void update(std::vector<Ghost> &ghosts, const Muncher &muncher, const Grid &grid);
 
+    // update() in two halves for lockstep batches (GameBatch): queueUpdate
+    // does everything but the scatter/chase greedy steps, which it adds to
+    // `batch` as game `lane`; once the batch is solved, applyBatch starts those
+    // moves. With a search budget or a trace it just runs update() (and
+    // queues nothing), so every option still works in a batch.
+    void queueUpdate(std::vector<Ghost> &ghosts, const Muncher &muncher, const Grid &grid, GreedyBatch &batch, int lane);
+    void applyBatch(std::vector<Ghost> &ghosts, const Grid &grid, const GreedyBatch &batch, int lane);
+
+    // The pieces update() is made of, for callers that steer ghosts from
+    // decisions made elsewhere (AsyncGhostAI):
+    // mode timing + frightened-exit fix-ups, once per frame...
+    void beginTick(std::vector<Ghost> &ghosts);
+    // ...whether a ghost takes a new direction this frame (idle, not eaten)...
+    static bool needsDecision(const Ghost &ghost);
+    // ...a random turn while frightened...
+    void steerFrightened(Ghost &ghost, const Grid &grid, int ghostIndex = -1);
+    // ...and the scatter/chase choice for one ghost, from plain values.
+    // ghostIndex only labels the trace record.
+    GhostDirection decide(const Grid &grid, const GhostView &ghost, const MuncherView &muncher,
+                          const sf::Vector2i *chaserTile, AIMode mode, int ghostIndex = -1);
+    // Trace a choice made elsewhere (AsyncGhostAI's worker) as if decided here.
+    void recordWorkerDecision(int ghostIndex, const Grid &grid, const GhostView &ghost, const MuncherView &muncher,
+                              const sf::Vector2i *chaserTile, AIMode mode, GhostDirection chosen);
+
+    // decide() for a known policy, with the chase target inlined; the
+    // personality registry points each kind at its instantiation.
+    template <typename Policy>
+    GhostDirection decideAs(const Grid &grid, const GhostView &ghost, const MuncherView &muncher,
+                            const sf::Vector2i *chaserTile, AIMode mode, int ghostIndex = -1);
+    // Scatter/chase steering for every ghost of one personality in a frame
+    // (ghosts[indices[0..count)]), one tight loop per kind.
+    template <typename Policy>
+    void steerGroup(const Grid &grid, std::vector<Ghost> &ghosts, const int *indices, int count,
+                    const MuncherView &muncher, const sf::Vector2i *chaserTile);
+
+    // Scatter targets for `count` ghosts on this map: the four board corners
+    // first (classic order, as they are), then points spread around the edge,
+    // each moved to the nearest open maze tile no other ghost targets.
+    static std::vector<sf::Vector2i> scatterTargets(const Grid &grid, int count);
+
+    static GhostView viewOf(const Ghost &ghost);
+    static MuncherView viewOf(const Muncher &muncher);
+    const Ghost *getChaserGhost() const { return chaserGhost; }
+    std::minstd_rand &random() { return rng; } // carried across GhostAI rebuilds by GameSession
+    const std::minstd_rand &random() const { return rng; }
+    void setTrace(AITrace *t) { trace = t; }    // decision ring + counters; null = off
+    AITrace *getTrace() const { return trace; }
+
     // Mode management
     void updateMode();
     void setFrightened();
-    void setLevel(int level); // ramp mode durations for difficulty
+    void setLevel(int level); // ramp mode durations (and search depth) for difficulty
+    void setLevel(int level, const LevelDifficulty &d); // ...with mode durations from a tuned curve
+
+    // Lookahead search budget per ghost decision in microseconds; 0 = greedy only.
+    // Depth comes from the level: level 1 stays greedy, then 4, 6, 8, ... tiles.
+    void setSearchBudget(long micros);
+    int getSearchDepth() const { return search.isEnabled() ? search.getMaxDepth() : 1; }
+    long getSearchCalls() const { return searchCalls; }
+    long getSearchTimeouts() const { return searchTimeouts; }
+    long getSearchNodes() const { return searchNodes; }
     AIMode getCurrentMode() const { return currentMode; }
     void setPaused(bool p) // freeze/unfreeze AI timers for the pause menu
     {
-        modeTimer.setPaused(p);
-        frightenedTimer.setPaused(p);
+        clock.setPaused(p);
     }
 
     // Individual ghost AI behaviors
@@ -80,30 +186,295 @@ public:
     sf::Vector2i getFickleTarget(const Muncher &muncher, const Ghost &chaserGhost);
     sf::Vector2i getBashfulTarget(const Ghost &bashfulGhost, const Muncher &muncher);
 
+    // Tile-based cores of the above (what decide() uses)
+    sf::Vector2i targetFor(const GhostView &ghost, const MuncherView &muncher, const sf::Vector2i *chaserTile, AIMode mode) const;
+    sf::Vector2i scatterFor(const GhostView &ghost) const
+    {
+        return ghost.scatter.x >= 0 ? ghost.scatter : scatterCorners[static_cast<int>(ghost.type) & 3];
+    }
+    GhostDirection greedyFrom(const Grid &grid, const GhostView &ghost, sf::Vector2i targetTile) const;
+    // The step a scatter/chase decision takes before any lookahead: greedyFrom,
+    // except that on large boards (PathHierarchy::worthwhile) a chase target
+    // LONG_RANGE or more tiles away is followed along a hierarchical path,
+    // where the greedy rule would walk into the first dead end facing it.
+    GhostDirection stepToward(const Grid &grid, const GhostView &ghost, sf::Vector2i targetTile, AIMode mode) const
+    {
+        int routed = longRangeStep(grid, ghost, targetTile, mode);
+        return routed >= 0 ? static_cast<GhostDirection>(routed) : greedyFrom(grid, ghost, targetTile);
+    }
+    // That path's first step, if it is one this ghost may take (legal by
+    // greedyFrom's rule, not a reversal); -1 where the greedy step stands.
+    static int longRangeStep(const Grid &grid, const GhostView &ghost, sf::Vector2i targetTile, AIMode mode);
+    static constexpr int LONG_RANGE = 2 * PathHierarchy::CLUSTER; // tiles, walking distance as the crow flies
+
     // Utility functions
-    float calculateDistance(sf::Vector2i pos1, sf::Vector2i pos2);
-    GhostPersonality getPersonality(GhostType type);
+    static float calculateDistance(sf::Vector2i pos1, sf::Vector2i pos2);
+    static GhostPersonality getPersonality(GhostType type);
     std::vector<GhostDirection> getValidDirections(const Ghost &ghost, const Grid &grid);
-    sf::Vector2i getDirectionOffset(GhostDirection direction);
-    GhostDirection getOppositeDirection(GhostDirection direction);
+    static sf::Vector2i getDirectionOffset(GhostDirection direction);
+    static GhostDirection getOppositeDirection(GhostDirection direction);
 };
 
+// Registry of ghost personalities. Each kind is a policy type (see
+// GhostPersonalities.h) plus the GhostAI instantiations that run it, so
+// per-ghost code calls through one pointer per kind, not a switch per ghost.
+// Ids are indices in registration order: the classic four first (GhostType
+// order), then the extra built-ins, then anything added with add<Policy>().
+// Register kinds at startup, before games run; lookups are not locked.
+class GhostPersonalities
+{
+public:
+    struct Kind
+    {
+        const char *name;
+        sf::Vector2i (*chaseTarget)(const TargetContext &c);
+        GhostDirection (GhostAI::*decide)(const Grid &, const GhostView &, const MuncherView &, const sf::Vector2i *,
+                                          AIMode, int);
+        void (GhostAI::*steer)(const Grid &, std::vector<Ghost> &, const int *, int, const MuncherView &,
+                               const sf::Vector2i *);
+    };
+
+    // Register a policy; returns its id (the existing one if already there).
+    template <typename Policy>
+    static int add();
+
+    static int count() { return static_cast<int>(kinds().size()); }
+    // Unknown ids fall back to the chaser.
+    static const Kind &get(int id) { return kinds()[id >= 0 && id < count() ? id : 0]; }
+    static int find(const std::string &name); // -1 if none
+    static int forType(GhostType type) { return static_cast<int>(type); }
+
+private:
+    static std::vector<Kind> &kinds();
+};
+
+template <typename Policy>
+inline int GhostPersonalities::add()
+{
+    std::vector<Kind> &all = kinds();
+    for (std::size_t i = 0; i < all.size(); ++i)
+    {
+        if (all[i].chaseTarget == &Policy::chaseTarget)
+            return static_cast<int>(i);
+    }
+    all.push_back(Kind{Policy::NAME, &Policy::chaseTarget, &GhostAI::decideAs<Policy>, &GhostAI::steerGroup<Policy>});
+    return static_cast<int>(all.size()) - 1;
+}
+
+inline int GhostPersonalities::find(const std::string &name)
+{
+    const std::vector<Kind> &all = kinds();
+    for (std::size_t i = 0; i < all.size(); ++i)
+    {
+        if (name == all[i].name)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+inline std::vector<GhostPersonalities::Kind> &GhostPersonalities::kinds()
+{
+    // Seeded on first use; the classic four must keep ids 0-3.
+    static std::vector<Kind> all = [] {
+        std::vector<Kind> k;
+        auto entry = [](auto policy) {
+            using Policy = decltype(policy);
+            return Kind{Policy::NAME, &Policy::chaseTarget, &GhostAI::decideAs<Policy>, &GhostAI::steerGroup<Policy>};
+        };
+        k.push_back(entry(ChaserPolicy{}));
+        k.push_back(entry(AmbusherPolicy{}));
+        k.push_back(entry(FicklePolicy{}));
+        k.push_back(entry(BashfulPolicy{}));
+        k.push_back(entry(InterceptorPolicy{}));
+        k.push_back(entry(GuardPolicy{}));
+        return k;
+    }();
+    return all;
+}
+
 // Constructor - Initialize scatter corners and AI state
-inline GhostAI::GhostAI()
+inline GhostAI::GhostAI(int gridWidth, int gridHeight)
     : currentMode(AIMode::SCATTER), modeBeforeFrightened(AIMode::SCATTER), modeJustChanged(false), chaserGhost(nullptr)
 {
-    // Set scatter corners for 28x31 authentic Pac-Man grid
-    // These should be the four corners of your maze
-    scatterCorners[0] = sf::Vector2i(1, 1);   // JACK (Red) - Top Left
-    scatterCorners[1] = sf::Vector2i(26, 1);  // MIKE (Blue) - Top Right
-    scatterCorners[2] = sf::Vector2i(1, 29);  // SAM (Purple) - Bottom Left
-    scatterCorners[3] = sf::Vector2i(26, 29); // WILL (Yellow) - Bottom Right
+    // Scatter corners sit one tile in from the board's corners, whatever its
+    // size (on the 28x31 board: (1,1), (26,1), (1,29), (26,29)).
+    scatterCorners[0] = sf::Vector2i(1, 1);                          // JACK (Red) - Top Left
+    scatterCorners[1] = sf::Vector2i(gridWidth - 2, 1);              // MIKE (Blue) - Top Right
+    scatterCorners[2] = sf::Vector2i(1, gridHeight - 2);             // SAM (Purple) - Bottom Left
+    scatterCorners[3] = sf::Vector2i(gridWidth - 2, gridHeight - 2); // WILL (Yellow) - Bottom Right
+
+    clock.restart();
+    scheduleModeEnd();
+}
+
+inline std::vector<sf::Vector2i> GhostAI::scatterTargets(const Grid &grid, int count)
+{
+    const int w = grid.getWidth(), h = grid.getHeight();
+    auto open = [&grid](int x, int y) {
+        return grid.isValidPosition(x, y) &&
+               !(grid.getFlags(x, y) & (WALL | GHOST_SPAWN | GHOST_DOOR | SCOREBOARD | TELEPORT));
+    };
+
+    std::vector<sf::Vector2i> targets;
+    for (int i = 0; i < count; ++i)
+    {
+        if (i < 4)
+        {
+            // Classic corners, one tile in (JACK, MIKE, SAM, WILL), as they
+            // are: a scatter target need not be walkable (on the shipped map
+            // the bottom two sit in the scoreboard), only somewhere to head for.
+            targets.push_back(sf::Vector2i(i % 2 ? w - 2 : 1, i < 2 ? 1 : h - 2));
+            continue;
+        }
 
-    modeTimer.restart();
+        // Golden-ratio steps around the inner edge (clockwise from the top
+        // left), so any number of extra ghosts spread out evenly.
+        sf::Vector2i anchor;
+        float f = std::fmod(0.125f + 0.618034f * static_cast<float>(i - 4), 1.0f);
+        float edgeW = static_cast<float>(std::max(w - 3, 1)), edgeH = static_cast<float>(std::max(h - 3, 1));
+        float d = f * 2.0f * (edgeW + edgeH);
+        if (d < edgeW)
+            anchor = sf::Vector2i(1 + static_cast<int>(d), 1);
+        else if ((d -= edgeW) < edgeH)
+            anchor = sf::Vector2i(w - 2, 1 + static_cast<int>(d));
+        else if ((d -= edgeH) < edgeW)
+            anchor = sf::Vector2i(w - 2 - static_cast<int>(d), h - 2);
+        else
+            anchor = sf::Vector2i(1, h - 2 - static_cast<int>(d - edgeW));
+        anchor.x = std::max(0, std::min(w - 1, anchor.x)); // tiny boards: keep it on the board
+        anchor.y = std::max(0, std::min(h - 1, anchor.y));
+
+        // Extra ghosts snap to the nearest open tile nobody else targets:
+        // search square rings outward, closest in the first ring that has
+        // one. A board with no such tile keeps the anchor.
+        auto taken = [&targets](sf::Vector2i t) { return std::find(targets.begin(), targets.end(), t) != targets.end(); };
+        sf::Vector2i best = anchor;
+        for (int r = 0, maxR = std::max(w, h); r <= maxR; ++r)
+        {
+            float bestDistance = std::numeric_limits<float>::max();
+            for (int y = anchor.y - r; y <= anchor.y + r; ++y)
+            {
+                int step = (y == anchor.y - r || y == anchor.y + r) ? 1 : 2 * r;
+                for (int x = anchor.x - r; x <= anchor.x + r; x += std::max(step, 1))
+                {
+                    float distance = tileDistance(sf::Vector2i(x, y), anchor);
+                    if (open(x, y) && distance < bestDistance && !taken(sf::Vector2i(x, y)))
+                    {
+                        bestDistance = distance;
+                        best = sf::Vector2i(x, y);
+                    }
+                }
+            }
+            if (bestDistance < std::numeric_limits<float>::max())
+                break;
+        }
+        targets.push_back(best);
+    }
+    return targets;
 }
 
 // Main update function - called every frame
 inline void GhostAI::update(std::vector<Ghost> &ghosts, const Muncher &muncher, const Grid &grid)
+{
+    std::uint64_t start = trace ? AITrace::nowNanos() : 0;
+    beginTick(ghosts);
+
+    const MuncherView muncherView = viewOf(muncher);
+    sf::Vector2i chaserTile = chaserGhost ? chaserGhost->getPosition() : sf::Vector2i();
+
+    if (currentMode == AIMode::FRIGHTENED)
+    {
+        // Random movement when frightened (in ghost order: they share the RNG)
+        for (std::size_t i = 0; i < ghosts.size(); ++i)
+        {
+            if (needsDecision(ghosts[i]))
+                steerFrightened(ghosts[i], grid, static_cast<int>(i));
+        }
+    }
+    else
+    {
+        // Group the ghosts that decide this frame by personality (counting
+        // sort, ghost order kept within a kind), then steer each group in its
+        // kind's own loop.
+        int kinds = GhostPersonalities::count();
+        kindStart.assign(kinds + 1, 0);
+        kindOrder.resize(ghosts.size());
+        auto kindOf = [kinds](const Ghost &ghost) {
+            int id = ghost.getPersonality();
+            return id >= 0 && id < kinds ? id : 0;
+        };
+        for (const Ghost &ghost : ghosts)
+        {
+            if (needsDecision(ghost))
+                kindStart[kindOf(ghost) + 1]++;
+        }
+        for (int k = 0; k < kinds; ++k)
+            kindStart[k + 1] += kindStart[k];
+        kindFill.assign(kindStart.begin(), kindStart.end() - 1);
+        for (std::size_t i = 0; i < ghosts.size(); ++i)
+        {
+            if (needsDecision(ghosts[i]))
+                kindOrder[kindFill[kindOf(ghosts[i])]++] = static_cast<int>(i);
+        }
+
+        for (int k = 0; k < kinds; ++k)
+        {
+            int n = kindStart[k + 1] - kindStart[k];
+            if (n > 0)
+                (this->*GhostPersonalities::get(k).steer)(grid, ghosts, &kindOrder[kindStart[k]], n, muncherView,
+                                                           chaserGhost ? &chaserTile : nullptr);
+        }
+    }
+
+    if (trace)
+        trace->getCounters().updateNanos += AITrace::nowNanos() - start;
+}
+
+inline void GhostAI::queueUpdate(std::vector<Ghost> &ghosts, const Muncher &muncher, const Grid &grid,
+                                 GreedyBatch &batch, int lane)
+{
+    if (search.isEnabled() || trace)
+    {
+        update(ghosts, muncher, grid);
+        return;
+    }
+    beginTick(ghosts);
+
+    if (currentMode == AIMode::FRIGHTENED)
+    {
+        for (std::size_t i = 0; i < ghosts.size(); ++i)
+        {
+            if (needsDecision(ghosts[i]))
+                steerFrightened(ghosts[i], grid, static_cast<int>(i));
+        }
+        return;
+    }
+
+    // A frame's decisions don't see each other's moves (tiles only change on
+    // arrival), so queueing them in ghost order gives update()'s choices.
+    const MuncherView muncherView = viewOf(muncher);
+    sf::Vector2i chaserTile = chaserGhost ? chaserGhost->getPosition() : sf::Vector2i();
+    for (std::size_t i = 0; i < ghosts.size(); ++i)
+    {
+        if (!needsDecision(ghosts[i]))
+            continue;
+        const GhostView view = viewOf(ghosts[i]);
+        sf::Vector2i target = targetFor(view, muncherView, chaserGhost ? &chaserTile : nullptr, currentMode);
+        int routed = longRangeStep(grid, view, target, currentMode);
+        if (routed >= 0)
+            ghosts[i].startMovement(grid, static_cast<GhostDirection>(routed)); // already decided: not a greedy step
+        else
+            batch.add(lane, static_cast<int>(i), grid, view, target);
+    }
+}
+
+inline void GhostAI::applyBatch(std::vector<Ghost> &ghosts, const Grid &grid, const GreedyBatch &batch, int lane)
+{
+    for (int q = batch.first(lane); q < batch.last(lane); ++q)
+        ghosts[batch.ghost(q)].startMovement(grid, batch.direction(q));
+}
+
+inline void GhostAI::beginTick(std::vector<Ghost> &ghosts)
 {
     // Store previous mode to detect transitions
     AIMode previousMode = currentMode;
@@ -125,141 +496,291 @@ inline void GhostAI::update(std::vector<Ghost> &ghosts, const Muncher &muncher,
     }
 
     // Find the chaser ghost for fickle calculations
+    chaserGhost = nullptr;
     for (auto &ghost : ghosts)
     {
-        if (ghost.getGhostType() == GhostType::JACK)
+        if (ghost.getPersonality() == static_cast<int>(GhostPersonality::CHASER))
         {
             chaserGhost = &ghost;
             break;
         }
     }
 
-    // Update each ghost's AI
-    for (auto &ghost : ghosts)
+    if (trace)
     {
-        // Returning ghosts should head back to spawn without AI steering.
-        if (ghost.getState() == GhostState::RETURNING || ghost.getIsEaten())
-            continue;
+        trace->beginTick();
+        for (auto &ghost : ghosts)
+        {
+            trace->addHomeSearch(ghost.getHomeSearches(), ghost.getHomeSearchNodes());
+            ghost.clearHomeSearchCounts();
+        }
+    }
+}
 
-        // Skip if ghost is currently moving
-        if (ghost.getIsMoving())
-            continue;
+inline bool GhostAI::needsDecision(const Ghost &ghost)
+{
+    // Returning ghosts head back to spawn without AI steering, and a ghost
+    // that is mid-move only chooses again once it reaches the next tile.
+    return ghost.getState() != GhostState::RETURNING && !ghost.getIsEaten() && !ghost.getIsMoving();
+}
 
-        sf::Vector2i targetTile;
+inline void GhostAI::steerFrightened(Ghost &ghost, const Grid &grid, int ghostIndex)
+{
+    std::vector<GhostDirection> validDirs = getValidDirections(ghost, grid);
+    if (validDirs.empty())
+        return;
+    if (trace)
+        trace->getCounters().randomDecisions++;
 
-        // Determine target based on current mode
-        if (currentMode == AIMode::FRIGHTENED)
-        {
-            // Random movement when frightened
-            std::vector<GhostDirection> validDirs = getValidDirections(ghost, grid);
-            if (!validDirs.empty())
-            {
-                // Choose random valid direction (avoid going backwards if possible)
-                GhostDirection opposite = getOppositeDirection(ghost.getDirection());
-                std::vector<GhostDirection> preferredDirs;
+    // Choose random valid direction (avoid going backwards if possible)
+    GhostDirection opposite = getOppositeDirection(ghost.getDirection());
+    std::vector<GhostDirection> preferredDirs;
 
-                for (GhostDirection dir : validDirs)
-                {
-                    if (dir != opposite)
-                        preferredDirs.push_back(dir);
-                }
+    for (GhostDirection dir : validDirs)
+    {
+        if (dir != opposite)
+            preferredDirs.push_back(dir);
+    }
 
-                if (!preferredDirs.empty())
-                {
-                    int randomIndex = rand() % preferredDirs.size();
-                    ghost.startMovement(grid, preferredDirs[randomIndex]);
-                }
-                else if (!validDirs.empty())
-                {
-                    int randomIndex = rand() % validDirs.size();
-                    ghost.startMovement(grid, validDirs[randomIndex]);
-                }
-            }
-        }
-        else
-        {
-            // Get target tile based on current mode and ghost personality
-            targetTile = getTargetTile(ghost, muncher, grid);
+    const GhostView view = viewOf(ghost); // before the move starts, for the trace
+    GhostDirection chosen;
+    if (!preferredDirs.empty())
+    {
+        int randomIndex = rng() % preferredDirs.size();
+        chosen = preferredDirs[randomIndex];
+    }
+    else
+    {
+        int randomIndex = rng() % validDirs.size();
+        chosen = validDirs[randomIndex];
+    }
+    ghost.startMovement(grid, chosen);
 
-            // Get best direction to reach target
-            GhostDirection bestDir = getBestDirection(ghost, targetTile, grid);
+    if (trace && ghostIndex >= 0)
+    {
+        traceDecision(ghostIndex, grid, view, view.tile, AIMode::FRIGHTENED, chosen, AITraceRecord::RANDOM, 0, 0);
+    }
+}
 
-            // Move ghost
-            ghost.startMovement(grid, bestDir);
-        }
+// Scatter/chase choice: target tile from the mode and personality, the greedy
+// step towards it, then (if enabled) the lookahead search at junctions, with
+// the greedy step as its fallback.
+inline GhostDirection GhostAI::decide(const Grid &grid, const GhostView &ghost, const MuncherView &muncher,
+                                      const sf::Vector2i *chaserTile, AIMode mode, int ghostIndex)
+{
+    return (this->*GhostPersonalities::get(ghost.personality).decide)(grid, ghost, muncher, chaserTile, mode, ghostIndex);
+}
+
+template <typename Policy>
+inline GhostDirection GhostAI::decideAs(const Grid &grid, const GhostView &ghost, const MuncherView &muncher,
+                                        const sf::Vector2i *chaserTile, AIMode mode, int ghostIndex)
+{
+    std::uint64_t start = trace ? AITrace::nowNanos() : 0;
+    sf::Vector2i scatter = scatterFor(ghost);
+    sf::Vector2i targetTile =
+        mode == AIMode::SCATTER ? scatter : Policy::chaseTarget(TargetContext{ghost, muncher, chaserTile, scatter});
+    return decideToward(grid, ghost, muncher, targetTile, mode, ghostIndex, start);
+}
+
+template <typename Policy>
+inline void GhostAI::steerGroup(const Grid &grid, std::vector<Ghost> &ghosts, const int *indices, int count,
+                                const MuncherView &muncher, const sf::Vector2i *chaserTile)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        Ghost &ghost = ghosts[indices[i]];
+        ghost.startMovement(grid, decideAs<Policy>(grid, viewOf(ghost), muncher, chaserTile, currentMode, indices[i]));
     }
 }
 
-// Update AI mode based on timing
-inline void GhostAI::updateMode()
+inline GhostDirection GhostAI::decideToward(const Grid &grid, const GhostView &ghost, const MuncherView &muncher,
+                                            sf::Vector2i targetTile, AIMode mode, int ghostIndex, std::uint64_t start)
 {
-    float elapsed = modeTimer.getElapsedTime().asSeconds();
-    AIMode previousMode = currentMode;
+    GhostDirection bestDir = stepToward(grid, ghost, targetTile, mode);
 
-    // Handle frightened mode (overrides normal cycle)
-    if (currentMode == AIMode::FRIGHTENED)
+    long nodes = 0;
+    if (search.isEnabled())
     {
-        if (frightenedTimer.getElapsedTime().asSeconds() >= frightenedTime)
+        GhostSearch::Result r = search.choose(grid, ghost.tile, ghost.heading, muncher.tile, muncher.heading, targetTile,
+                                              mode == AIMode::CHASE, bestDir);
+        bestDir = r.direction;
+        if (r.nodes > 0)
         {
-            currentMode = modeBeforeFrightened; // resume the phase frightened interrupted
-            modeTimer.restart();
+            ++searchCalls;
+            searchNodes += r.nodes;
+            nodes = r.nodes;
+            if (r.timedOut)
+                ++searchTimeouts;
         }
-        return;
     }
 
-    // Normal mode cycling
-    switch (currentMode)
+    if (trace)
     {
-    case AIMode::SCATTER:
-        if (elapsed >= scatterTime)
+        std::uint64_t nanos = AITrace::nowNanos() - start;
+        AITraceCounters &c = trace->getCounters();
+        c.decisions++;
+        c.decideNanos += nanos;
+        if (nodes > 0)
         {
-            currentMode = AIMode::CHASE;
-            modeTimer.restart();
+            c.searchedDecisions++;
+            c.searchNodes += nodes;
         }
-        break;
+        if (ghostIndex >= 0)
+            traceDecision(ghostIndex, grid, ghost, targetTile, mode, bestDir, nodes > 0 ? AITraceRecord::SEARCHED : 0,
+                          nanos, nodes);
+    }
+    return bestDir;
+}
+
+inline void GhostAI::recordWorkerDecision(int ghostIndex, const Grid &grid, const GhostView &ghost,
+                                          const MuncherView &muncher, const sf::Vector2i *chaserTile, AIMode mode,
+                                          GhostDirection chosen)
+{
+    if (!trace)
+        return;
+    AITraceCounters &c = trace->getCounters();
+    c.decisions++;
+    c.workerDecisions++;
+    traceDecision(ghostIndex, grid, ghost, targetFor(ghost, muncher, chaserTile, mode), mode, chosen,
+                  AITraceRecord::FROM_WORKER, 0, 0);
+}
+
+inline void GhostAI::traceDecision(int ghostIndex, const Grid &grid, const GhostView &ghost, sf::Vector2i target,
+                                   AIMode mode, GhostDirection chosen, std::uint8_t flags, std::uint64_t nanos, long nodes)
+{
+    AITraceRecord r{};
+    r.tick = trace->tick();
+    r.kind = AITraceRecord::DECISION;
+    r.ghost = static_cast<std::uint8_t>(ghostIndex);
+    r.mode = static_cast<std::uint8_t>(mode);
+    r.flags = flags;
+    r.tileX = static_cast<std::int16_t>(ghost.tile.x);
+    r.tileY = static_cast<std::int16_t>(ghost.tile.y);
+    r.targetX = static_cast<std::int16_t>(target.x);
+    r.targetY = static_cast<std::int16_t>(target.y);
+    r.candidates = candidateMask(grid, ghost);
+    r.chosen = static_cast<std::uint8_t>(chosen);
+    r.nanos = static_cast<std::uint16_t>(std::min<std::uint64_t>(nanos, 65535));
+    r.searchNodes = static_cast<std::uint32_t>(nodes);
+    trace->record(r);
+}
 
-    case AIMode::CHASE:
-        if (elapsed >= chaseTime)
+// Legal directions as a bit per GhostDirection, by greedyFrom's rule.
+inline std::uint8_t GhostAI::candidateMask(const Grid &grid, const GhostView &ghost)
+{
+    std::uint8_t mask = 0;
+    for (GhostDirection dir : {GhostDirection::UP, GhostDirection::DOWN, GhostDirection::LEFT, GhostDirection::RIGHT})
+    {
+        sf::Vector2i p = ghost.tile + getDirectionOffset(dir);
+        if (grid.isValidPosition(p.x, p.y) && (!grid.isWall(p.x, p.y) || (grid.isGhostDoor(p.x, p.y) && ghost.doorOpen)))
+            mask |= static_cast<std::uint8_t>(1u << static_cast<int>(dir));
+    }
+    return mask;
+}
+
+inline GhostView GhostAI::viewOf(const Ghost &ghost)
+{
+    GhostState state = ghost.getState();
+    return GhostView{ghost.getPosition(), ghost.getDirection(), ghost.getGhostType(),
+                     state == GhostState::RETURNING || state == GhostState::NORMAL, ghost.getPersonality(),
+                     ghost.getScatterTile()};
+}
+
+inline MuncherView GhostAI::viewOf(const Muncher &muncher)
+{
+    return MuncherView{muncher.getPosition(), muncher.getDirection()};
+}
+
+// Update AI mode from the mode deadlines that came due
+inline void GhostAI::updateMode()
+{
+    firedTimers.clear();
+    timers.advance(clock.getElapsedTime(), firedTimers);
+    AIMode previousMode = currentMode;
+
+    for (const TimerWheel::Event &e : firedTimers)
+    {
+        if (e.kind == FRIGHTENED_END && currentMode == AIMode::FRIGHTENED)
         {
-            currentMode = AIMode::SCATTER;
-            modeTimer.restart();
+            currentMode = modeBeforeFrightened; // resume the phase frightened interrupted
+            modeStart = timers.getNow();
+            scheduleModeEnd();
+            if (trace)
+                trace->modeChange(static_cast<int>(AIMode::FRIGHTENED), static_cast<int>(currentMode));
+            return;
+        }
+        if (e.kind == MODE_END && currentMode != AIMode::FRIGHTENED)
+        {
+            // Normal mode cycling
+            currentMode = currentMode == AIMode::SCATTER ? AIMode::CHASE : AIMode::SCATTER;
+            modeStart = timers.getNow();
+            scheduleModeEnd();
         }
-        break;
-
-    default:
-        break;
     }
+    if (currentMode == AIMode::FRIGHTENED)
+        return;
 
     modeJustChanged = (previousMode != currentMode);
+    if (modeJustChanged && trace)
+        trace->modeChange(static_cast<int>(previousMode), static_cast<int>(currentMode));
 }
 
 // Set frightened mode (called when power pellet is eaten)
 inline void GhostAI::setFrightened()
 {
     if (currentMode != AIMode::FRIGHTENED)
+    {
         modeBeforeFrightened = currentMode; // remember what phase to resume afterwards
+        timers.cancel(modeTimer);           // restarted when frightened ends
+    }
+    if (trace)
+        trace->modeChange(static_cast<int>(currentMode), static_cast<int>(AIMode::FRIGHTENED));
     currentMode = AIMode::FRIGHTENED;
-    frightenedTimer.restart();
+    frightenedStart = clock.getElapsedTime();
+    scheduleFrightenedEnd();
     modeJustChanged = true;
 }
 
+// (Re)arm the current phase's deadline; durations can change mid-phase (setLevel).
+inline void GhostAI::scheduleModeEnd()
+{
+    timers.cancel(modeTimer);
+    float duration = currentMode == AIMode::SCATTER ? scatterTime : chaseTime;
+    modeTimer = timers.schedule(modeStart + sf::seconds(duration), MODE_END);
+}
+
+inline void GhostAI::scheduleFrightenedEnd()
+{
+    timers.cancel(frightenedTimer);
+    frightenedTimer = timers.schedule(frightenedStart + sf::seconds(frightenedTime), FRIGHTENED_END);
+}
+
 // Ramp mode durations with level: shorter scatter, longer chase, weaker power
 // pellets (shorter frightened). Level 1 = base values.
 inline void GhostAI::setLevel(int level)
+{
+    setLevel(level, DifficultyCurve::standard(level));
+}
+
+inline void GhostAI::setLevel(int level, const LevelDifficulty &d)
 {
     int n = (level > 1) ? (level - 1) : 0; // steps above level 1
 
-    scatterTime = 7.0f - n * 0.5f;
-    if (scatterTime < 3.0f)
-        scatterTime = 3.0f;
+    scatterTime = d.scatterTime;
+    chaseTime = d.chaseTime;
+    frightenedTime = d.frightenedTime;
+    if (currentMode == AIMode::FRIGHTENED)
+        scheduleFrightenedEnd();
+    else
+        scheduleModeEnd();
 
-    chaseTime = 20.0f + n * 2.0f;
-    if (chaseTime > 40.0f)
-        chaseTime = 40.0f;
+    // Lookahead depth (only used once a search budget is set).
+    search.setMaxDepth(n == 0 ? 1 : std::min(MAX_SEARCH_DEPTH, 2 + 2 * n));
+}
 
-    frightenedTime = 10.0f - n * 1.0f;
-    if (frightenedTime < 1.0f)
-        frightenedTime = 1.0f;
+inline void GhostAI::setSearchBudget(long micros)
+{
+    search.setBudgetMicros(micros);
 }
 
 // Get target tile for a ghost based on mode and personality
@@ -268,79 +789,89 @@ inline sf::Vector2i GhostAI::getTargetTile(const Ghost &ghost, const Muncher &mu
     // Suppress unused parameter warning for grid (may be used in future enhancements)
     (void)grid;
 
-    if (currentMode == AIMode::SCATTER)
-    {
-        // Return to assigned corner
-        int ghostIndex = static_cast<int>(ghost.getGhostType());
-        return scatterCorners[ghostIndex];
-    }
-    else // CHASE mode
-    {
-        GhostPersonality personality = getPersonality(ghost.getGhostType());
-
-        switch (personality)
-        {
-        case GhostPersonality::CHASER:
-            return getChaserTarget(muncher);
-
-        case GhostPersonality::AMBUSHER:
-            return getAmbusherTarget(muncher);
-
-        case GhostPersonality::FICKLE:
-            if (chaserGhost)
-                return getFickleTarget(muncher, *chaserGhost);
-            else
-                return getChaserTarget(muncher); // Fallback
-
-        case GhostPersonality::BASHFUL:
-            return getBashfulTarget(ghost, muncher);
+    sf::Vector2i chaserTile = chaserGhost ? chaserGhost->getPosition() : sf::Vector2i();
+    return targetFor(viewOf(ghost), viewOf(muncher), chaserGhost ? &chaserTile : nullptr, currentMode);
+}
 
-        default:
-            return getChaserTarget(muncher);
-        }
-    }
+inline sf::Vector2i GhostAI::targetFor(const GhostView &ghost, const MuncherView &muncher, const sf::Vector2i *chaserTile,
+                                       AIMode mode) const
+{
+    sf::Vector2i scatter = scatterFor(ghost);
+    if (mode == AIMode::SCATTER)
+        return scatter; // Return to assigned corner
+    return GhostPersonalities::get(ghost.personality).chaseTarget(TargetContext{ghost, muncher, chaserTile, scatter});
 }
 
 // Get best direction to reach target tile
 inline GhostDirection GhostAI::getBestDirection(const Ghost &ghost, sf::Vector2i targetTile, const Grid &grid)
 {
-    std::vector<GhostDirection> validDirs = getValidDirections(ghost, grid);
+    return greedyFrom(grid, viewOf(ghost), targetTile);
+}
 
-    if (validDirs.empty())
-        return ghost.getDirection(); // Can't move anywhere
+inline int GhostAI::longRangeStep(const Grid &grid, const GhostView &ghost, sf::Vector2i targetTile, AIMode mode)
+{
+    if (mode != AIMode::CHASE || !PathHierarchy::worthwhile(grid) ||
+        std::abs(targetTile.x - ghost.tile.x) + std::abs(targetTile.y - ghost.tile.y) < LONG_RANGE)
+        return -1;
+    // A target in a wall, or cut off, has no path: greedy as before.
+    int dir = PathHierarchy::of(grid)->firstStep(grid, ghost.tile, targetTile);
+    if (dir < 0 || static_cast<GhostDirection>(dir) == getOppositeDirection(ghost.heading) ||
+        !(candidateMask(grid, ghost) & (1u << dir)))
+        return -1; // the path leads back, or through the ghost house the eyes may use
+    return dir;
+}
 
-    // Don't go backwards unless it's the only option
-    GhostDirection opposite = getOppositeDirection(ghost.getDirection());
-    std::vector<GhostDirection> preferredDirs;
+inline GhostDirection GhostAI::greedyFrom(const Grid &grid, const GhostView &ghost, sf::Vector2i targetTile) const
+{
+    // Valid directions, in UP/DOWN/LEFT/RIGHT order (Ghost::canMove's rule).
+    GhostDirection validDirs[4];
+    int validCount = 0;
+    for (GhostDirection dir : {GhostDirection::UP, GhostDirection::DOWN, GhostDirection::LEFT, GhostDirection::RIGHT})
+    {
+        sf::Vector2i p = ghost.tile + getDirectionOffset(dir);
+        if (!grid.isValidPosition(p.x, p.y))
+            continue;
+        if (!grid.isWall(p.x, p.y) || (grid.isGhostDoor(p.x, p.y) && ghost.doorOpen))
+            validDirs[validCount++] = dir;
+    }
 
-    for (GhostDirection dir : validDirs)
+    if (validCount == 0)
+        return ghost.heading; // Can't move anywhere
+
+    // Don't go backwards unless it's the only option
+    GhostDirection opposite = getOppositeDirection(ghost.heading);
+    GhostDirection preferredDirs[4];
+    int preferredCount = 0;
+    for (int i = 0; i < validCount; ++i)
     {
-        if (dir != opposite)
-            preferredDirs.push_back(dir);
+        if (validDirs[i] != opposite)
+            preferredDirs[preferredCount++] = validDirs[i];
     }
 
     // Use preferred directions if available, otherwise use all valid
-    std::vector<GhostDirection> &dirsToCheck = preferredDirs.empty() ? validDirs : preferredDirs;
+    const GhostDirection *dirsToCheck = preferredCount ? preferredDirs : validDirs;
+    int checkCount = preferredCount ? preferredCount : validCount;
 
     // Find direction that gets closest to target
     GhostDirection bestDir = dirsToCheck[0];
     float bestDistance = std::numeric_limits<float>::max();
 
-    for (GhostDirection dir : dirsToCheck)
+    for (int i = 0; i < checkCount; ++i)
     {
-        sf::Vector2i testPos = ghost.getPosition() + getDirectionOffset(dir);
-        float distance = calculateDistance(testPos, targetTile);
+        sf::Vector2i testPos = ghost.tile + getDirectionOffset(dirsToCheck[i]);
+        float distance = tileDistance(testPos, targetTile);
 
         if (distance < bestDistance)
         {
             bestDistance = distance;
-            bestDir = dir;
+            bestDir = dirsToCheck[i];
         }
     }
 
     return bestDir;
 }
 
+// The targeting strategies on live actors (the policies in GhostPersonalities.h).
 // CHASER (JACK/Red) - Targets Muncher's current position directly
 inline sf::Vector2i GhostAI::getChaserTarget(const Muncher &muncher)
 {
@@ -350,89 +881,27 @@ inline sf::Vector2i GhostAI::getChaserTarget(const Muncher &muncher)
 // AMBUSHER (MIKE/Blue) - Targets 4 tiles ahead of Muncher's direction
 inline sf::Vector2i GhostAI::getAmbusherTarget(const Muncher &muncher)
 {
-    sf::Vector2i muncherPos(muncher.getPosition().x, muncher.getPosition().y);
-    sf::Vector2i offset(0, 0);
-
-    // Get offset based on Muncher's direction
-    switch (muncher.getDirection())
-    {
-    case MuncherDirection::UP:
-        // Original bug: offset both up and left when facing up
-        offset = sf::Vector2i(-AMBUSH_DISTANCE / 2, -AMBUSH_DISTANCE / 2);
-        break;
-    case MuncherDirection::DOWN:
-        offset = sf::Vector2i(0, AMBUSH_DISTANCE);
-        break;
-    case MuncherDirection::LEFT:
-        offset = sf::Vector2i(-AMBUSH_DISTANCE, 0);
-        break;
-    case MuncherDirection::RIGHT:
-        offset = sf::Vector2i(AMBUSH_DISTANCE, 0);
-        break;
-    }
-
-    return muncherPos + offset;
+    return AmbusherPolicy::chaseTarget(TargetContext{GhostView{}, viewOf(muncher), nullptr, sf::Vector2i()});
 }
 
 // FICKLE (SAM/Purple) - Complex targeting based on Muncher and Chaser positions
 inline sf::Vector2i GhostAI::getFickleTarget(const Muncher &muncher, const Ghost &chaserGhost)
 {
-    sf::Vector2i muncherPos(muncher.getPosition().x, muncher.getPosition().y);
-    sf::Vector2i chaserPos = chaserGhost.getPosition();
-
-    // Get point 2 tiles ahead of Muncher
-    sf::Vector2i offset(0, 0);
-    switch (muncher.getDirection())
-    {
-    case MuncherDirection::UP:
-        offset = sf::Vector2i(0, -2);
-        break;
-    case MuncherDirection::DOWN:
-        offset = sf::Vector2i(0, 2);
-        break;
-    case MuncherDirection::LEFT:
-        offset = sf::Vector2i(-2, 0);
-        break;
-    case MuncherDirection::RIGHT:
-        offset = sf::Vector2i(2, 0);
-        break;
-    }
-
-    sf::Vector2i midPoint = muncherPos + offset;
-
-    // Vector from chaser to midpoint
-    sf::Vector2i vector = midPoint - chaserPos;
-
-    // Double the vector for fickle's target
-    return midPoint + vector;
+    sf::Vector2i chaserTile = chaserGhost.getPosition();
+    return FicklePolicy::chaseTarget(TargetContext{GhostView{}, viewOf(muncher), &chaserTile, sf::Vector2i()});
 }
 
 // BASHFUL (WILL/Yellow) - Alternates between chase and retreat
 inline sf::Vector2i GhostAI::getBashfulTarget(const Ghost &bashfulGhost, const Muncher &muncher)
 {
-    sf::Vector2i ghostPos = bashfulGhost.getPosition();
-    sf::Vector2i muncherPos(muncher.getPosition().x, muncher.getPosition().y);
-
-    float distance = calculateDistance(ghostPos, muncherPos);
-
-    if (distance < BASHFUL_RETREAT_DISTANCE)
-    {
-        // Too close - retreat to scatter corner
-        return scatterCorners[static_cast<int>(bashfulGhost.getGhostType())];
-    }
-    else
-    {
-        // Far enough - chase normally
-        return muncherPos;
-    }
+    GhostView view = viewOf(bashfulGhost);
+    return BashfulPolicy::chaseTarget(TargetContext{view, viewOf(muncher), nullptr, scatterFor(view)});
 }
 
 // Calculate Euclidean distance between two points
 inline float GhostAI::calculateDistance(sf::Vector2i pos1, sf::Vector2i pos2)
 {
-    float dx = static_cast<float>(pos1.x - pos2.x);
-    float dy = static_cast<float>(pos1.y - pos2.y);
-    return std::sqrt(dx * dx + dy * dy);
+    return tileDistance(pos1, pos2);
 }
 
 // Get personality based on ghost type
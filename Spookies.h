@@ -6,11 +6,15 @@
 #include <string>
 #include <limits>
 #include <cstdlib>
-#include <queue>
 #include "Grid.h"
 #include "GameConfig.h"
 #include "SpriteSheet.h"
 #include "PausableClock.h"
+#include "TimerWheel.h"
+#include "SweptContact.h"
+#include "TileEvents.h"
+#include "PathHierarchy.h"
+#include "BitFlood.h"
 
 enum class GhostType
 {
@@ -51,8 +55,9 @@ private:
     const SpriteSheet *sheet = nullptr;
     sf::Sprite sprite;
 
-    // Animation timing
-    PausableClock animationClock;
+    // Animation timing: the next frame is a timer on the game's wheel
+    TimerWheel::TimerId animationTimer = 0;
+    int index = 0; // in the game's ghost list; tags its timer events
     float animationSpeed;
     int currentFrame;
 
@@ -62,11 +67,24 @@ private:
     float movementSpeed;
     bool isMoving;
 
+    // This update's path for swept contact with the muncher (SweptContact.h)
+    sf::Vector2f sweepFrom, sweepTo;
+    float arrivedAgo = 0.0f; // seconds since the tile was reached, if it was this update
+
     // Eaten state
     bool isEaten;
     PausableClock eatenTimer;
     static constexpr float EATEN_DISPLAY_TIME = 8.0f; // Show eaten sprite for 8 seconds
 
+    // Targeting: GhostPersonalities id (the classic four match GhostType
+    // order) and scatter target (x < 0 = GhostAI's corner for the type).
+    int personality;
+    sf::Vector2i scatterTile;
+
+    // Return-home BFS work since GhostAI last collected it (AITrace counters).
+    long homeSearches = 0;
+    long homeSearchNodes = 0;
+
 public:
     // Set position directly (for teleportation)
     void setPosition(int x, int y)
@@ -74,21 +92,27 @@ public:
         position = sf::Vector2i(x, y);
         renderPosition = sf::Vector2f(x * size, y * size);
         targetPosition = renderPosition;
+        sweepFrom = sweepTo = renderPosition;
+        arrivedAgo = 0.0f;
         sprite.setPosition(renderPosition.x + size / 2.0f, renderPosition.y + size / 2.0f);
         isMoving = false;
     }
     // Constructor
-    Ghost(int startX, int startY, GhostType type, int gridSize, const SpriteSheet &sheetRef);
+    Ghost(int startX, int startY, GhostType type, int gridSize, const SpriteSheet *sheetPtr); // null sheet = headless (no sprite frames)
 
     // Methods
     void applyFrame();          // set texture-rect + tint + flip from state/direction
     sf::Color bodyTint() const; // per-ghost palette colour (Route A palette swap)
-    void updateAnimation();
+    void restartAnimation();    // hold this frame for animationSpeed (GameSession's wheel)
+    void onAnimationTimer(TimerWheel::TimerId id);
+    void setIndex(int i) { index = i; }
+    TimerWheel::TimerId getAnimationTimer() const { return animationTimer; }
     void updateMovement(const Grid &grid, const std::vector<Ghost> &ghosts);
     void setState(GhostState newState);
     void setDirection(GhostDirection newDirection);
     bool canMove(const Grid &grid, GhostDirection dir) const;
     void startMovement(const Grid &grid, GhostDirection dir);
+    void enterTile(const Grid &grid); // rules for arriving on its tile
 
     // Getters
     sf::Vector2i getPosition() const { return position; }
@@ -98,11 +122,31 @@ public:
     GhostState getState() const { return state; }
     sf::Sprite &getSprite() { return sprite; }
     bool getIsMoving() const { return isMoving; }
+    // Tile the ghost is heading into while moving, else the tile it stands on:
+    // where its next steering decision will be taken.
+    sf::Vector2i getNextTile() const
+    {
+        return isMoving ? sf::Vector2i(static_cast<int>(targetPosition.x / size), static_cast<int>(targetPosition.y / size))
+                        : position;
+    }
     bool getIsEaten() const { return isEaten; }
+    int getPersonality() const { return personality; }
+    void setPersonality(int id) { personality = id; }
+    sf::Vector2i getScatterTile() const { return scatterTile; }
+    void setScatterTile(sf::Vector2i tile) { scatterTile = tile; }
     void setMovementSpeed(float s) { movementSpeed = s; } // seconds per tile; lower = faster
+    float getMovementSpeed() const { return movementSpeed; }
+    // Path walked in the last updateMovement, which ran `interval` seconds after the one before.
+    MotionSweep getSweep(float interval) const
+    {
+        float end = interval > 0.0f ? 1.0f - arrivedAgo / interval : 1.0f;
+        return MotionSweep{sweepFrom, sweepTo, std::clamp(end, 0.0f, 1.0f)};
+    }
+    long getHomeSearches() const { return homeSearches; }
+    long getHomeSearchNodes() const { return homeSearchNodes; }
+    void clearHomeSearchCounts() { homeSearches = homeSearchNodes = 0; }
     void setPaused(bool p)                                // freeze/unfreeze timers for the pause menu
     {
-        animationClock.setPaused(p);
         movementClock.setPaused(p);
         eatenTimer.setPaused(p);
     }
@@ -113,6 +157,10 @@ public:
         setState(GhostState::RETURNING);
     }
 
+    // Move the home tile (live map reload moved the green spawn tiles).
+    void setSpawnPosition(int x, int y) { spawnPosition = sf::Vector2i(x, y); }
+    sf::Vector2i getSpawnPosition() const { return spawnPosition; }
+
     // Reset to spawn tile in NORMAL state (used on level restart / life loss).
     void reset()
     {
@@ -125,14 +173,16 @@ public:
 };
 
 // Constructor implementation
-inline Ghost::Ghost(int startX, int startY, GhostType type, int gridSize, const SpriteSheet &sheetRef)
+inline Ghost::Ghost(int startX, int startY, GhostType type, int gridSize, const SpriteSheet *sheetPtr)
     : position(startX, startY), renderPosition(startX * gridSize, startY * gridSize),
       spawnPosition(startX, startY),
       ghostType(type), direction(GhostDirection::RIGHT), state(GhostState::NORMAL),
-      size(gridSize), sheet(&sheetRef), animationSpeed(0.3f), currentFrame(0),
-      movementSpeed(0.4f), isMoving(false), isEaten(false)
+      size(gridSize), sheet(sheetPtr), animationSpeed(0.3f), currentFrame(0),
+      movementSpeed(0.4f), isMoving(false), isEaten(false),
+      personality(static_cast<int>(type)), scatterTile(-1, -1)
 {
     targetPosition = renderPosition;
+    sweepFrom = sweepTo = renderPosition;
     // Centre the origin on the 100x100 cell so a negative X scale flips the
     // sprite in place (LEFT = mirrored RIGHT) without shifting its position.
     sprite.setOrigin(50.0f, 50.0f);
@@ -224,20 +274,32 @@ inline void Ghost::applyFrame()
     sprite.setScale(flip ? -s : s, s); // negative X = horizontal mirror about the centred origin
 }
 
-// Update animation frames
-inline void Ghost::updateAnimation()
+// Next animation frame in animationSpeed, on the active wheel (GameSession
+// installs it while it updates); without one the frame holds.
+inline void Ghost::restartAnimation()
 {
-    if (animationClock.getElapsedTime().asSeconds() >= animationSpeed)
+    if (TimerWheel *wheel = TimerWheel::active())
     {
-        currentFrame++; // drives the frightened two-frame blink
-        applyFrame();
-        animationClock.restart();
+        wheel->cancel(animationTimer);
+        animationTimer = wheel->scheduleIn(sf::seconds(animationSpeed), GHOST_FRAME, index);
     }
 }
 
+// Animation timer fired: advance a frame (unless a state change restarted it since)
+inline void Ghost::onAnimationTimer(TimerWheel::TimerId id)
+{
+    if (id != animationTimer)
+        return;
+    currentFrame++; // drives the frightened two-frame blink
+    applyFrame();
+    restartAnimation();
+}
+
 // Update smooth movement between grid positions
 inline void Ghost::updateMovement(const Grid &grid, const std::vector<Ghost> &ghosts)
 {
+    sweepFrom = renderPosition;
+    arrivedAgo = 0.0f;
     if (isMoving)
     {
         float elapsed = movementClock.getElapsedTime().asSeconds();
@@ -245,17 +307,12 @@ inline void Ghost::updateMovement(const Grid &grid, const std::vector<Ghost> &gh
 
         if (progress >= 1.0f)
         {
-            // Movement complete
+            // Movement complete (the tile was reached `arrivedAgo` seconds ago)
             renderPosition = targetPosition;
             position = sf::Vector2i(targetPosition.x / size, targetPosition.y / size);
             isMoving = false;
-
-            // If eaten and reached a ghost spawn tile, reset to normal
-            if (isEaten && (position == spawnPosition || grid.isGhostSpawn(position.x, position.y)))
-            {
-                isEaten = false;
-                setState(GhostState::NORMAL);
-            }
+            arrivedAgo = elapsed - movementSpeed;
+            TileEvents::emit(TileEvent::ENTER, index, position); // GameSession calls enterTile
         }
         else
         {
@@ -297,15 +354,6 @@ inline void Ghost::updateMovement(const Grid &grid, const std::vector<Ghost> &gh
                 return GhostDirection::UP;
             };
 
-            auto isPassable = [&](int x, int y)
-            {
-                if (!grid.isValidPosition(x, y))
-                    return false;
-                if (!grid.isWall(x, y))
-                    return true;
-                return grid.isGhostDoor(x, y) || grid.isGhostSpawn(x, y);
-            };
-
             auto isOccupied = [&](const sf::Vector2i &pos)
             {
                 if (pos == spawnPosition || grid.isGhostSpawn(pos.x, pos.y))
@@ -320,81 +368,44 @@ inline void Ghost::updateMovement(const Grid &grid, const std::vector<Ghost> &gh
                 return false;
             };
 
-            // BFS to the nearest ghost spawn tile (or original spawn position)
-            int width = grid.getWidth();
-            int height = grid.getHeight();
-            std::vector<std::vector<bool>> visited(height, std::vector<bool>(width, false));
-            std::vector<std::vector<sf::Vector2i>> prev(height, std::vector<sf::Vector2i>(width, sf::Vector2i(-1, -1)));
-            std::queue<sf::Vector2i> q;
-            q.push(position);
-            visited[position.y][position.x] = true;
-
-            sf::Vector2i target(-1, -1);
-            while (!q.empty())
+            // Large boards: the hierarchical path graph, whose per-query cost
+            // doesn't grow with the board (PathHierarchy.h).
+            if (PathHierarchy::worthwhile(grid))
             {
-                sf::Vector2i cur = q.front();
-                q.pop();
-
-                if (grid.isGhostSpawn(cur.x, cur.y) || cur == spawnPosition)
-                {
-                    target = cur;
-                    break;
-                }
-
-                for (GhostDirection dir : directions)
+                ++homeSearches;
+                int dir = PathHierarchy::of(grid)->firstStepHome(grid, position, spawnPosition, &homeSearchNodes);
+                if (dir >= 0)
                 {
-                    sf::Vector2i nextPos = cur;
-                    switch (dir)
-                    {
-                    case GhostDirection::UP:
-                        nextPos.y--;
-                        break;
-                    case GhostDirection::DOWN:
-                        nextPos.y++;
-                        break;
-                    case GhostDirection::LEFT:
-                        nextPos.x--;
-                        break;
-                    case GhostDirection::RIGHT:
-                        nextPos.x++;
-                        break;
-                    }
-
-                    if (!isPassable(nextPos.x, nextPos.y))
-                        continue;
-                    if (visited[nextPos.y][nextPos.x])
-                        continue;
-
-                    visited[nextPos.y][nextPos.x] = true;
-                    prev[nextPos.y][nextPos.x] = cur;
-                    q.push(nextPos);
+                    static const sf::Vector2i offsets[4] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+                    bestDir = static_cast<GhostDirection>(dir);
+                    foundMove = !isOccupied(position + offsets[dir]);
                 }
             }
-
-            if (target.x != -1 && target != position)
+            else
             {
-                sf::Vector2i step = target;
-                while (prev[step.y][step.x] != position && prev[step.y][step.x].x != -1)
+                // Nearest ghost spawn tile (or original spawn position) by a
+                // bit-parallel BFS over the board's walkable-tile masks
+                // (BitFlood.h); it steps exactly as the tile-by-tile BFS did.
+                std::shared_ptr<const PassMasks> masks = PassMasks::of(grid);
+                BitFlood &bfs = BitFlood::scratch();
+                const BitBoard *homes = &masks->home;
+                if (grid.isValidPosition(spawnPosition.x, spawnPosition.y) && !homes->test(spawnPosition.x, spawnPosition.y))
                 {
-                    step = prev[step.y][step.x];
+                    static thread_local BitBoard homesAndSpawn;
+                    homesAndSpawn = masks->home;
+                    homesAndSpawn.set(spawnPosition.x, spawnPosition.y);
+                    homes = &homesAndSpawn;
                 }
+                ++homeSearches;
+                bfs.flood(masks->eyes, position, std::numeric_limits<int>::max(), homes);
+                homeSearchNodes += bfs.getCellsReached();
 
-                if (prev[step.y][step.x] == position)
+                int dir = bfs.firstStep();
+                if (dir >= 0)
                 {
-                    sf::Vector2i delta = step - position;
-                    if (delta.x == 1)
-                        bestDir = GhostDirection::RIGHT;
-                    else if (delta.x == -1)
-                        bestDir = GhostDirection::LEFT;
-                    else if (delta.y == 1)
-                        bestDir = GhostDirection::DOWN;
-                    else if (delta.y == -1)
-                        bestDir = GhostDirection::UP;
-
-                    if (!isOccupied(step))
-                    {
-                        foundMove = true;
-                    }
+                    static const sf::Vector2i offsets[4] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+                    bestDir = static_cast<GhostDirection>(dir);
+                    foundMove = !isOccupied(position + offsets[dir]);
                 }
             }
 
@@ -456,6 +467,7 @@ inline void Ghost::updateMovement(const Grid &grid, const std::vector<Ghost> &gh
             }
         }
     }
+    sweepTo = renderPosition;
 }
 
 // Set ghost state
@@ -465,7 +477,7 @@ inline void Ghost::setState(GhostState newState)
     {
         state = newState;
         currentFrame = 0;
-        animationClock.restart();
+        restartAnimation();
         applyFrame();
     }
 }
@@ -548,6 +560,18 @@ inline void Ghost::startMovement(const Grid &grid, GhostDirection dir)
     targetPosition = sf::Vector2f(newGridPos.x * size, newGridPos.y * size);
     isMoving = true;
     movementClock.restart();
+    TileEvents::emit(TileEvent::LEAVE, index, position);
+}
+
+// Arrived on a tile (its ENTER event): an eaten ghost that reached a ghost
+// spawn tile is back to normal.
+inline void Ghost::enterTile(const Grid &grid)
+{
+    if (isEaten && (position == spawnPosition || grid.isGhostSpawn(position.x, position.y)))
+    {
+        isEaten = false;
+        setState(GhostState::NORMAL);
+    }
 }
 
 #endif // SPOOKIES_H
\ No newline at end of file
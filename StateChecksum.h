@@ -0,0 +1,81 @@
+#ifndef STATECHECKSUM_H
+#define STATECHECKSUM_H
+
+#include <SFML/System.hpp>
+#include <cstdint>
+#include <cstring>
+#include "Zobrist.h"
+
+// A fingerprint of one moment of a game (GameSession::getChecksum), for
+// proving two runs played the same: a recorded game against its replay
+// (Replay.h), or one build or thread against another (tools/replay.cpp).
+//
+// Unlike getHash, which keeps only what lookahead decides on, this takes
+// everything that moves the game on, bit for bit: in-between-tile render
+// positions and speeds as raw float bits, the clock, the score and the
+// frightened-ghost RNG. A fast path that rounds one float differently shows
+// up here on the frame it happens, not levels later as a different score.
+//
+// Kept as one hash per field, so a mismatch says where the games parted.
+struct StateChecksum
+{
+    enum Field
+    {
+        MUNCHER, // tile, next tile, heading, state, render position, buffered input
+        GHOSTS,  // each ghost's tile, next tile, heading, state, render position, speed
+        PELLETS, // what is left on the board
+        SCORE,   // points, lives, level, ghosts eaten this power pellet, dying, game over
+        AI,      // the scatter/chase mode and the frightened-wandering RNG
+        FRUIT,   // showing, type, due
+        CLOCK,   // simulated time and frames run
+        FIELDS
+    };
+
+    std::uint64_t parts[FIELDS] = {};
+
+    void add(Field f, std::uint64_t v) { parts[f] = zobristMix(parts[f] ^ v); }
+    void add(Field f, float v)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        add(f, static_cast<std::uint64_t>(bits));
+    }
+    void add(Field f, sf::Vector2i t)
+    {
+        add(f, static_cast<std::uint64_t>(static_cast<std::uint32_t>(t.x)) |
+                   static_cast<std::uint64_t>(static_cast<std::uint32_t>(t.y)) << 32);
+    }
+    void add(Field f, sf::Vector2f p)
+    {
+        add(f, p.x);
+        add(f, p.y);
+    }
+
+    // All fields folded into one number (checksum logs).
+    std::uint64_t total() const
+    {
+        std::uint64_t h = 0;
+        for (int f = 0; f < FIELDS; ++f)
+            h = zobristMix(h ^ parts[f]);
+        return h;
+    }
+
+    // The first field (in Field order) that differs from `other`, or -1.
+    int firstDifference(const StateChecksum &other) const
+    {
+        for (int f = 0; f < FIELDS; ++f)
+        {
+            if (parts[f] != other.parts[f])
+                return f;
+        }
+        return -1;
+    }
+
+    static const char *fieldName(int f)
+    {
+        static const char *const names[FIELDS] = {"muncher", "ghosts", "pellets", "score", "ai", "fruit", "clock"};
+        return f >= 0 && f < FIELDS ? names[f] : "?";
+    }
+};
+
+#endif // STATECHECKSUM_H
@@ -0,0 +1,70 @@
+#ifndef SWEPTCONTACT_H
+#define SWEPTCONTACT_H
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <cmath>
+
+// Where an actor went during one update, as a fraction s of the update
+// interval (0 = the previous update, 1 = this one): a straight line from
+// `from` to `to` until `moveEnd`, then standing on `to`. An actor that
+// reached its tile part-way through the interval stops there (moveEnd < 1)
+// even though the update only noticed afterwards; one that kept walking has
+// moveEnd = 1, and one standing still has from == to.
+struct MotionSweep
+{
+    sf::Vector2f from;
+    sf::Vector2f to;
+    float moveEnd = 1.0f;
+
+    sf::Vector2f at(float s) const
+    {
+        if (s >= moveEnd || moveEnd <= 0.0f)
+            return to;
+        return from + (to - from) * (s / moveEnd);
+    }
+};
+
+// Earliest s in [0, 1] at which two actors are closer than `radius`, or -1
+// if they never are during the interval. Both paths are linear between the
+// breakpoints (0, each moveEnd, 1), so the gap between them is too: each piece
+// is solved exactly for its first entry into the radius. That makes contact
+// independent of how long the interval is (frame rate, time scale): a pass
+// that starts and ends more than `radius` apart is still caught.
+inline float firstContact(const MotionSweep &a, const MotionSweep &b, float radius)
+{
+    const float r2 = radius * radius;
+    float cuts[4] = {0.0f, std::clamp(a.moveEnd, 0.0f, 1.0f), std::clamp(b.moveEnd, 0.0f, 1.0f), 1.0f};
+    std::sort(cuts, cuts + 4);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        float s0 = cuts[i];
+        float s1 = cuts[i + 1];
+        sf::Vector2f d0 = a.at(s0) - b.at(s0);
+        float c = d0.x * d0.x + d0.y * d0.y - r2;
+        if (c < 0.0f)
+            return s0; // already touching at the start of this piece
+        if (s1 <= s0)
+            continue; // empty piece (repeated breakpoint)
+
+        // |d0 + u v|^2 = r^2 for u in [0, 1): the first crossing into the radius.
+        sf::Vector2f v = (a.at(s1) - b.at(s1)) - d0;
+        float qa = v.x * v.x + v.y * v.y;
+        if (qa <= 0.0f)
+            continue; // no relative motion on this piece
+        float qb = 2.0f * (d0.x * v.x + d0.y * v.y);
+        float disc = qb * qb - 4.0f * qa * c;
+        if (disc <= 0.0f)
+            continue; // misses, or only grazes the edge
+        float u = (-qb - std::sqrt(disc)) / (2.0f * qa);
+        if (u >= 0.0f && u < 1.0f)
+            return s0 + u * (s1 - s0);
+    }
+
+    // The end point itself (guards against rounding in the roots above).
+    sf::Vector2f d1 = a.at(1.0f) - b.at(1.0f);
+    return d1.x * d1.x + d1.y * d1.y < r2 ? 1.0f : -1.0f;
+}
+
+#endif // SWEPTCONTACT_H
@@ -0,0 +1,268 @@
+#ifndef THREATMAP_H
+#define THREATMAP_H
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "BitFlood.h"
+#include "Grid.h"
+#include "Spookies.h"
+
+// How soon a ghost can reach each tile: for every live ghost (NORMAL, not
+// eaten) a BFS from the tile it is walking into, through the ghost door as
+// ghosts walk, out to MAX_DEPTH steps; and over all of them, the earliest
+// arrival in seconds at that ghost's own speed. Frightened ghosts and eyes
+// are no threat and have no field.
+//
+// Kept up to date incrementally: update() only marks the field of a ghost
+// whose tile, state or speed changed, or that reaches a tile edited since
+// (every field, after a bulk change to the board), and
+// a field is only rebuilt when it is next needed. With the combined times
+// wanted, that is at once, and then those times are only redone over the
+// cells that ghost covered before and covers now; without them (the bot,
+// which only asks about the ghosts near the muncher), fields are rebuilt on
+// prepare(). Between changes every query is a lookup.
+//
+// Used by MuncherBot for its danger check, and drawn by the dev-mode threat
+// overlay in main.cpp (dev key G).
+class ThreatMap
+{
+public:
+    static constexpr int MAX_DEPTH = 40; // steps; the bot's widest look (2 x its danger radius)
+    static constexpr std::uint8_t UNREACHED = 0xFF;
+
+    // Follow the ghosts (and the board). `withTimes` also brings timeAt up to
+    // date; without it only prepare()d fields can be read.
+    void update(const Grid &grid, const std::vector<Ghost> &ghosts, bool withTimes = true);
+    // Rebuild ghost i's field now if it is out of date or shallower than
+    // `depth` steps (clamped to MAX_DEPTH).
+    void prepare(int ghost, int depth = MAX_DEPTH);
+
+    // Seconds until the first live ghost can stand on (x, y), or infinity if
+    // none gets there within MAX_DEPTH steps (as of the last update withTimes).
+    float timeAt(int x, int y) const
+    {
+        if (x < 0 || x >= width || y < 0 || y >= height || time.empty())
+            return std::numeric_limits<float>::infinity();
+        return time[static_cast<std::size_t>(y) * width + x];
+    }
+    // Steps from ghost i (prepared) to a cell, y * width + x: UNREACHED past
+    // MAX_DEPTH or if the ghost is no threat.
+    int steps(int ghost, int cell) const { return fields[ghost].steps.empty() ? UNREACHED : fields[ghost].steps[cell]; }
+    bool isThreat(int ghost) const { return fields[ghost].threat; } // live, on the board
+    sf::Vector2i getSource(int ghost) const { return fields[ghost].source; }
+    float getSecondsPerTile(int ghost) const { return fields[ghost].secondsPerTile; }
+    int getGhostCount() const { return static_cast<int>(fields.size()); }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    long getRebuilds() const { return rebuilds; } // ghost fields recomputed so far
+
+private:
+    struct Field
+    {
+        sf::Vector2i source{-1, -1}; // the ghost's next tile
+        bool live = false;           // NORMAL and not eaten
+        bool threat = false;         // live with a source on the board
+        bool stale = false;          // steps/reached predate the last change
+        int depth = 0;               // steps the BFS went out to
+        float secondsPerTile = 0.0f;
+        std::vector<std::uint8_t> steps; // per cell; empty = no threat
+        std::vector<int> reached;        // cells with a step count
+    };
+
+    const Grid *grid = nullptr;
+    int width = 0;
+    int height = 0;
+    std::uint64_t gridVersion = 0;
+    std::vector<Field> fields;
+    std::vector<float> time;
+    bool timesValid = false;             // false: redo every cell next time
+    std::shared_ptr<const PassMasks> masks; // the board's walkable tiles
+    std::vector<sf::Vector2i> changedCells; // tiles edited since gridVersion
+    std::vector<int> dirty;               // cells whose combined time needs redoing
+    std::vector<std::uint32_t> dirtyMark; // stamped, so a cell is listed once
+    std::uint32_t dirtyStamp = 0;
+    long rebuilds = 0;
+
+    void rebuild(Field &field, int depth);
+    void markDirty(const Field &field);
+    bool touches(const Field &field, const std::vector<sf::Vector2i> &edited) const;
+    float combined(int cell) const;
+};
+
+inline void ThreatMap::update(const Grid &g, const std::vector<Ghost> &ghosts, bool withTimes)
+{
+    grid = &g;
+    const std::size_t cells = static_cast<std::size_t>(g.getWidth()) * g.getHeight();
+    const bool edited = g.getVersion() != gridVersion;
+    if ((edited && !g.cellsChangedSince(gridVersion, changedCells)) || g.getWidth() != width ||
+        g.getHeight() != height || fields.size() != ghosts.size())
+    {
+        width = g.getWidth();
+        height = g.getHeight();
+        gridVersion = g.getVersion();
+        fields.assign(ghosts.size(), Field());
+        dirtyMark.assign(cells, 0);
+        dirtyStamp = 0;
+        masks = PassMasks::of(g);
+        time.clear();
+        timesValid = false;
+        changedCells.clear();
+    }
+
+    if (++dirtyStamp == 0) // wrapped: clear old stamps
+    {
+        std::fill(dirtyMark.begin(), dirtyMark.end(), 0);
+        dirtyStamp = 1;
+    }
+    dirty.clear();
+
+    if (g.getVersion() != gridVersion) // a few tiles edited: redo only the fields they reach
+    {
+        gridVersion = g.getVersion();
+        masks = PassMasks::of(g);
+        for (Field &field : fields)
+        {
+            if (!field.threat || field.stale || !touches(field, changedCells))
+                continue;
+            if (timesValid)
+                markDirty(field); // where it could reach before
+            field.stale = true;
+        }
+        changedCells.clear();
+    }
+
+    for (std::size_t i = 0; i < ghosts.size(); ++i)
+    {
+        const Ghost &ghost = ghosts[i];
+        Field &field = fields[i];
+        const bool live = ghost.getState() == GhostState::NORMAL && !ghost.getIsEaten();
+        const sf::Vector2i source = ghost.getNextTile();
+        const bool moved = live != field.live || (live && source != field.source);
+        const bool faster = live && ghost.getMovementSpeed() != field.secondsPerTile;
+        if (!moved && !faster)
+            continue;
+
+        if (timesValid)
+            markDirty(field); // where it could reach before
+        field.live = live;
+        field.source = source;
+        field.threat = live && g.isValidPosition(source.x, source.y);
+        field.secondsPerTile = ghost.getMovementSpeed();
+        field.stale = field.stale || moved;
+    }
+
+    if (!withTimes)
+    {
+        timesValid = false; // changes not followed: start over next time
+        return;
+    }
+
+    for (std::size_t i = 0; i < fields.size(); ++i)
+    {
+        if (!fields[i].stale)
+            continue;
+        prepare(static_cast<int>(i));
+        if (timesValid)
+            markDirty(fields[i]); // ...and where it can now
+    }
+    if (!timesValid)
+    {
+        time.resize(cells);
+        for (std::size_t c = 0; c < cells; ++c)
+            time[c] = combined(static_cast<int>(c));
+        timesValid = true;
+        return;
+    }
+    for (int cell : dirty)
+        time[cell] = combined(cell);
+}
+
+inline void ThreatMap::prepare(int ghost, int depth)
+{
+    depth = std::min(depth, MAX_DEPTH);
+    Field &field = fields[ghost];
+    if (field.stale || (field.threat && field.depth < depth))
+        rebuild(field, depth);
+}
+
+inline float ThreatMap::combined(int cell) const
+{
+    float best = std::numeric_limits<float>::infinity();
+    for (const Field &field : fields)
+    {
+        if (!field.steps.empty() && field.steps[cell] != UNREACHED)
+            best = std::min(best, field.steps[cell] * field.secondsPerTile);
+    }
+    return best;
+}
+
+// Bounded BFS from the field's source (none for a dead or off-board ghost).
+inline void ThreatMap::rebuild(Field &field, int depth)
+{
+    ++rebuilds;
+    field.stale = false;
+    field.depth = depth;
+    if (!field.threat)
+    {
+        field.steps.clear();
+        field.reached.clear();
+        return;
+    }
+    // Only the cells the last BFS reached need wiping.
+    if (field.steps.size() != static_cast<std::size_t>(width) * height)
+        field.steps.assign(static_cast<std::size_t>(width) * height, UNREACHED);
+    for (int cell : field.reached)
+        field.steps[cell] = UNREACHED;
+    field.reached.clear();
+
+    // Bit-parallel BFS (BitFlood.h), a layer of tiles at a time.
+    BitFlood &bfs = BitFlood::scratch();
+    bfs.flood(masks->ghosts, field.source, depth);
+    for (int d = 0; d <= bfs.getDepth(); ++d)
+    {
+        bfs.forEachCell(d, [&](int x, int y)
+        {
+            int cell = y * width + x;
+            field.steps[cell] = static_cast<std::uint8_t>(d);
+            field.reached.push_back(cell);
+        });
+    }
+}
+
+// Can an edit to these tiles change the field? Only if the BFS reached one
+// of them, or stopped next to one short of its depth (a tile that opened up
+// there would have been walked into).
+inline bool ThreatMap::touches(const Field &field, const std::vector<sf::Vector2i> &edited) const
+{
+    static const int dx[4] = {0, 0, -1, 1};
+    static const int dy[4] = {-1, 1, 0, 0};
+    for (const sf::Vector2i &t : edited)
+    {
+        if (field.steps[t.y * width + t.x] != UNREACHED)
+            return true;
+        for (int d = 0; d < 4; ++d)
+        {
+            int nx = t.x + dx[d], ny = t.y + dy[d];
+            if (nx >= 0 && ny >= 0 && nx < width && ny < height && field.steps[ny * width + nx] < field.depth)
+                return true;
+        }
+    }
+    return false;
+}
+
+inline void ThreatMap::markDirty(const Field &field)
+{
+    for (int cell : field.reached)
+    {
+        if (dirtyMark[cell] == dirtyStamp)
+            continue;
+        dirtyMark[cell] = dirtyStamp;
+        dirty.push_back(cell);
+    }
+}
+
+#endif // THREATMAP_H
@@ -0,0 +1,220 @@
+#ifndef TILECLASSIFIER_H
+#define TILECLASSIFIER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TILECLASSIFIER_SSE2 1
+#endif
+
+// Enum for image tile types
+enum class ImageTileType : std::uint8_t
+{
+    WALL,         // Blue
+    PELLET,       // Orange
+    POWER_PELLET, // Red
+    EMPTY,        // Brown (walkable floor), or anything far from the legend
+    PLAYER_START, // Cyan
+    GHOST_SPAWN,  // Green
+    GHOST_DOOR,   // Magenta (ghost-only gate)
+    SCOREBOARD,   // Grey
+    TELEPORT      // Pink (side-to-side tunnel)
+};
+
+// The one canonical colour legend for authoring maps. Each map tile is drawn
+// in one of these colours; add a row here to add a tile type.
+struct MazeLegendEntry
+{
+    int r, g, b;
+    ImageTileType type;
+};
+
+static const MazeLegendEntry MAZE_LEGEND[] = {
+    {0, 14, 214, ImageTileType::WALL},          // blue
+    {255, 126, 0, ImageTileType::PELLET},       // orange
+    {70, 70, 70, ImageTileType::SCOREBOARD},    // grey
+    {156, 90, 60, ImageTileType::EMPTY},        // brown = walkable floor
+    {168, 230, 29, ImageTileType::GHOST_SPAWN}, // yellow-green
+    {237, 28, 36, ImageTileType::POWER_PELLET}, // red
+    {0, 183, 239, ImageTileType::PLAYER_START}, // cyan
+    {255, 0, 255, ImageTileType::GHOST_DOOR},   // magenta
+    {255, 163, 177, ImageTileType::TELEPORT},   // pink = side-to-side tunnel
+};
+
+// How far (squared RGB distance) a colour may stray from a legend entry and
+// still match it.
+static const int LEGEND_MAX_DIST_SQ = 100 * 100;
+
+// Classify a pixel to the NEAREST legend colour (squared RGB distance). This is
+// what makes maps robust: a colour only has to be *close* to a legend entry, not
+// an exact match. Anything farther than MAX_DIST from every entry is EMPTY floor.
+static inline ImageTileType getTileTypeFromColor(const sf::Color &color)
+{
+    int bestDistSq = LEGEND_MAX_DIST_SQ + 1;
+    ImageTileType best = ImageTileType::EMPTY;
+
+    for (const MazeLegendEntry &e : MAZE_LEGEND)
+    {
+        int dr = static_cast<int>(color.r) - e.r;
+        int dg = static_cast<int>(color.g) - e.g;
+        int db = static_cast<int>(color.b) - e.b;
+        int distSq = dr * dr + dg * dg + db * db;
+        if (distSq < bestDistSq)
+        {
+            bestDistSq = distSq;
+            best = e.type;
+        }
+    }
+    return best;
+}
+
+// getTileTypeFromColor, but table-driven. Colours are quantised to 5 bits per
+// channel (a 32 KiB table); each entry holds the answer for its whole 8x8x8
+// RGB box. Boxes that straddle a legend boundary are marked AMBIGUOUS and fall
+// back to the exact search, so results always match getTileTypeFromColor
+// bit for bit — the table only skips work where the answer cannot change.
+class TileClassifier
+{
+public:
+    static constexpr int QUANT_BITS = 5;
+    static constexpr int QUANT_SHIFT = 8 - QUANT_BITS;
+    static constexpr std::uint8_t AMBIGUOUS = 0xFF;
+
+    // Built once on first use (thread-safe static init).
+    static const TileClassifier &instance()
+    {
+        static const TileClassifier table;
+        return table;
+    }
+
+    ImageTileType classify(std::uint8_t r, std::uint8_t g, std::uint8_t b) const
+    {
+        std::uint8_t t = lut[lutIndex(r, g, b)];
+        if (t != AMBIGUOUS)
+            return static_cast<ImageTileType>(t);
+        return getTileTypeFromColor(sf::Color(r, g, b));
+    }
+
+    // Classify `count` RGBA pixels (sf::Image::getPixelsPtr layout) into out[].
+    void classifyRow(const sf::Uint8 *rgba, std::size_t count, ImageTileType *out) const;
+
+    // Share of table entries that need the exact fallback (for diagnostics).
+    double ambiguousFraction() const;
+
+private:
+    std::vector<std::uint8_t> lut;
+
+    static std::size_t lutIndex(std::uint8_t r, std::uint8_t g, std::uint8_t b)
+    {
+        return (static_cast<std::size_t>(r >> QUANT_SHIFT) << (2 * QUANT_BITS)) |
+               (static_cast<std::size_t>(g >> QUANT_SHIFT) << QUANT_BITS) | (b >> QUANT_SHIFT);
+    }
+
+    TileClassifier();
+};
+
+inline TileClassifier::TileClassifier() : lut(std::size_t{1} << (3 * QUANT_BITS), AMBIGUOUS)
+{
+    const int span = (1 << QUANT_SHIFT) - 1; // box covers [lo, lo + span] per channel
+    for (int qr = 0; qr < (1 << QUANT_BITS); ++qr)
+    {
+        for (int qg = 0; qg < (1 << QUANT_BITS); ++qg)
+        {
+            for (int qb = 0; qb < (1 << QUANT_BITS); ++qb)
+            {
+                int lo[3] = {qr << QUANT_SHIFT, qg << QUANT_SHIFT, qb << QUANT_SHIFT};
+
+                // Every legend region (Voronoi cell clipped to the match ball) is
+                // convex, so a box whose 8 corners agree on a legend type lies
+                // wholly inside that region.
+                ImageTileType first = getTileTypeFromColor(sf::Color(lo[0], lo[1], lo[2]));
+                bool agree = true;
+                for (int c = 1; c < 8 && agree; ++c)
+                {
+                    sf::Color corner(static_cast<sf::Uint8>(lo[0] + ((c & 1) ? span : 0)),
+                                     static_cast<sf::Uint8>(lo[1] + ((c & 2) ? span : 0)),
+                                     static_cast<sf::Uint8>(lo[2] + ((c & 4) ? span : 0)));
+                    agree = getTileTypeFromColor(corner) == first;
+                }
+                if (!agree)
+                    continue;
+
+                // "Nothing matched" (EMPTY by distance) is not convex; only trust
+                // it when the box stays clear of every legend ball. The brown
+                // floor entry is EMPTY too, but also matched by distance.
+                if (first == ImageTileType::EMPTY)
+                {
+                    for (const MazeLegendEntry &e : MAZE_LEGEND)
+                    {
+                        if (e.type == ImageTileType::EMPTY)
+                            continue;
+                        int c[3] = {e.r, e.g, e.b};
+                        int distSq = 0;
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            int d = c[k] < lo[k] ? lo[k] - c[k] : (c[k] > lo[k] + span ? c[k] - lo[k] - span : 0);
+                            distSq += d * d;
+                        }
+                        if (distSq <= LEGEND_MAX_DIST_SQ)
+                        {
+                            agree = false;
+                            break;
+                        }
+                    }
+                    if (!agree)
+                        continue;
+                }
+                lut[(static_cast<std::size_t>(qr) << (2 * QUANT_BITS)) | (qg << QUANT_BITS) | qb] =
+                    static_cast<std::uint8_t>(first);
+            }
+        }
+    }
+}
+
+inline void TileClassifier::classifyRow(const sf::Uint8 *rgba, std::size_t count, ImageTileType *out) const
+{
+    std::size_t i = 0;
+#ifdef TILECLASSIFIER_SSE2
+    // Four pixels per step: build the table indices in one register, then
+    // look them up. Pixels load as little-endian 0xAABBGGRR words.
+    static_assert(QUANT_BITS == 5, "SSE2 index math below assumes 5-bit channels");
+    const __m128i channel = _mm_set1_epi32(0xF8); // top 5 bits of a channel
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rgba + 4 * i));
+        __m128i r = _mm_and_si128(px, channel);
+        __m128i g = _mm_and_si128(_mm_srli_epi32(px, 8), channel);
+        __m128i b = _mm_and_si128(_mm_srli_epi32(px, 16), channel);
+        // (r >> 3) << 10 | (g >> 3) << 5 | (b >> 3)
+        __m128i idx = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 7), _mm_slli_epi32(g, 2)), _mm_srli_epi32(b, 3));
+
+        alignas(16) std::uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(lanes), idx);
+        for (int k = 0; k < 4; ++k)
+        {
+            std::uint8_t t = lut[lanes[k]];
+            const sf::Uint8 *p = rgba + 4 * (i + k);
+            out[i + k] = t != AMBIGUOUS ? static_cast<ImageTileType>(t) : getTileTypeFromColor(sf::Color(p[0], p[1], p[2]));
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const sf::Uint8 *p = rgba + 4 * i;
+        out[i] = classify(p[0], p[1], p[2]);
+    }
+}
+
+inline double TileClassifier::ambiguousFraction() const
+{
+    std::size_t n = 0;
+    for (std::uint8_t t : lut)
+        n += (t == AMBIGUOUS);
+    return static_cast<double>(n) / lut.size();
+}
+
+#endif // TILECLASSIFIER_H
@@ -0,0 +1,66 @@
+#ifndef TILEEVENTS_H
+#define TILEEVENTS_H
+
+#include <SFML/System.hpp>
+#include <vector>
+
+// Tile boundary crossings, so the rules that depend on where an actor stands
+// (pellets, fruit, a returning ghost reaching home) are resolved once, when
+// it gets there, instead of being re-checked every frame it stands still.
+//
+// Actors report their own crossings: LEAVE when a move away from a tile
+// starts, ENTER when they arrive on one (a tunnel warp is a LEAVE and an
+// ENTER at once). Like TimerWheel, the queue that collects them is installed
+// for the thread while a game updates, so actors need no pointer back to it;
+// with none installed (e.g. a bare actor in a tool) the events are dropped.
+struct TileEvent
+{
+    enum Kind
+    {
+        LEAVE,
+        ENTER
+    };
+    static constexpr int MUNCHER = -1; // `actor` for the muncher; ghosts use their index
+
+    Kind kind;
+    int actor;
+    sf::Vector2i tile;
+};
+
+class TileEvents
+{
+public:
+    void push(TileEvent::Kind kind, int actor, sf::Vector2i tile) { events.push_back(TileEvent{kind, actor, tile}); }
+    const std::vector<TileEvent> &pending() const { return events; }
+    bool empty() const { return events.empty(); }
+    void clear() { events.clear(); }
+
+    // Report a crossing to the installed queue (no-op without one).
+    static void emit(TileEvent::Kind kind, int actor, sf::Vector2i tile)
+    {
+        if (TileEvents *queue = installed())
+            queue->push(kind, actor, tile);
+    }
+
+    class Scope
+    {
+        TileEvents *previous;
+
+    public:
+        explicit Scope(TileEvents &queue) : previous(installed()) { installed() = &queue; }
+        ~Scope() { installed() = previous; }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+private:
+    std::vector<TileEvent> events;
+
+    static TileEvents *&installed()
+    {
+        static thread_local TileEvents *queue = nullptr;
+        return queue;
+    }
+};
+
+#endif // TILEEVENTS_H
@@ -0,0 +1,304 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Deadlines on game time, so nothing is polled while it is not due: schedule
+// an event for a game time, and advance() hands it back once game time gets
+// there. Events are plain values (kind + data), not callbacks, so a wheel can
+// be copied with the game it belongs to (GameSession::fork).
+//
+// Hierarchical timer wheel: 1 ms ticks, four levels of 64 slots (about 4.6
+// hours of game time; later deadlines wait on an overflow list). A timer sits
+// in the level of the highest 6-bit tick group where its tick differs from the
+// current one, and drops a level each time the wheel reaches its slot. An
+// occupancy mask per level lets advance() jump straight to the next occupied
+// slot, so a frame with nothing due only touches a few words. Timers fire
+// exactly when game time reaches their deadline (the tick only picks the slot).
+class TimerWheel
+{
+public:
+    using TimerId = std::uint64_t; // 0 = none
+
+    struct Event
+    {
+        TimerId id;
+        int kind;
+        int data;
+        sf::Time due;
+    };
+
+    TimerWheel();
+
+    // Fire `kind`/`data` once game time reaches `due` (a deadline already past
+    // fires on the next advance). Returns a handle for cancel().
+    TimerId schedule(sf::Time due, int kind, int data = 0);
+    TimerId scheduleIn(sf::Time delay, int kind, int data = 0) { return schedule(now + delay, kind, data); }
+    bool cancel(TimerId id); // false if it already fired or was cancelled
+    bool isPending(TimerId id) const;
+
+    // Game time is now `time`: append every timer due by then to `fired`, in
+    // deadline order (ties in schedule order). Time never runs backwards.
+    void advance(sf::Time time, std::vector<Event> &fired);
+
+    sf::Time getNow() const { return now; }
+    std::size_t size() const { return live; }
+
+    // The wheel entity code schedules on while a game updates on this thread
+    // (like PausableClock::SimulatedTime): actors restart their own timers on
+    // it without holding a pointer to their game. Null outside any scope.
+    class Scope
+    {
+        TimerWheel *previous;
+
+    public:
+        explicit Scope(TimerWheel &wheel) : previous(installed()) { installed() = &wheel; }
+        ~Scope() { installed() = previous; }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+    static TimerWheel *active() { return installed(); }
+
+private:
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr int LEVELS = 4;
+    static constexpr std::int64_t TICK_MICROS = 1000;
+    static constexpr int OVERFLOW_LIST = LEVELS * SLOTS; // past the top level
+    static constexpr int NEAR_LIST = OVERFLOW_LIST + 1;  // in a tick already passed, not yet due
+    static constexpr int LIST_COUNT = NEAR_LIST + 1;
+
+    struct Node
+    {
+        sf::Time due;
+        std::uint32_t seq = 0; // schedule order; also checks handles
+        int kind = 0;
+        int data = 0;
+        std::int32_t prev = -1, next = -1;
+        std::int32_t list = -1; // -1 = free
+    };
+
+    std::vector<Node> nodes;
+    std::vector<std::int32_t> freeNodes;
+    std::int32_t heads[LIST_COUNT];
+    std::uint64_t occupied[LEVELS] = {}; // bit per non-empty slot
+    std::int64_t current = 0;            // last tick processed
+    sf::Time now;
+    std::uint32_t nextSeq = 1;
+    std::size_t live = 0;
+
+    static TimerWheel *&installed()
+    {
+        static thread_local TimerWheel *wheel = nullptr;
+        return wheel;
+    }
+    static std::int64_t tickOf(sf::Time t)
+    {
+        std::int64_t us = t.asMicroseconds();
+        return us > 0 ? us / TICK_MICROS : 0;
+    }
+
+    void link(std::int32_t index, int list);
+    void unlink(std::int32_t index);
+    void place(std::int32_t index, bool cascading);
+    void reinsert(int list);
+    void fire(std::int32_t index, std::vector<Event> &fired);
+};
+
+inline TimerWheel::TimerWheel()
+{
+    std::fill(heads, heads + LIST_COUNT, -1);
+}
+
+inline TimerWheel::TimerId TimerWheel::schedule(sf::Time due, int kind, int data)
+{
+    std::int32_t index;
+    if (!freeNodes.empty())
+    {
+        index = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::int32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+    Node &n = nodes[index];
+    n.due = due;
+    n.seq = nextSeq++;
+    if (nextSeq == 0)
+        nextSeq = 1; // 0 never names a timer
+    n.kind = kind;
+    n.data = data;
+    place(index, false);
+    ++live;
+    return static_cast<TimerId>(n.seq) << 32 | static_cast<std::uint32_t>(index);
+}
+
+inline bool TimerWheel::isPending(TimerId id) const
+{
+    std::uint32_t index = static_cast<std::uint32_t>(id);
+    return id != 0 && index < nodes.size() && nodes[index].list >= 0 &&
+           nodes[index].seq == static_cast<std::uint32_t>(id >> 32);
+}
+
+inline bool TimerWheel::cancel(TimerId id)
+{
+    if (!isPending(id))
+        return false;
+    std::int32_t index = static_cast<std::int32_t>(static_cast<std::uint32_t>(id));
+    unlink(index);
+    freeNodes.push_back(index);
+    --live;
+    return true;
+}
+
+inline void TimerWheel::advance(sf::Time time, std::vector<Event> &fired)
+{
+    if (time > now)
+        now = time;
+    std::size_t first = fired.size();
+
+    // Leftovers from the tick the last advance stopped in.
+    for (std::int32_t i = heads[NEAR_LIST]; i >= 0;)
+    {
+        std::int32_t next = nodes[i].next;
+        if (nodes[i].due <= now)
+            fire(i, fired);
+        i = next;
+    }
+
+    const std::int64_t target = tickOf(now);
+    while (current < target)
+    {
+        // Next occupied level-0 slot in this 64-tick window, else the window's
+        // end (where the upper levels cascade down).
+        int offset = static_cast<int>(current & (SLOTS - 1));
+        std::uint64_t ahead = offset == SLOTS - 1 ? 0 : occupied[0] & (~0ULL << (offset + 1));
+        std::int64_t next = ahead ? (current & ~std::int64_t(SLOTS - 1)) + __builtin_ctzll(ahead)
+                                  : (current | (SLOTS - 1)) + 1;
+        if (next > target)
+        {
+            current = target;
+            break;
+        }
+        current = next;
+
+        if ((current & (SLOTS - 1)) == 0)
+        {
+            // Highest level first, so its timers can land in the slots below.
+            if ((current & ((std::int64_t(1) << (SLOT_BITS * LEVELS)) - 1)) == 0)
+                reinsert(OVERFLOW_LIST);
+            for (int level = LEVELS - 1; level >= 1; --level)
+            {
+                if ((current & ((std::int64_t(1) << (SLOT_BITS * level)) - 1)) == 0)
+                    reinsert(level * SLOTS + static_cast<int>((current >> (SLOT_BITS * level)) & (SLOTS - 1)));
+            }
+        }
+
+        int slot = static_cast<int>(current & (SLOTS - 1));
+        for (std::int32_t i = heads[slot]; i >= 0;)
+        {
+            std::int32_t nextNode = nodes[i].next;
+            if (nodes[i].due <= now)
+                fire(i, fired);
+            else
+            {
+                unlink(i); // due later within the tick we stop in
+                link(i, NEAR_LIST);
+            }
+            i = nextNode;
+        }
+    }
+
+    std::sort(fired.begin() + first, fired.end(), [](const Event &a, const Event &b) {
+        return a.due != b.due ? a.due < b.due : static_cast<std::uint32_t>(a.id >> 32) < static_cast<std::uint32_t>(b.id >> 32);
+    });
+}
+
+inline void TimerWheel::link(std::int32_t index, int list)
+{
+    Node &n = nodes[index];
+    n.list = list;
+    n.prev = -1;
+    n.next = heads[list];
+    if (n.next >= 0)
+        nodes[n.next].prev = index;
+    heads[list] = index;
+    if (list < OVERFLOW_LIST)
+        occupied[list / SLOTS] |= 1ULL << (list % SLOTS);
+}
+
+inline void TimerWheel::unlink(std::int32_t index)
+{
+    Node &n = nodes[index];
+    if (n.prev >= 0)
+        nodes[n.prev].next = n.next;
+    else
+        heads[n.list] = n.next;
+    if (n.next >= 0)
+        nodes[n.next].prev = n.prev;
+    if (n.list < OVERFLOW_LIST && heads[n.list] < 0)
+        occupied[n.list / SLOTS] &= ~(1ULL << (n.list % SLOTS));
+    n.list = -1;
+}
+
+// Slot for a timer relative to the current tick. Scheduling into a tick the
+// wheel has already passed goes to the near list; cascading timers are never
+// behind the tick being processed.
+inline void TimerWheel::place(std::int32_t index, bool cascading)
+{
+    std::int64_t tick = tickOf(nodes[index].due);
+    if (tick < current || (tick == current && !cascading))
+    {
+        link(index, NEAR_LIST);
+        return;
+    }
+    std::int64_t differ = tick ^ current;
+    for (int level = 0; level < LEVELS; ++level)
+    {
+        if (differ < (std::int64_t(1) << (SLOT_BITS * (level + 1))))
+        {
+            link(index, level * SLOTS + static_cast<int>((tick >> (SLOT_BITS * level)) & (SLOTS - 1)));
+            return;
+        }
+    }
+    link(index, OVERFLOW_LIST);
+}
+
+inline void TimerWheel::reinsert(int list)
+{
+    std::int32_t i = heads[list];
+    heads[list] = -1;
+    if (list < OVERFLOW_LIST)
+        occupied[list / SLOTS] &= ~(1ULL << (list % SLOTS));
+    while (i >= 0)
+    {
+        std::int32_t next = nodes[i].next;
+        place(i, true);
+        i = next;
+    }
+}
+
+inline void TimerWheel::fire(std::int32_t index, std::vector<Event> &fired)
+{
+    const Node &n = nodes[index];
+    fired.push_back(Event{static_cast<TimerId>(n.seq) << 32 | static_cast<std::uint32_t>(index), n.kind, n.data, n.due});
+    unlink(index);
+    freeNodes.push_back(index);
+    --live;
+}
+
+// What the game's timers are for: Event::kind on GameSession's wheel.
+enum GameTimer
+{
+    FRUIT_DUE,     // time for the next fruit
+    DEATH_OVER,    // the death animation has played
+    MUNCHER_FRAME, // next muncher animation frame
+    GHOST_FRAME    // next animation frame of ghost `data`
+};
+
+#endif // TIMERWHEEL_H
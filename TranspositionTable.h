@@ -0,0 +1,112 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Fixed-size cache of search results keyed by a 64-bit state hash (Zobrist.h),
+// so work on a state that lookahead has already been through is looked up
+// instead of redone. Rollouts especially keep walking through the same
+// states: each decision's playouts retrace the previous decision's.
+//
+// Lock-free and safe to share between threads: an entry is its payload words
+// plus a check word (key XOR every payload word), all relaxed atomics. A
+// reader only accepts an entry whose check matches its own key, so one that
+// another thread is halfway through writing reads as a miss, never as a
+// mix of two results. A new result always replaces what was in its slot.
+//
+// T must be trivially copyable and a whole number of 64-bit words.
+template <typename T>
+class TranspositionTable
+{
+    static_assert(std::is_trivially_copyable<T>::value, "TranspositionTable payloads are copied as raw words");
+    static_assert(sizeof(T) % sizeof(std::uint64_t) == 0, "pad the payload to whole 64-bit words");
+    static constexpr std::size_t WORDS = sizeof(T) / sizeof(std::uint64_t);
+
+public:
+    // 2^bits entries (clamped to 10..26).
+    explicit TranspositionTable(int bits = 16);
+
+    bool probe(std::uint64_t key, T &out) const;
+    void store(std::uint64_t key, const T &value);
+    void clear();
+
+    std::size_t capacity() const { return mask + 1; }
+    long getProbes() const { return probes.load(std::memory_order_relaxed); }
+    long getHits() const { return hits.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry
+    {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> words[WORDS];
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    std::size_t mask;
+    mutable std::atomic<long> probes{0};
+    mutable std::atomic<long> hits{0};
+};
+
+template <typename T>
+TranspositionTable<T>::TranspositionTable(int bits)
+{
+    bits = bits < 10 ? 10 : (bits > 26 ? 26 : bits);
+    mask = (std::size_t{1} << bits) - 1;
+    entries.reset(new Entry[mask + 1]);
+    clear();
+}
+
+template <typename T>
+bool TranspositionTable<T>::probe(std::uint64_t key, T &out) const
+{
+    probes.fetch_add(1, std::memory_order_relaxed);
+    const Entry &e = entries[key & mask];
+    std::uint64_t raw[WORDS];
+    std::uint64_t check = e.check.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < WORDS; ++i)
+    {
+        raw[i] = e.words[i].load(std::memory_order_relaxed);
+        check ^= raw[i];
+    }
+    if (check != key)
+        return false; // empty, another state, or torn by a concurrent store
+    std::memcpy(&out, raw, sizeof(T));
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+template <typename T>
+void TranspositionTable<T>::store(std::uint64_t key, const T &value)
+{
+    Entry &e = entries[key & mask];
+    std::uint64_t raw[WORDS];
+    std::memcpy(raw, &value, sizeof(T));
+    std::uint64_t check = key;
+    for (std::size_t i = 0; i < WORDS; ++i)
+    {
+        e.words[i].store(raw[i], std::memory_order_relaxed);
+        check ^= raw[i];
+    }
+    e.check.store(check, std::memory_order_relaxed);
+}
+
+template <typename T>
+void TranspositionTable<T>::clear()
+{
+    // Slot i empty = zero payload checked against key ~i, which never
+    // lands in slot i, so an empty slot can't answer a probe.
+    for (std::size_t i = 0; i <= mask; ++i)
+    {
+        for (std::size_t w = 0; w < WORDS; ++w)
+            entries[i].words[w].store(0, std::memory_order_relaxed);
+        entries[i].check.store(~static_cast<std::uint64_t>(i), std::memory_order_relaxed);
+    }
+    probes.store(0, std::memory_order_relaxed);
+    hits.store(0, std::memory_order_relaxed);
+}
+
+#endif // TRANSPOSITIONTABLE_H
@@ -0,0 +1,46 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// Single-producer / single-consumer handoff of whole values without locks.
+// Three slots: the writer fills its own, publish() swaps it with the shared
+// middle slot, and the reader swaps the middle slot into its own when
+// update() sees something fresh. Neither side ever waits for the other; the
+// reader always gets the newest complete value and skipped ones are simply
+// overwritten, which is what a per-frame snapshot wants.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Producer side.
+    T &writeBuffer() { return slots[writeIndex]; }
+    void publish()
+    {
+        unsigned old = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel);
+        writeIndex = old & INDEX;
+    }
+
+    // Consumer side: true if a newer value was swapped in.
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_acquire) & FRESH))
+            return false;
+        unsigned old = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = old & INDEX;
+        return true;
+    }
+    bool hasFresh() const { return (middle.load(std::memory_order_acquire) & FRESH) != 0; }
+    const T &readBuffer() const { return slots[readIndex]; }
+
+private:
+    static constexpr unsigned INDEX = 3;
+    static constexpr unsigned FRESH = 4;
+
+    T slots[3]{};
+    std::atomic<unsigned> middle{1};
+    unsigned writeIndex = 0; // producer-owned
+    unsigned readIndex = 2;  // consumer-owned
+};
+
+#endif // TRIPLEBUFFER_H
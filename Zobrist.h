@@ -0,0 +1,41 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// Keys for the 64-bit game-state hash (GameSession::getHash). A state hashes
+// to the XOR of one key per feature it has (a pellet on a cell, the muncher
+// on a tile heading some way, the AI mode, ...), so a change to one feature
+// is one XOR out and one XOR in, whatever the rest of the board holds.
+//
+// Keys are computed (splitmix64 of the feature and its values) rather than
+// drawn into tables up front, so any board size or ghost roster works with
+// no setup and every build and platform agrees on them.
+enum class ZobristFeature : std::uint64_t
+{
+    PELLET = 1,   // a: cell
+    POWER_PELLET, // a: cell
+    MUNCHER,      // a: next tile (cell), b: heading
+    GHOST,        // a: ghost index, b: next tile, heading, state, eaten
+    MODE,         // a: AIMode
+    LEVEL,        // a: level
+    FRUIT,        // a: showing
+    MAP,          // a: map version (live reloads)
+    SALT          // a, b: whatever a reader folds in (e.g. search settings)
+};
+
+// splitmix64's finaliser: every input bit reaches every output bit.
+inline std::uint64_t zobristMix(std::uint64_t z)
+{
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline std::uint64_t zobristKey(ZobristFeature feature, std::uint64_t a, std::uint64_t b = 0)
+{
+    return zobristMix(zobristMix((static_cast<std::uint64_t>(feature) << 56) ^ a) ^ b);
+}
+
+#endif // ZOBRIST_H
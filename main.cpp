@@ -2,6 +2,16 @@
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
+#include <cstdio>
+#include <cctype>
+#include <string>
+#include <sstream>
+#include <filesystem>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include "Maze.h"
 #include "PelletGrid.h"
 #include "Pellet.h"
@@ -11,82 +21,475 @@
 #include "Spookie_Chase.h"
 #include "GameConfig.h"
 #include "PausableClock.h"
+#include "GridRenderer.h"
+#include "Camera.h"
+#include "MazeGenerator.h"
+#include "MapWatcher.h"
+#include "AsyncGhostAI.h"
+#include "GameSession.h"
+#include "MuncherBot.h"
+#include "DifficultyCurve.h"
+#include "AITrace.h"
+#include "GameBatch.h"
+#include "ThreatMap.h"
+#include "Replay.h"
+
+// Command-line options. With no arguments the game loads GameConfig::MAZE_IMAGE
+// on the authentic 28x31 board, exactly as before (from its compiled .pmm when
+// one is up to date).
+struct LaunchOptions
+{
+    std::string mapPath = GameConfig::MAZE_IMAGE;
+    bool customMap = false; // --map given: size the board from the image
+    int gridWidth = GameConfig::GRID_WIDTH;
+    int gridHeight = GameConfig::GRID_HEIGHT;
+    bool sizeGiven = false;
+    bool generate = false;  // --generate WxH: procedural board instead of a map file
+    bool authoring = false; // --authoring: always read the PNG, ignore compiled maps
+    bool watch = true;      // --no-watch: don't live-reload the map file when it changes
+    long ghostSearchMicros = 0; // --ghost-search [us]: lookahead budget per ghost decision
+    bool asyncAI = false;       // --async-ai: ghost decisions on a worker thread
+    bool bot = false;           // --bot [0-10]: the muncher plays itself
+    int botStrength = 10;
+    int botRollouts = 0;        // --bot-rollouts [frames]: bot plays openings out on forks
+    int headlessGames = 0;      // --headless [games]: bot games with no window, then exit
+    int lockstep = 0;           // --lockstep [lanes]: headless games stepped together in batches (GameBatch)
+    std::string difficultyPath; // --difficulty file: per-level curve (tools/tune.cpp)
+    std::string aiTracePath;    // --ai-trace [file]: record ghost AI decisions + counters, dumped at exit
+    int ghostCount = 0;         // --ghosts N: ghost swarm size (0 = the classic four)
+    std::string personalities;  // --personalities a,b,..: ghost kinds, cycled over the ghosts
+    std::string recordPath;     // --record file.pmr: headless games saved as replays (tools/replay.cpp)
+    std::string checksumLogPath; // --checksum-log file: headless state checksums, one line per checkpoint
+    int checksumEvery = 60;      // --checksum-every N: frames between checksums
+    unsigned long long seed = 1;
+    bool helpRequested = false;  // --help / -h: usage printed, exit successfully
+};
+
+// The compiled map that shadows an authoring PNG: same name, .pmm extension.
+static std::string compiledMapPath(const std::string &imagePath)
+{
+    return std::filesystem::path(imagePath).replace_extension(".pmm").string();
+}
+
+// Use the compiled map unless it is missing or older than the PNG it came from
+// (a freshly painted PNG wins until `make maps` is re-run).
+static bool compiledMapIsCurrent(const std::string &imagePath, const std::string &mapPath)
+{
+    std::error_code ec;
+    auto mapTime = std::filesystem::last_write_time(mapPath, ec);
+    if (ec)
+        return false;
+    auto imageTime = std::filesystem::last_write_time(imagePath, ec);
+    if (!ec && imageTime > mapTime)
+    {
+        std::cout << mapPath << " is older than " << imagePath << "; loading the PNG (run `make maps`)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool parseOptions(int argc, char **argv, LaunchOptions &opts)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--map" && i + 1 < argc)
+        {
+            opts.mapPath = argv[++i];
+            opts.customMap = true;
+        }
+        else if (arg == "--size" && i + 1 < argc)
+        {
+            // WxH in tiles, for maps painted at more than one pixel per tile.
+            int w = 0, h = 0;
+            if (std::sscanf(argv[++i], "%dx%d", &w, &h) == 2 && w > 2 && h > 2)
+            {
+                opts.gridWidth = w;
+                opts.gridHeight = h;
+                opts.sizeGiven = true;
+            }
+            else
+                std::cout << "Ignoring bad --size (expected WxH, e.g. 1024x1024)" << std::endl;
+        }
+        else if (arg == "--generate" && i + 1 < argc)
+        {
+            int w = 0, h = 0;
+            if (std::sscanf(argv[++i], "%dx%d", &w, &h) == 2)
+            {
+                opts.gridWidth = w;
+                opts.gridHeight = h;
+                opts.generate = true;
+            }
+            else
+                std::cout << "Ignoring bad --generate (expected WxH, e.g. 256x256)" << std::endl;
+        }
+        else if (arg == "--authoring")
+        {
+            opts.authoring = true;
+        }
+        else if (arg == "--no-watch")
+        {
+            opts.watch = false;
+        }
+        else if (arg == "--ghost-search")
+        {
+            // Optional budget in microseconds; a few hundred keeps four ghosts
+            // far inside one 16 ms frame even when every one is at a junction.
+            opts.ghostSearchMicros = 250;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+                opts.ghostSearchMicros = std::strtol(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--async-ai")
+        {
+            opts.asyncAI = true;
+        }
+        else if (arg == "--bot")
+        {
+            opts.bot = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+                opts.botStrength = std::max(0, std::min(10, std::atoi(argv[++i])));
+        }
+        else if (arg == "--bot-rollouts")
+        {
+            // Frames each opening is played out for; 90 (1.5 s) sees most traps coming.
+            opts.botRollouts = 90;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+                opts.botRollouts = std::atoi(argv[++i]);
+        }
+        else if (arg == "--headless")
+        {
+            opts.headlessGames = 10;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+                opts.headlessGames = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--lockstep")
+        {
+            opts.lockstep = 8;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+                opts.lockstep = std::max(1, std::min(GameBatch::MAX_LANES, std::atoi(argv[++i])));
+        }
+        else if (arg == "--ai-trace")
+        {
+            opts.aiTracePath = "ai_trace.bin";
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                opts.aiTracePath = argv[++i];
+        }
+        else if (arg == "--difficulty" && i + 1 < argc)
+        {
+            opts.difficultyPath = argv[++i];
+        }
+        else if (arg == "--ghosts" && i + 1 < argc)
+        {
+            opts.ghostCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--personalities" && i + 1 < argc)
+        {
+            opts.personalities = argv[++i];
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            opts.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--record" && i + 1 < argc)
+        {
+            opts.recordPath = argv[++i];
+        }
+        else if (arg == "--checksum-log" && i + 1 < argc)
+        {
+            opts.checksumLogPath = argv[++i];
+        }
+        else if (arg == "--checksum-every" && i + 1 < argc)
+        {
+            opts.checksumEvery = std::max(1, std::atoi(argv[++i]));
+        }
+        else
+        {
+            opts.helpRequested = arg == "--help" || arg == "-h";
+            if (!opts.helpRequested)
+                std::cout << "Unknown option: " << arg << std::endl;
+            std::cout << "Usage: munch_maze [--map file.png] [--size WxH] [--generate WxH] [--seed N] [--authoring] [--no-watch] [--ghost-search [us]] [--async-ai]\n"
+                      << "                  [--bot [0-10]] [--bot-rollouts [frames]] [--headless [games]] [--lockstep [lanes]] [--difficulty curve.txt] [--ai-trace [file]]\n"
+                      << "                  [--ghosts N] [--personalities chaser,ambusher,fickle,bashful,interceptor,guard]\n"
+                      << "                  [--record file.pmr] [--checksum-log file] [--checksum-every N]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Ghost line-up from --ghosts / --personalities: the named kinds cycled over
+// N ghosts (N defaults to the number of names; with no names, every
+// registered kind in turn, classic four first). Empty = the classic four.
+static std::vector<int> ghostRoster(const LaunchOptions &opts)
+{
+    std::vector<int> kinds;
+    std::stringstream names(opts.personalities);
+    for (std::string name; std::getline(names, name, ',');)
+    {
+        int id = GhostPersonalities::find(name);
+        if (id >= 0)
+            kinds.push_back(id);
+        else if (!name.empty())
+            std::cout << "Unknown ghost personality: " << name << std::endl;
+    }
+    if (kinds.empty())
+    {
+        if (opts.ghostCount == 0)
+            return kinds;
+        for (int id = 0; id < GhostPersonalities::count(); ++id)
+            kinds.push_back(id);
+    }
+
+    int count = opts.ghostCount > 0 ? opts.ghostCount : static_cast<int>(kinds.size());
+    std::vector<int> roster;
+    for (int i = 0; i < count; ++i)
+        roster.push_back(kinds[i % kinds.size()]);
+    return roster;
+}
+
+static MuncherBot::Settings botSettings(const LaunchOptions &opts, int game)
+{
+    MuncherBot::Settings settings;
+    settings.strength = opts.botStrength / 10.0f;
+    settings.rolloutFrames = opts.botRollouts;
+    settings.seed = static_cast<unsigned>(opts.seed) + game;
+    return settings;
+}
+
+// Where game `game` (0-based) of `games` is recorded: the --record path
+// itself for one game, name-N.pmr for several.
+static std::string replayPath(const std::string &path, int game, int games)
+{
+    if (games <= 1)
+        return path;
+    std::filesystem::path p(path);
+    std::string name = p.stem().string() + "-" + std::to_string(game + 1) + p.extension().string();
+    return (p.parent_path() / name).string();
+}
 
-// Function to draw the maze walls and pellets with clear visual mapping
-void drawGame(sf::RenderWindow &window, const Grid &grid, const PelletGrid &pelletGrid, const SpriteSheet &sheet)
+// --headless: play bot games on simulated time, no window, and report. Each
+// game runs until game over or MAX_GAME_SECONDS of game time, at 60 frames a
+// simulated second (as fast as the CPU allows).
+static int runHeadless(const Grid &grid, const LaunchOptions &opts, const DifficultyCurve &difficulty)
 {
-    // Define clear visual mappings for each tile type
-    sf::RectangleShape wallBlock(sf::Vector2f(GameConfig::CELL_SIZE, GameConfig::CELL_SIZE));
-    wallBlock.setFillColor(sf::Color::Blue); // Classic Pac-Man blue walls
-
-    // Pellet dots drawn from the shared sheet (row 2 cells) instead of circles.
-    sf::Sprite pelletSprite(sheet.getTexture(), SpriteSheet::frameRect(PelletFrame::PELLET));
-    pelletSprite.setScale(GameConfig::SPRITE_SCALE, GameConfig::SPRITE_SCALE);
-
-    // Power pellet drawn much bigger (and centred) so it's unmistakable next to a normal dot.
-    sf::Sprite powerSprite(sheet.getTexture(), SpriteSheet::frameRect(PelletFrame::POWER));
-    powerSprite.setScale(GameConfig::SPRITE_SCALE * 2.5f, GameConfig::SPRITE_SCALE * 2.5f);
-    powerSprite.setOrigin(50.0f, 50.0f); // centre of the 100x100 cell art so it scales in place
-
-    // Add a subtle background grid for empty spaces (optional)
-    sf::RectangleShape emptyBlock(sf::Vector2f(GameConfig::CELL_SIZE, GameConfig::CELL_SIZE));
-    emptyBlock.setFillColor(sf::Color(10, 10, 10)); // Very dark background
-    emptyBlock.setOutlineColor(sf::Color(20, 20, 20));
-    emptyBlock.setOutlineThickness(0.5f);
-
-    for (int y = 0; y < grid.getHeight(); y++)
+    const float MAX_GAME_SECONDS = 20.0f * 60.0f;
+    const sf::Time frame = sf::seconds(1.0f / 60.0f);
+
+    std::cout << "Headless: " << opts.headlessGames << " bot games (strength " << opts.botStrength
+              << (opts.botRollouts ? ", rollouts " + std::to_string(opts.botRollouts) + " frames" : std::string())
+              << ") on " << grid.getWidth() << "x" << grid.getHeight() << std::endl;
+
+    // One trace across every game, so the counters compare whole runs.
+    std::unique_ptr<AITrace> aiTrace;
+    if (!opts.aiTracePath.empty())
+        aiTrace = std::make_unique<AITrace>();
+    const std::vector<int> roster = ghostRoster(opts);
+
+    // Rollout bots share one table of opening scores: every game is on this
+    // map and curve, and playouts keep reaching states other games scored.
+    std::unique_ptr<MuncherBot::OpeningTable> openings;
+    if (opts.botRollouts > 0)
+        openings = std::make_unique<MuncherBot::OpeningTable>(18);
+    auto makeBot = [&](int game)
     {
-        for (int x = 0; x < grid.getWidth(); x++)
+        MuncherBot::Settings settings = botSettings(opts, game);
+        settings.table = openings.get();
+        return MuncherBot(settings);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    long totalFrames = 0;
+    long totalScore = 0;
+    int totalLevels = 0;
+    auto setUp = [&](GameSession &session)
+    {
+        if (!roster.empty())
+            session.setRoster(roster);
+        session.setSearchBudget(opts.ghostSearchMicros);
+        session.setDifficulty(&difficulty);
+        session.setTrace(aiTrace.get());
+    };
+    auto running = [&](const GameSession &session)
+    {
+        return !session.isGameOver() && session.getTime().asSeconds() < MAX_GAME_SECONDS;
+    };
+
+    // Replays and the checksum log (--record, --checksum-log): every game in
+    // flight has a Replay, whose checkpoints are also what the log lists
+    // when the game ends.
+    const bool recording = !opts.recordPath.empty() || !opts.checksumLogPath.empty();
+    if (recording && opts.ghostSearchMicros > 0)
+        std::cout << "Warning: --ghost-search decides on wall-clock time; recorded games will not replay exactly"
+                  << std::endl;
+    std::ofstream checksumLog;
+    if (!opts.checksumLogPath.empty())
+    {
+        checksumLog.open(opts.checksumLogPath);
+        if (!checksumLog)
+            std::cout << "Cannot write checksum log " << opts.checksumLogPath << std::endl;
+        checksumLog << "# game frame checksum";
+        for (int f = 0; f < StateChecksum::FIELDS; ++f)
+            checksumLog << " " << StateChecksum::fieldName(f);
+        checksumLog << "\n";
+    }
+    auto logCheckpoints = [&](const Replay &replay, int game)
+    {
+        if (!checksumLog.is_open())
+            return;
+        checksumLog << std::hex << std::setfill('0');
+        for (const Replay::Checkpoint &c : replay.getCheckpoints())
         {
-            float pixelX = x * GameConfig::CELL_SIZE;
-            float pixelY = y * GameConfig::CELL_SIZE;
+            checksumLog << std::dec << game + 1 << " " << c.frame << std::hex << " " << std::setw(16)
+                        << c.checksum().total();
+            for (int f = 0; f < StateChecksum::FIELDS; ++f)
+                checksumLog << " " << std::setw(16) << c.parts[f];
+            checksumLog << "\n";
+        }
+        checksumLog << std::dec << std::setfill(' ');
+    };
+    auto startRecording = [&](Replay &replay, const GameSession &session, int game)
+    {
+        if (recording)
+            replay.begin(session, roster, difficulty, opts.ghostSearchMicros, frame, opts.checksumEvery,
+                         opts.seed + game);
+    };
+    auto stopRecording = [&](Replay &replay, const GameSession &session, int game)
+    {
+        if (!recording)
+            return;
+        replay.finish(session);
+        logCheckpoints(replay, game); // whole games in order, however they were stepped
+        if (!opts.recordPath.empty())
+            replay.save(replayPath(opts.recordPath, game, opts.headlessGames));
+    };
 
-            // Draw base empty space first
-            emptyBlock.setPosition(pixelX, pixelY);
-            window.draw(emptyBlock);
+    auto report = [&](const GameSession &session, int game)
+    {
+        std::cout << "  game " << game + 1 << ": score " << session.getPoints().getTotalPoints() << ", level "
+                  << session.getLevel() << ", " << static_cast<int>(session.getTime().asSeconds()) << " s"
+                  << (session.isGameOver() ? "" : " (time limit)") << std::endl;
+        totalFrames += session.getFrames();
+        totalScore += session.getPoints().getTotalPoints();
+        totalLevels += session.getLevel();
+    };
 
-            // Priority-based rendering (highest priority last)
-            if (grid.isWall(x, y))
+    if (opts.lockstep > 0)
+    {
+        // Games in batches of `lockstep` lanes, stepped together (same results).
+        for (int first = 0; first < opts.headlessGames; first += opts.lockstep)
+        {
+            GameBatch batch(grid, std::min(opts.lockstep, opts.headlessGames - first));
+            std::vector<MuncherBot> bots;
+            std::vector<Replay> replays(batch.size());
+            for (int i = 0; i < batch.size(); ++i)
             {
-                wallBlock.setPosition(pixelX, pixelY);
-                window.draw(wallBlock);
+                setUp(batch.lane(i));
+                bots.push_back(makeBot(first + i));
+                startRecording(replays[i], batch.lane(i), first + i);
             }
-            // Ghost-spawn, player-start, tunnel, and scoreboard tiles are NOT
-            // drawn — they drive logic only ("the magnet under the table"),
-            // leaving a clean all-black-and-blue board. The score TEXT still
-            // renders on top of the (now dark) scoreboard region below.
-            // Draw pellets and power pellets on top if present
-            if (pelletGrid.hasPowerPellet(x, y))
+            std::vector<bool> active(batch.size(), true);
+            for (bool any = true; any;)
             {
-                powerSprite.setPosition(pixelX + GameConfig::CELL_SIZE / 2.0f, pixelY + GameConfig::CELL_SIZE / 2.0f);
-                window.draw(powerSprite);
+                any = false;
+                for (int i = 0; i < batch.size(); ++i)
+                {
+                    active[i] = running(batch.lane(i));
+                    if (active[i])
+                    {
+                        bots[i].play(batch.lane(i));
+                        if (recording)
+                            replays[i].recordInput(batch.lane(i));
+                    }
+                    any = any || active[i];
+                }
+                if (!any)
+                    break;
+                batch.step(frame, &active);
+                for (int i = 0; recording && i < batch.size(); ++i)
+                {
+                    if (active[i])
+                        replays[i].recordFrame(batch.lane(i));
+                }
             }
-            else if (pelletGrid.hasPellet(x, y))
+            for (int i = 0; i < batch.size(); ++i)
+            {
+                stopRecording(replays[i], batch.lane(i), first + i);
+                report(batch.lane(i), first + i);
+            }
+        }
+    }
+    else
+    {
+        for (int game = 0; game < opts.headlessGames; ++game)
+        {
+            GameSession session = GameSession::headless(grid);
+            setUp(session);
+            MuncherBot bot = makeBot(game);
+            Replay replay;
+            startRecording(replay, session, game);
+            while (running(session))
             {
-                pelletSprite.setPosition(pixelX, pixelY);
-                window.draw(pelletSprite);
+                bot.play(session);
+                if (recording)
+                    replay.recordInput(session);
+                session.step(frame);
+                if (recording)
+                    replay.recordFrame(session);
             }
+            stopRecording(replay, session, game);
+            report(session, game);
         }
     }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Average score " << totalScore / opts.headlessGames << ", average level "
+              << static_cast<double>(totalLevels) / opts.headlessGames << "; " << totalFrames << " frames in "
+              << seconds << " s (" << static_cast<long>(totalFrames / std::max(seconds, 1e-9)) << " frames/s)"
+              << std::endl;
+    if (openings && openings->getProbes() > 0)
+        std::cout << "Opening table: " << openings->getHits() << " of " << openings->getProbes() << " lookups hit ("
+                  << 100 * openings->getHits() / openings->getProbes() << "%)" << std::endl;
+    if (aiTrace)
+    {
+        aiTrace->printCounters(std::cout);
+        aiTrace->dump(opts.aiTracePath);
+    }
+    return 0;
 }
 
-int main()
+int main(int argc, char **argv)
 {
-    // Create window with calculated dimensions
-    sf::RenderWindow window(
-        sf::VideoMode(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT),
-        "Munch Maze - Pac-Man Style Game");
-    window.setFramerateLimit(60);
-
-    // Build the shared unified sprite sheet once (needs the GL context above).
-    SpriteSheet spriteSheet;
+    LaunchOptions opts;
+    if (!parseOptions(argc, argv, opts))
+        return opts.helpRequested ? 0 : 1;
 
     // Initialize game objects using PNG file
-    Grid grid(GameConfig::GRID_WIDTH, GameConfig::GRID_HEIGHT, false); // Don't auto-initialize
+    Grid grid(opts.gridWidth, opts.gridHeight, false); // Don't auto-initialize
 
-    // Try to load custom maze from PNG first
+    // Try the compiled map first (mapped, no decoding), then the authoring PNG.
+    // A --map without --size takes its board size from the image (one pixel
+    // per tile); --size resamples a PNG, so it always reads the PNG.
     std::cout << "\n=== LOADING CUSTOM MAZE ===" << std::endl;
-    bool imageLoaded = grid.loadMazeFromImage(GameConfig::MAZE_IMAGE);
+    bool imageLoaded = false;
+    if (opts.generate)
+    {
+        MazeGenerator(opts.seed).generate(grid, opts.gridWidth, opts.gridHeight);
+        opts.mapPath = "generated " + std::to_string(grid.getWidth()) + "x" + std::to_string(grid.getHeight()) +
+                       " maze (seed " + std::to_string(opts.seed) + ")";
+        imageLoaded = true;
+    }
+    else if (std::filesystem::path(opts.mapPath).extension() == ".pmm")
+    {
+        imageLoaded = grid.loadCompiledMap(opts.mapPath);
+    }
+    else
+    {
+        std::string compiled = compiledMapPath(opts.mapPath);
+        if (!opts.authoring && !opts.sizeGiven && compiledMapIsCurrent(opts.mapPath, compiled))
+            imageLoaded = grid.loadCompiledMap(compiled);
+        if (!imageLoaded)
+            imageLoaded = grid.loadMazeFromImage(opts.mapPath, opts.customMap && !opts.sizeGiven);
+    }
 
     if (!imageLoaded)
     {
@@ -101,7 +504,8 @@ int main()
         maze.printGridSample(0, 0, 15, 10);   // Print top-left corner
         maze.printGridSample(13, 20, 15, 10); // Print around spawn areas
 
-        // Copy maze walls to grid
+        // Copy maze walls to grid (the fallback layout is always 28x31)
+        grid.resize(GameConfig::GRID_WIDTH, GameConfig::GRID_HEIGHT);
         for (int y = 0; y < GameConfig::GRID_HEIGHT; y++)
         {
             for (int x = 0; x < GameConfig::GRID_WIDTH; x++)
@@ -112,83 +516,80 @@ int main()
     }
     else
     {
-        std::cout << "Successfully loaded custom maze from pratice grid.png!" << std::endl;
+        std::cout << "Successfully loaded custom maze from " << opts.mapPath << "!" << std::endl;
     }
     std::cout << "============================\n"
               << std::endl;
 
-    // Note: For now, we'll create a simple pelletGrid. You might need to modify PelletGrid
-    // to work with Grid instead of Maze, or create pellets based on the Grid data
-    PelletGrid pelletGrid(grid);
+    // Tuned per-level difficulty; without one (or if it fails to load) the
+    // standard ramp applies.
+    DifficultyCurve difficulty;
+    if (!opts.difficultyPath.empty())
+        difficulty.load(opts.difficultyPath);
+
+    if (opts.headlessGames > 0)
+        return runHeadless(grid, opts, difficulty);
+
+    // Window shows the whole board when it fits (the 28x31 board is exactly
+    // 896x992), otherwise a window-sized view that scrolls with the muncher.
+    const float worldWidth = static_cast<float>(grid.getWidth() * GameConfig::CELL_SIZE);
+    const float worldHeight = static_cast<float>(grid.getHeight() * GameConfig::CELL_SIZE);
+    const unsigned windowWidth = static_cast<unsigned>(std::min<float>(worldWidth, GameConfig::WINDOW_WIDTH));
+    const unsigned windowHeight = static_cast<unsigned>(std::min<float>(worldHeight, GameConfig::WINDOW_HEIGHT));
+    sf::RenderWindow window(sf::VideoMode(windowWidth, windowHeight), "Munch Maze - Pac-Man Style Game");
+    window.setFramerateLimit(60);
+    Camera camera(static_cast<float>(windowWidth), static_cast<float>(windowHeight), worldWidth, worldHeight);
+    GridRenderer renderer;
 
-    // Create Muncher (Pac-Man) at proper spawn point
-    Muncher muncher(grid.getPlayerStartX(), grid.getPlayerStartY(), GameConfig::CELL_SIZE, spriteSheet);
+    // Build the shared unified sprite sheet once (needs the GL context above).
+    SpriteSheet spriteSheet;
 
-    // Create Ghosts at green GHOST_SPAWN tiles from the grid
-    std::vector<std::pair<int, int>> ghostSpawns;
-    for (int y = 0; y < grid.getHeight(); ++y)
+    // The game itself: actors, pellets, score, lives and rules (GameSession.h).
+    GameSession session(grid, &spriteSheet);
+    const std::vector<int> roster = ghostRoster(opts);
+    if (!roster.empty())
+        session.setRoster(roster);
+    session.setSearchBudget(opts.ghostSearchMicros);
+    session.setDifficulty(&difficulty);
+    Muncher &muncher = session.getMuncher();
+    std::vector<Ghost> &ghosts = session.getGhosts();
+    const PelletGrid &pelletGrid = session.getPellets();
+    PointSystem &points = session.getPoints();
+    const GhostAI &ghostAI = session.getGhostAI();
+
+    // Ghost AI trace: from the start with --ai-trace, or started from the dev
+    // keys (T dumps it, starting one first if needed).
+    std::unique_ptr<AITrace> aiTrace;
+    if (!opts.aiTracePath.empty())
     {
-        for (int x = 0; x < grid.getWidth(); ++x)
-        {
-            if (grid.isGhostSpawn(x, y))
-            {
-                ghostSpawns.emplace_back(x, y);
-            }
-        }
+        aiTrace = std::make_unique<AITrace>();
+        session.setTrace(aiTrace.get());
     }
+    const std::string aiTracePath = opts.aiTracePath.empty() ? "ai_trace.bin" : opts.aiTracePath;
 
-    std::vector<Ghost> ghosts;
-    if (ghostSpawns.size() >= 4)
+    // Optional worker thread for ghost decisions; the session keeps the mode
+    // clock and decides in-frame whenever the worker has no answer ready.
+    std::unique_ptr<AsyncGhostAI> asyncAI;
+    if (opts.asyncAI)
     {
-        ghosts.emplace_back(ghostSpawns[0].first, ghostSpawns[0].second, GhostType::JACK, GameConfig::CELL_SIZE, spriteSheet); // Red ghost (Chaser)
-        ghosts.emplace_back(ghostSpawns[1].first, ghostSpawns[1].second, GhostType::MIKE, GameConfig::CELL_SIZE, spriteSheet); // Blue ghost (Ambusher)
-        ghosts.emplace_back(ghostSpawns[2].first, ghostSpawns[2].second, GhostType::SAM, GameConfig::CELL_SIZE, spriteSheet);  // Purple ghost (Fickle)
-        ghosts.emplace_back(ghostSpawns[3].first, ghostSpawns[3].second, GhostType::WILL, GameConfig::CELL_SIZE, spriteSheet); // Yellow ghost (Bashful)
+        asyncAI = std::make_unique<AsyncGhostAI>(grid);
+        session.setAsyncAI(asyncAI.get());
     }
-    else
-    {
-        // Fallback: spawn all at the first found or default location
-        int gx = ghostSpawns.empty() ? grid.getGhostSpawnX() : ghostSpawns[0].first;
-        int gy = ghostSpawns.empty() ? grid.getGhostSpawnY() : ghostSpawns[0].second;
-        ghosts.emplace_back(gx, gy, GhostType::JACK, GameConfig::CELL_SIZE, spriteSheet);
-        ghosts.emplace_back(gx, gy, GhostType::MIKE, GameConfig::CELL_SIZE, spriteSheet);
-        ghosts.emplace_back(gx, gy, GhostType::SAM, GameConfig::CELL_SIZE, spriteSheet);
-        ghosts.emplace_back(gx, gy, GhostType::WILL, GameConfig::CELL_SIZE, spriteSheet);
-    }
-
-    // Initialize Ghost AI Controller
-    GhostAI ghostAI;
 
-    // Apply per-level difficulty (ghost speed + AI mode durations). Re-called after
-    // every level-up / death / restart, since ghostAI is rebuilt in those spots.
-    auto applyDifficulty = [&](int lvl)
-    {
-        ghostAI.setLevel(lvl);
-        float ghostSpeed = 0.4f - (lvl - 1) * 0.025f; // seconds per tile; lower = faster
-        if (ghostSpeed < 0.2f)
-            ghostSpeed = 0.2f;
-        for (auto &ghost : ghosts)
-            ghost.setMovementSpeed(ghostSpeed);
-    };
-    applyDifficulty(1);
+    // Optional autoplayer: sets the same buffered turn the arrow keys do.
+    std::unique_ptr<MuncherBot> bot;
+    if (opts.bot)
+        bot = std::make_unique<MuncherBot>(botSettings(opts, 0));
 
-    // Points and lives
-    PointSystem points;
+    // Score display and menus
     int highScore = 0;
-    int frightenedGhostsEaten = 0;      // resets each power pellet; drives the 200/400/800/1600 chain
-    bool muncherDying = false;          // true while the death animation plays
-    sf::Clock deathClock;               // times the death animation
-    const float DEATH_ANIM_TIME = 1.2f; // ~one full death-frame cycle, then a brief hold
-    bool gameOver = false;                                 // true once lives hit 0
-    MuncherDirection desiredDir = MuncherDirection::RIGHT; // buffered input direction
-    bool hasStarted = false;                               // muncher waits for the first key press
-    int level = 1;                                         // current level; drives the difficulty ramp
-    bool paused = false;                                   // pause menu toggle (P)
-    bool devMode = false;                                  // dev/cheat mode (unlock with password)
-    bool invincible = false;                               // dev: ignore ghost catches
-    bool devMenu = false;                                  // dev menu overlay open (from pause)
-    std::string cheatBuffer;                               // rolling buffer of recently typed chars
-    const std::string DEV_PASSWORD = "M00140585";          // secret to unlock dev mode
+    bool paused = false;                          // pause menu toggle (P)
+    bool devMode = false;                         // dev/cheat mode (unlock with password)
+    bool devMenu = false;                         // dev menu overlay open (from pause)
+    bool showThreats = false;                     // dev: tint tiles by how soon a ghost can get there
+    ThreatMap threatMap;                          // ...kept for that overlay
+    std::string cheatBuffer;                      // rolling buffer of recently typed chars
+    const std::string DEV_PASSWORD = "M00140585"; // secret to unlock dev mode
 
     // Load UI font
     sf::Font uiFont;
@@ -199,29 +600,8 @@ int main()
     }
 
     // Find scoreboard bounds from grid tiles
-    bool hasScoreboard = false;
-    int sbMinX = grid.getWidth();
-    int sbMinY = grid.getHeight();
-    int sbMaxX = -1;
-    int sbMaxY = -1;
-    for (int y = 0; y < grid.getHeight(); y++)
-    {
-        for (int x = 0; x < grid.getWidth(); x++)
-        {
-            if (grid.isScoreboard(x, y))
-            {
-                hasScoreboard = true;
-                if (x < sbMinX)
-                    sbMinX = x;
-                if (y < sbMinY)
-                    sbMinY = y;
-                if (x > sbMaxX)
-                    sbMaxX = x;
-                if (y > sbMaxY)
-                    sbMaxY = y;
-            }
-        }
-    }
+    int sbMinX, sbMinY, sbMaxX, sbMaxY;
+    bool hasScoreboard = grid.getScoreboardBounds(sbMinX, sbMinY, sbMaxX, sbMaxY);
 
     sf::Text scoreText;
     sf::Text highScoreText;
@@ -242,8 +622,9 @@ int main()
     }
 
     std::cout << "Game initialized with:" << std::endl;
-    std::cout << "- Window size: " << GameConfig::WINDOW_WIDTH << "x" << GameConfig::WINDOW_HEIGHT << std::endl;
-    std::cout << "- Grid size: " << GameConfig::GRID_WIDTH << "x" << GameConfig::GRID_HEIGHT << std::endl;
+    std::cout << "- Window size: " << windowWidth << "x" << windowHeight << std::endl;
+    std::cout << "- Grid size: " << grid.getWidth() << "x" << grid.getHeight()
+              << " (" << grid.getStoredChunkCount() << " chunks stored, " << grid.getMemoryBytes() << " bytes)" << std::endl;
     std::cout << "- Cell size: " << GameConfig::CELL_SIZE << "x" << GameConfig::CELL_SIZE << std::endl;
     std::cout << "- Sprite scale: " << GameConfig::SPRITE_SCALE << " (from 100x100 to " << GameConfig::SPRITE_SIZE << "x" << GameConfig::SPRITE_SIZE << ")" << std::endl;
     std::cout << "- Total pellets: " << pelletGrid.countPellets() << std::endl;
@@ -266,26 +647,91 @@ int main()
     std::cout << "  * SAM (Purple) - Fickle: Complex targeting" << std::endl;
     std::cout << "  * WILL (Yellow) - Bashful: Retreats when close" << std::endl;
 
-    // Add these before the game loop
-    PausableClock fruitTimer;
-    bool fruitPresent = false;      // fruit initially not present
-    bool waitingForRespawn = false; // waiting state after fruit is eaten
+    // Board pass: move the camera onto the muncher, then draw only what it sees.
+    // Screen-space overlays switch back to window.getDefaultView() afterwards.
+    auto drawBoard = [&]()
+    {
+        sf::Vector2f focus = muncher.getRenderPosition();
+        camera.follow(sf::Vector2f(focus.x + GameConfig::CELL_SIZE / 2.0f, focus.y + GameConfig::CELL_SIZE / 2.0f));
+        window.setView(camera.getView());
+        renderer.draw(window, grid, pelletGrid, spriteSheet);
+    };
+    const float screenW = static_cast<float>(windowWidth);
+    const float screenH = static_cast<float>(windowHeight);
+
+    // Live map reload. The map the game was started with is watched; when it
+    // changes on disk it is re-read and diffed against the running board, and
+    // only the cells that differ are written into it and pushed into the
+    // pellet grid and the renderer's cached chunks (a resized map rebuilds
+    // those wholesale). Score,
+    // lives, level, eaten pellets elsewhere and the actors all carry over; an
+    // actor is only sent home if its tile stopped being walkable for it.
+    std::unique_ptr<MapWatcher> mapWatcher;
+    if (opts.watch && !opts.generate && imageLoaded)
+        mapWatcher = std::make_unique<MapWatcher>(opts.mapPath);
+
+    auto reloadMap = [&]()
+    {
+        Grid fresh(grid.getWidth(), grid.getHeight(), false);
+        bool loaded = std::filesystem::path(opts.mapPath).extension() == ".pmm"
+                          ? fresh.loadCompiledMap(opts.mapPath)
+                          : fresh.loadMazeFromImage(opts.mapPath, opts.customMap && !opts.sizeGiven);
+        if (!loaded)
+        {
+            std::cout << "Live reload failed; keeping the current map" << std::endl;
+            return;
+        }
 
-    // Fruit types to cycle through
-    std::vector<PelletType> fruitTypes =
+        const bool resized = fresh.getWidth() != grid.getWidth() || fresh.getHeight() != grid.getHeight();
+        std::vector<sf::Vector2i> changed;
+        if (!resized)
         {
-            PelletType::APPLE,
-            PelletType::CHERRY,
-            PelletType::STRAWBERRY,
-            PelletType::ORANGE,
-            PelletType::GRAPEFRUIT,
-            PelletType::PANCAKE};
-    int currentFruitIndex = 0;
-    Pellet fruitPellet(13, 18, fruitTypes[currentFruitIndex], spriteSheet); // fruit spawns at center bottom
+            changed = grid.diffCells(fresh);
+            if (changed.empty())
+            {
+                std::cout << "Live reload: no tile changes" << std::endl;
+                return;
+            }
+        }
+        {
+            std::unique_lock<std::mutex> hold; // keep the AI worker out of the grid while it is changed
+            if (asyncAI)
+                hold = asyncAI->holdWorker();
+            // Same size: write just the changed tiles, so the cached ghost
+            // path data is repaired around them instead of rebuilt.
+            if (resized)
+                grid = std::move(fresh);
+            else
+                grid.applyCells(fresh, changed);
+        }
+
+        if (resized)
+        {
+            renderer.invalidateAll();
+            camera = Camera(screenW, screenH, static_cast<float>(grid.getWidth() * GameConfig::CELL_SIZE),
+                            static_cast<float>(grid.getHeight() * GameConfig::CELL_SIZE));
+        }
+        else
+        {
+            for (const sf::Vector2i &c : changed)
+                renderer.invalidateCell(c.x, c.y);
+        }
+        hasScoreboard = grid.getScoreboardBounds(sbMinX, sbMinY, sbMaxX, sbMaxY);
+
+        // Pellets on the changed cells, ghost homes, actors caught in new walls.
+        session.onMapChanged(resized, changed);
+
+        std::cout << "Live reload: " << opts.mapPath << " ("
+                  << (resized ? "resized, full rebuild" : std::to_string(changed.size()) + " tiles changed") << ")"
+                  << std::endl;
+    };
 
     // Game loop
     while (window.isOpen())
     {
+        if (mapWatcher && mapWatcher->changed())
+            reloadMap();
+
         sf::Event event;
         while (window.pollEvent(event))
         {
@@ -294,16 +740,12 @@ int main()
                 window.close();
             }
             else if (event.type == sf::Event::KeyPressed &&
-                     event.key.code == sf::Keyboard::P && !gameOver && !muncherDying)
+                     event.key.code == sf::Keyboard::P && !session.isGameOver() && !session.isDying())
             {
                 paused = !paused; // toggle pause on P (not during death / game over)
                 if (!paused)
                     devMenu = false; // leaving pause also closes the dev menu
-                muncher.setPaused(paused);
-                for (auto &ghost : ghosts)
-                    ghost.setPaused(paused);
-                ghostAI.setPaused(paused);
-                fruitTimer.setPaused(paused);
+                session.setPaused(paused);
             }
             else if (event.type == sf::Event::KeyPressed &&
                      event.key.code == sf::Keyboard::D && paused)
@@ -316,7 +758,7 @@ int main()
                 switch (event.key.code)
                 {
                 case sf::Keyboard::I: // toggle invincibility
-                    invincible = !invincible;
+                    session.setInvincible(!session.isInvincible());
                     break;
                 case sf::Keyboard::L: // +1 life
                     points.addLife();
@@ -325,13 +767,26 @@ int main()
                     highScore += 1000;
                     break;
                 case sf::Keyboard::N: // level up (ramp difficulty to watch the curve)
-                    level++;
-                    applyDifficulty(level);
+                    session.setLevel(session.getLevel() + 1);
                     break;
                 case sf::Keyboard::B: // level down
-                    if (level > 1)
-                        level--;
-                    applyDifficulty(level);
+                    session.setLevel(std::max(1, session.getLevel() - 1));
+                    break;
+                case sf::Keyboard::G: // ghost threat overlay
+                    showThreats = !showThreats;
+                    break;
+                case sf::Keyboard::T: // dump the ghost AI trace (starts tracing the first time)
+                    if (aiTrace)
+                    {
+                        aiTrace->printCounters(std::cout);
+                        aiTrace->dump(aiTracePath);
+                    }
+                    else
+                    {
+                        aiTrace = std::make_unique<AITrace>();
+                        session.setTrace(aiTrace.get());
+                        std::cout << "Ghost AI trace started (T again to dump)." << std::endl;
+                    }
                     break;
                 default:
                     break;
@@ -363,14 +818,15 @@ int main()
         if (paused)
         {
             window.clear(sf::Color::Black);
-            drawGame(window, grid, pelletGrid, spriteSheet);
+            drawBoard();
             window.draw(muncher.getSprite());
             for (auto &ghost : ghosts)
                 window.draw(ghost.getSprite());
-            if (fruitPresent && !fruitPellet.isCollected())
-                fruitPellet.draw(window);
+            if (session.isFruitShowing())
+                session.getFruit().draw(window);
 
-            sf::RectangleShape dim(sf::Vector2f(GameConfig::WINDOW_WIDTH, GameConfig::WINDOW_HEIGHT));
+            window.setView(window.getDefaultView());
+            sf::RectangleShape dim(sf::Vector2f(screenW, screenH));
             dim.setFillColor(sf::Color(0, 0, 0, 160)); // translucent black
             window.draw(dim);
 
@@ -382,12 +838,12 @@ int main()
                 {
                     std::string devStr;
                     if (devMode)
-                        devStr = "DEV MENU\n\nLevel " + std::to_string(level) +
+                        devStr = "DEV MENU\n\nLevel " + std::to_string(session.getLevel()) +
                                  "    Lives " + std::to_string(points.getLives()) +
                                  "    High " + std::to_string(highScore) +
-                                 "\nInvincible: " + (invincible ? "ON" : "OFF") +
+                                 "\nInvincible: " + (session.isInvincible() ? "ON" : "OFF") +
                                  "\n\nI invincible    L +life    H +high\n" +
-                                 "N level up    B level down\n\nD back    P resume";
+                                 "N level up    B level down\nT ghost AI trace    G threat map\n\nD back    P resume";
                     else
                         devStr = "DEV MENU  (LOCKED)\n\nType the password to unlock\n\nD back    P resume";
                     overlay.setString(devStr);
@@ -402,7 +858,7 @@ int main()
                 }
                 sf::FloatRect pb = overlay.getLocalBounds();
                 overlay.setOrigin(pb.left + pb.width / 2.0f, pb.top + pb.height / 2.0f);
-                overlay.setPosition(GameConfig::WINDOW_WIDTH / 2.0f, GameConfig::WINDOW_HEIGHT / 2.0f);
+                overlay.setPosition(screenW / 2.0f, screenH / 2.0f);
                 window.draw(overlay);
             }
 
@@ -412,25 +868,14 @@ int main()
 
         // Game over: out of lives. Freeze on a GAME OVER screen; Space restarts
         // the whole run (score & lives reset; high score is kept).
-        if (gameOver)
+        if (session.isGameOver())
         {
             if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space))
-            {
-                points = PointSystem();
-                level = 1;
-                pelletGrid = PelletGrid(grid);
-                muncher.reset(grid.getPlayerStartX(), grid.getPlayerStartY());
-                for (auto &ghost : ghosts)
-                    ghost.reset();
-                ghostAI = GhostAI();
-                applyDifficulty(level); // back to level-1 difficulty
-                frightenedGhostsEaten = 0;
-                gameOver = false;
-                hasStarted = false; // fresh game waits for the first key press
-            }
+                session.restart(); // fresh game waits for the first key press
 
             window.clear(sf::Color::Black);
-            drawGame(window, grid, pelletGrid, spriteSheet);
+            drawBoard();
+            window.setView(window.getDefaultView());
             if (fontLoaded)
             {
                 sf::Text overText;
@@ -440,228 +885,81 @@ int main()
                 overText.setFillColor(sf::Color::Red);
                 sf::FloatRect b = overText.getLocalBounds();
                 overText.setOrigin(b.left + b.width / 2.0f, b.top + b.height / 2.0f);
-                overText.setPosition(GameConfig::WINDOW_WIDTH / 2.0f, GameConfig::WINDOW_HEIGHT / 2.0f);
+                overText.setPosition(screenW / 2.0f, screenH / 2.0f);
                 window.draw(overText);
             }
             window.display();
             continue;
         }
 
-        // Death pause: freeze gameplay, play the muncher's death animation, then
-        // reset everyone to their start tiles. Ghosts are hidden during the death
-        // (classic Pac-Man behaviour).
-        if (muncherDying)
-        {
-            muncher.updateAnimation();
-            if (deathClock.getElapsedTime().asSeconds() >= DEATH_ANIM_TIME)
-            {
-                muncherDying = false;
-                if (points.getLives() == 0)
-                {
-                    gameOver = true; // out of lives -> game over (no respawn)
-                }
-                else
-                {
-                    muncher.reset(grid.getPlayerStartX(), grid.getPlayerStartY());
-                    for (auto &ghost : ghosts)
-                        ghost.reset();
-                    ghostAI = GhostAI();
-                    applyDifficulty(level); // ghostAI was rebuilt -> restore this level's difficulty
-                }
-            }
-
-            window.clear(sf::Color::Black);
-            drawGame(window, grid, pelletGrid, spriteSheet);
-            window.draw(muncher.getSprite());
-            window.display();
-            continue;
-        }
-
-        // Fruit spawn logic
-        if (!fruitPresent && !waitingForRespawn && fruitTimer.getElapsedTime().asSeconds() >= 45.f) // Spawn the first fruit after 45 seconds
-        {
-            fruitPresent = true;
-            currentFruitIndex = (currentFruitIndex + 1) % fruitTypes.size();
-            std::cout << "Spawning fruit type index: " << currentFruitIndex << std::endl;
-            fruitPellet.setType(fruitTypes[currentFruitIndex]);
-            fruitPellet.reset();
-        }
-
-        // Check if fruit is eaten
-        if (fruitPresent && muncher.getPosition() == fruitPellet.getPosition() && !fruitPellet.isCollected())
-        {
-            fruitPellet.collect();
-            fruitPresent = false;
-            waitingForRespawn = true;
-            fruitTimer.restart();
-
-            switch (fruitPellet.getType())
-            {
-            case PelletType::CHERRY:
-                points.addPoints(PointSystem::CHERRY_POINTS);
-                break;
-            case PelletType::STRAWBERRY:
-                points.addPoints(PointSystem::STRAWBERRY_POINTS);
-                break;
-            case PelletType::ORANGE:
-                points.addPoints(PointSystem::ORANGE_POINTS);
-                break;
-            case PelletType::APPLE:
-                points.addPoints(PointSystem::APPLE_POINTS);
-                break;
-            case PelletType::GRAPEFRUIT:
-                points.addPoints(PointSystem::GRAPEFRUIT_POINTS);
-                break;
-            case PelletType::PANCAKE:
-                points.addPoints(PointSystem::PANCAKE_POINTS);
-                break;
-            default:
-                break;
-            }
-        }
-
-        // After fruit is eaten, wait 45 seconds to respawn
-        if (waitingForRespawn && fruitTimer.getElapsedTime().asSeconds() >= 45.f)
+        // Input: buffer the latest requested direction; the session takes the
+        // turn at the next tile where it's open. The bot, when playing, sets
+        // the same buffered turn instead of the arrow keys.
+        if (bot)
         {
-            waitingForRespawn = false;
-            fruitPresent = true;
-            currentFruitIndex = (currentFruitIndex + 1) % fruitTypes.size();
-            std::cout << "Respawning fruit type index: " << currentFruitIndex << std::endl;
-            fruitPellet.setType(fruitTypes[currentFruitIndex]);
-            fruitPellet.reset();
+            bot->play(session);
         }
-
-        // Draw fruit if present and not collected
-        if (fruitPresent && !fruitPellet.isCollected())
+        else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up))
         {
-            fruitPellet.draw(window);
-        }
-
-        // Update game objects
-        muncher.updateAnimation();
-        muncher.updateMovement();
-
-        // Update Ghost AI
-        ghostAI.update(ghosts, muncher, grid);
-
-        for (auto &ghost : ghosts)
-        {
-            ghost.updateAnimation();
-            ghost.updateMovement(grid, ghosts);
-        }
-
-        // Handle input: buffer the latest requested direction, then move Pac-Man
-        // style — at each tile take the buffered turn if it's open, otherwise keep
-        // heading the current way. Stays still until the first key press.
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up))
-        {
-            desiredDir = MuncherDirection::UP;
-            hasStarted = true;
+            session.setDesiredDirection(MuncherDirection::UP);
         }
         else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down))
         {
-            desiredDir = MuncherDirection::DOWN;
-            hasStarted = true;
+            session.setDesiredDirection(MuncherDirection::DOWN);
         }
         else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
         {
-            desiredDir = MuncherDirection::LEFT;
-            hasStarted = true;
+            session.setDesiredDirection(MuncherDirection::LEFT);
         }
         else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
         {
-            desiredDir = MuncherDirection::RIGHT;
-            hasStarted = true;
+            session.setDesiredDirection(MuncherDirection::RIGHT);
         }
 
-        if (hasStarted && !muncher.getIsMoving())
+        // One frame of game rules: fruit, movement, ghost AI, contacts, pellets,
+        // level clear and the death sequence (GameSession::update).
+        session.update();
+
+        // Death pause: gameplay is frozen while the muncher's death animation
+        // plays; ghosts are hidden during the death (classic Pac-Man behaviour).
+        if (session.isDying() || session.isGameOver())
         {
-            if (muncher.canMove(grid, desiredDir))
-                muncher.startMovement(grid, desiredDir);             // take the buffered turn
-            else
-                muncher.startMovement(grid, muncher.getDirection()); // otherwise keep going
+            window.clear(sf::Color::Black);
+            drawBoard();
+            window.draw(muncher.getSprite());
+            window.display();
+            continue;
         }
 
-        // Check for pellet collisions
-        sf::Vector2i muncherPos = muncher.getPosition();
-        int gridX = muncherPos.x;
-        int gridY = muncherPos.y;
-
-        // Ghost contact = overlap within half a cell, measured on the smooth
-        // render positions. This catches head-on passes (mid-tile overlap) and,
-        // unlike the old 1.5x bounding-box test, doesn't trigger a full tile away.
-        sf::Vector2f muncherRender = muncher.getRenderPosition();
-        const float contactDist = GameConfig::CELL_SIZE * 0.5f;
-        for (auto &ghost : ghosts)
-        {
-            sf::Vector2f g = ghost.getRenderPosition();
-            float dx = muncherRender.x - g.x;
-            float dy = muncherRender.y - g.y;
-            bool touching = (dx * dx + dy * dy) < (contactDist * contactDist);
+        // Clear window
+        window.clear(sf::Color::Black);
 
-            if (touching && ghost.getState() == GhostState::FRIGHTENED && !ghost.getIsEaten())
-            {
-                // Escalating chain within one power pellet: 200 -> 400 -> 800 -> 1600.
-                static const int frightPoints[4] = {
-                    PointSystem::First_Frightened_Ghost_Points,
-                    PointSystem::Second_Frightened_Ghost_Points,
-                    PointSystem::Third_Frightened_Ghost_Points,
-                    PointSystem::Fourth_Frightened_Ghost_Points};
-                int idx = frightenedGhostsEaten < 4 ? frightenedGhostsEaten : 3;
-                points.addPoints(frightPoints[idx]);
-                frightenedGhostsEaten++;
-                ghost.setEaten();
-            }
-            else if (touching && ghost.getState() == GhostState::NORMAL && !muncherDying && !invincible)
-            {
-                // Caught by a live ghost: lose a life and start the death animation
-                // (the reset happens at the top of the loop when it finishes).
-                std::cout << "Muncher caught! Losing a life." << std::endl;
-                points.loseLife();
-                muncher.setState(MuncherState::DYING);
-                muncherDying = true;
-                deathClock.restart();
-            }
-        }
+        // Draw maze walls and pellets
+        drawBoard();
 
-        if (pelletGrid.hasPowerPellet(gridX, gridY))
+        // Dev threat overlay: red where a ghost gets within 3 seconds, deeper
+        // the sooner (ThreatMap, only redone as ghosts change tiles).
+        if (devMode && showThreats)
         {
-            std::cout << "Power pellet eaten! Ghosts are now frightened!" << std::endl;
-            pelletGrid.setPowerPellet(gridX, gridY, false);
-            ghostAI.setFrightened();
-            frightenedGhostsEaten = 0; // start a fresh 200/400/800/1600 chain
-            points.addPoints(PointSystem::POINTS_PER_POWER_PELLET);
-
-            // Set all ghosts to frightened state
-            for (auto &ghost : ghosts)
+            threatMap.update(grid, ghosts);
+            const float cell = static_cast<float>(GameConfig::CELL_SIZE);
+            sf::VertexArray tint(sf::Quads);
+            for (int y = 0; y < threatMap.getHeight(); ++y)
             {
-                ghost.setState(GhostState::FRIGHTENED);
+                for (int x = 0; x < threatMap.getWidth(); ++x)
+                {
+                    float t = threatMap.timeAt(x, y);
+                    if (t >= 3.0f)
+                        continue;
+                    sf::Color c(255, 0, 0, static_cast<sf::Uint8>(40 + 120 * (1.0f - t / 3.0f)));
+                    tint.append(sf::Vertex(sf::Vector2f(x * cell, y * cell), c));
+                    tint.append(sf::Vertex(sf::Vector2f((x + 1) * cell, y * cell), c));
+                    tint.append(sf::Vertex(sf::Vector2f((x + 1) * cell, (y + 1) * cell), c));
+                    tint.append(sf::Vertex(sf::Vector2f(x * cell, (y + 1) * cell), c));
+                }
             }
+            window.draw(tint);
         }
-        else if (pelletGrid.hasPellet(gridX, gridY))
-        {
-            pelletGrid.setPellet(gridX, gridY, false);
-            points.addPoints(PointSystem::POINTS_PER_PELLET);
-        }
-
-        // Level clear: every pellet eaten -> restart the board, keep score & lives.
-        if (pelletGrid.countPellets() == 0 && pelletGrid.countPowerPellets() == 0)
-        {
-            level++;
-            std::cout << "Level cleared! Advancing to level " << level << " (score & lives kept)." << std::endl;
-            pelletGrid = PelletGrid(grid); // repopulate all pellets from the map
-            muncher.reset(grid.getPlayerStartX(), grid.getPlayerStartY());
-            for (auto &ghost : ghosts)
-                ghost.reset();
-            ghostAI = GhostAI();    // restart the scatter/chase cycle
-            applyDifficulty(level); // ramp speed + timings for the new level
-        }
-
-        // Clear window
-        window.clear(sf::Color::Black);
-
-        // Draw maze walls and pellets
-        drawGame(window, grid, pelletGrid, spriteSheet);
 
         // Draw muncher
         window.draw(muncher.getSprite());
@@ -673,13 +971,15 @@ int main()
         }
 
         // Draw fruit if present and not collected
-        if (fruitPresent && !fruitPellet.isCollected())
+        if (session.isFruitShowing())
         {
-            fruitPellet.draw(window);
+            session.getFruit().draw(window);
         }
 
-        // Draw scoreboard text on top of scoreboard tiles
-        if (fontLoaded && hasScoreboard)
+        // Draw scoreboard text on top of scoreboard tiles. On a scrolling board
+        // the scoreboard region may be off screen, so pin the text to the window.
+        const bool pinnedHud = !camera.showsWholeWorld();
+        if (fontLoaded && (hasScoreboard || pinnedHud))
         {
             if (points.getTotalPoints() > highScore)
             {
@@ -694,6 +994,12 @@ int main()
             float sbTop = sbMinY * GameConfig::CELL_SIZE;
             float paddingX = 6.0f;
             float paddingY = 4.0f;
+            if (pinnedHud)
+            {
+                window.setView(window.getDefaultView());
+                sbLeft = 0.0f;
+                sbTop = 20.0f; // below the dev-mode HUD line
+            }
 
             scoreText.setPosition(sbLeft + paddingX, sbTop + paddingY);
             highScoreText.setPosition(sbLeft + paddingX, sbTop + paddingY + 22.0f);
@@ -729,13 +1035,14 @@ int main()
         }
 
         // Dev-mode HUD.
+        window.setView(window.getDefaultView());
         if (fontLoaded && devMode)
         {
             sf::Text devText;
             devText.setFont(uiFont);
             devText.setCharacterSize(16);
             devText.setFillColor(sf::Color(0, 255, 0));
-            devText.setString("DEV  L" + std::to_string(level) + (invincible ? "  INVINCIBLE" : ""));
+            devText.setString("DEV  L" + std::to_string(session.getLevel()) + (session.isInvincible() ? "  INVINCIBLE" : ""));
             devText.setPosition(4.0f, 2.0f);
             window.draw(devText);
         }
@@ -744,5 +1051,15 @@ int main()
         window.display();
     }
 
+    if (asyncAI)
+        std::cout << "Async ghost AI: " << asyncAI->getApplied() << " decisions from the worker, "
+                  << asyncAI->getFallbacks() << " decided in-frame, " << asyncAI->getWorkerSnapshots()
+                  << " snapshots processed" << std::endl;
+    if (aiTrace)
+    {
+        aiTrace->printCounters(std::cout);
+        aiTrace->dump(aiTracePath);
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,319 @@
+// munch_env — the C API in munch_env.h over GameSession (make env).
+#define MUNCH_ENV_BUILD
+#include "munch_env.h"
+
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "Grid.h"
+#include "GameConfig.h"
+#include "GameSession.h"
+#include "PlaneEncoder.h"
+#include "Parallel.h"
+
+static_assert(static_cast<int>(MUNCH_PLANE_COUNT) == PlaneEncoder::PLANE_COUNT &&
+                  static_cast<int>(MUNCH_PLANE_GHOST_0) == PlaneEncoder::GHOST_0 &&
+                  static_cast<int>(MUNCH_PLANE_GHOST_EYES) == PlaneEncoder::GHOSTS_EYES,
+              "munch_env.h plane numbers must match PlaneEncoder");
+
+struct MunchEnv
+{
+    std::shared_ptr<const Grid> grid;
+    std::unique_ptr<GameSession> session;
+    std::unique_ptr<PlaneEncoder> encoder; // survives resets, so the buffer stays incremental
+    int frameSkip = 1;
+    int32_t maxFrames = 72000;
+    bool finished = false;
+    int result = MUNCH_RUNNING;
+};
+
+// One read-only Grid per map path, shared by every environment using it (a
+// training run creates hundreds of environments on the same map).
+static std::shared_ptr<const Grid> loadSharedGrid(const std::string &path, bool fitToImage)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<const Grid>> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (std::shared_ptr<const Grid> grid = cache[path].lock())
+        return grid;
+
+    auto grid = std::make_shared<Grid>(GameConfig::GRID_WIDTH, GameConfig::GRID_HEIGHT, false);
+    bool loaded = std::filesystem::path(path).extension() == ".pmm" ? grid->loadCompiledMap(path)
+                                                                      : grid->loadMazeFromImage(path, fitToImage);
+    if (!loaded)
+        return nullptr;
+    cache[path] = grid;
+    return grid;
+}
+
+static void resetSession(MunchEnv &env, uint64_t seed)
+{
+    env.session = std::make_unique<GameSession>(GameSession::headless(*env.grid));
+    env.session->seed(static_cast<unsigned>(seed ^ (seed >> 32)));
+    env.finished = false;
+    env.result = MUNCH_RUNNING;
+}
+
+static int stepSession(MunchEnv &env, int action, float *reward)
+{
+    static const sf::Time frame = sf::seconds(1.0f / 60.0f);
+    static const MuncherDirection directions[] = {MuncherDirection::UP, MuncherDirection::DOWN,
+                                                  MuncherDirection::LEFT, MuncherDirection::RIGHT};
+    if (reward)
+        *reward = 0.0f;
+    if (env.finished)
+        return env.result;
+
+    GameSession &session = *env.session;
+    if (action > MUNCH_ACTION_NONE && action < MUNCH_ACTION_COUNT)
+        session.setDesiredDirection(directions[action - 1]);
+
+    int before = session.getPoints().getTotalPoints();
+    for (int i = 0; i < env.frameSkip && !session.isGameOver(); ++i)
+        session.step(frame);
+    if (reward)
+        *reward = static_cast<float>(session.getPoints().getTotalPoints() - before);
+
+    if (session.isGameOver())
+        env.result = MUNCH_GAME_OVER;
+    else if (session.getFrames() >= env.maxFrames)
+        env.result = MUNCH_TIME_LIMIT;
+    env.finished = env.result != MUNCH_RUNNING;
+    return env.result;
+}
+
+// A failed reset or step leaves the game half-set-up or half-stepped: the
+// environment reports MUNCH_ERROR until it is reset.
+static int failEnv(MunchEnv &env)
+{
+    env.finished = true;
+    env.result = MUNCH_ERROR;
+    return MUNCH_ERROR;
+}
+
+// stepSession for the C API: exceptions become MUNCH_ERROR.
+static int stepSafely(MunchEnv &env, int action, float *reward)
+{
+    try
+    {
+        return stepSession(env, action, reward);
+    }
+    catch (...)
+    {
+        if (reward)
+            *reward = 0.0f;
+        return failEnv(env);
+    }
+}
+
+static int32_t ghostCell(const Ghost &ghost)
+{
+    if (ghost.getIsEaten() || ghost.getState() == GhostState::EATEN || ghost.getState() == GhostState::RETURNING)
+        return MUNCH_CELL_EATEN_GHOST;
+    return ghost.getState() == GhostState::FRIGHTENED ? MUNCH_CELL_FRIGHTENED_GHOST : MUNCH_CELL_GHOST;
+}
+
+extern "C" {
+
+MunchEnv *munch_env_create(const char *mapPath, int frameSkip)
+{
+    try
+    {
+        // The shipped map is laid out at the standard size; any other map is
+        // sized from its image, as `munch_maze --map` does.
+        bool custom = mapPath != nullptr;
+        std::shared_ptr<const Grid> grid = loadSharedGrid(custom ? mapPath : GameConfig::MAZE_IMAGE, custom);
+        if (!grid)
+            return nullptr;
+        MunchEnv *env = new MunchEnv;
+        env->grid = grid;
+        env->frameSkip = frameSkip < 1 ? 1 : frameSkip;
+        env->encoder = std::make_unique<PlaneEncoder>(grid->getWidth(), grid->getHeight());
+        resetSession(*env, 1);
+        return env;
+    }
+    catch (...)
+    {
+        return nullptr; // never let an exception cross the C boundary
+    }
+}
+
+void munch_env_destroy(MunchEnv *env)
+{
+    delete env;
+}
+
+void munch_env_set_max_frames(MunchEnv *env, int32_t maxFrames)
+{
+    env->maxFrames = maxFrames < 1 ? 1 : maxFrames;
+}
+
+int munch_env_reset(MunchEnv *env, uint64_t seed)
+{
+    try
+    {
+        resetSession(*env, seed);
+        return 0;
+    }
+    catch (...)
+    {
+        return failEnv(*env); // the old session stays, but is not a fresh game
+    }
+}
+
+int munch_env_step(MunchEnv *env, int action, float *reward)
+{
+    return stepSafely(*env, action, reward);
+}
+
+int munch_env_step_many(MunchEnv *const *envs, int count, const int *actions, float *rewards, int *results,
+                        int threads)
+{
+    // Environments share nothing mutable, so each band steps its own slice.
+    // Nothing may escape a worker thread (that would terminate the process).
+    std::atomic<bool> failed{false};
+    try
+    {
+        parallelFor(0, count, threads > 0 ? static_cast<unsigned>(threads) : 0, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                int result = stepSafely(*envs[i], actions[i], rewards ? &rewards[i] : nullptr);
+                if (result == MUNCH_ERROR)
+                    failed = true;
+                if (results)
+                    results[i] = result;
+            }
+        });
+    }
+    catch (...)
+    {
+        return MUNCH_ERROR;
+    }
+    return failed ? MUNCH_ERROR : 0;
+}
+
+int munch_env_width(const MunchEnv *env)
+{
+    return env->grid->getWidth();
+}
+
+int munch_env_height(const MunchEnv *env)
+{
+    return env->grid->getHeight();
+}
+
+void munch_env_observe(const MunchEnv *env, uint8_t *cells)
+{
+    const Grid &grid = *env->grid;
+    const GameSession &session = *env->session;
+    const PelletGrid &pellets = session.getPellets();
+    const int width = grid.getWidth(), height = grid.getHeight();
+
+    for (int y = 0; y < height; ++y)
+    {
+        uint8_t *row = cells + static_cast<std::size_t>(y) * width;
+        for (int x = 0; x < width; ++x)
+        {
+            int flags = grid.getFlags(x, y);
+            uint8_t cell = MUNCH_CELL_EMPTY;
+            if (flags & GHOST_DOOR) // before WALL: doors carry both flags
+                cell = MUNCH_CELL_DOOR;
+            else if (flags & WALL)
+                cell = MUNCH_CELL_WALL;
+            else if (pellets.hasPowerPellet(x, y))
+                cell = MUNCH_CELL_POWER_PELLET;
+            else if (pellets.hasPellet(x, y))
+                cell = MUNCH_CELL_PELLET;
+            row[x] = cell;
+        }
+    }
+
+    auto put = [&](sf::Vector2i tile, uint8_t code)
+    {
+        if (tile.x >= 0 && tile.x < width && tile.y >= 0 && tile.y < height)
+            cells[static_cast<std::size_t>(tile.y) * width + tile.x] = code;
+    };
+    if (session.isFruitShowing())
+        put(session.getFruit().getPosition(), MUNCH_CELL_FRUIT);
+    put(session.getMuncher().getPosition(), MUNCH_CELL_MUNCHER);
+    for (const Ghost &ghost : session.getGhosts())
+        put(ghost.getPosition(), static_cast<uint8_t>(ghostCell(ghost)));
+}
+
+void munch_env_state(const MunchEnv *env, MunchEnvState *out)
+{
+    const GameSession &session = *env->session;
+    const Muncher &muncher = session.getMuncher();
+
+    *out = MunchEnvState();
+    out->score = session.getPoints().getTotalPoints();
+    out->lives = session.getPoints().getLives();
+    out->level = session.getLevel();
+    out->frame = static_cast<int32_t>(session.getFrames());
+    out->pellets_left = session.getPellets().countPellets() + session.getPellets().countPowerPellets();
+    out->frightened = session.getGhostAI().getCurrentMode() == AIMode::FRIGHTENED;
+    out->muncher_x = muncher.getPosition().x;
+    out->muncher_y = muncher.getPosition().y;
+    out->muncher_dir = static_cast<int32_t>(muncher.getDirection());
+
+    const std::vector<Ghost> &ghosts = session.getGhosts();
+    out->ghost_count = static_cast<int32_t>(std::min<std::size_t>(ghosts.size(), MUNCH_ENV_MAX_GHOSTS));
+    for (int i = 0; i < out->ghost_count; ++i)
+    {
+        out->ghost_x[i] = ghosts[i].getPosition().x;
+        out->ghost_y[i] = ghosts[i].getPosition().y;
+        out->ghost_dir[i] = static_cast<int32_t>(ghosts[i].getDirection());
+        out->ghost_cell[i] = ghostCell(ghosts[i]);
+    }
+}
+
+size_t munch_env_plane_bytes(const MunchEnv *env)
+{
+    return env->encoder->getPlaneBytes();
+}
+
+int munch_env_encode(MunchEnv *env, uint8_t *planes, int full)
+{
+    try
+    {
+        env->encoder->encode(*env->session, planes, full != 0);
+        return 0;
+    }
+    catch (...)
+    {
+        return MUNCH_ERROR;
+    }
+}
+
+int munch_env_encode_many(MunchEnv *const *envs, int count, uint8_t *planes, int threads)
+{
+    if (count <= 0)
+        return 0;
+    const size_t stride = envs[0]->encoder->getBytes();
+    std::atomic<bool> failed{false};
+    try
+    {
+        parallelFor(0, count, threads > 0 ? static_cast<unsigned>(threads) : 0, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                if (munch_env_encode(envs[i], planes + static_cast<size_t>(i) * stride, 0) != 0)
+                    failed = true;
+            }
+        });
+    }
+    catch (...)
+    {
+        return MUNCH_ERROR;
+    }
+    return failed ? MUNCH_ERROR : 0;
+}
+
+} // extern "C"
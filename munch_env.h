@@ -0,0 +1,169 @@
+#ifndef MUNCH_ENV_H
+#define MUNCH_ENV_H
+
+/*
+ * Munch Maze as a reinforcement-learning environment: a plain C API over the
+ * headless game (GameSession), built as a shared library with `make env`
+ * (libmunch_env.so / munch_env.dll). No window, no sprites; every environment
+ * runs on its own simulated clock, so it steps as fast as the CPU allows and
+ * replays exactly from the same seed and actions.
+ *
+ *   MunchEnv *env = munch_env_create(NULL, 4);   // shipped map, 4 frames a step
+ *   munch_env_reset(env, 42);
+ *   float reward;
+ *   while (munch_env_step(env, MUNCH_ACTION_LEFT, &reward) == MUNCH_RUNNING) { ... }
+ *   munch_env_destroy(env);
+ *
+ * Environments are independent: different ones may be used from different
+ * threads at once, and munch_env_step_many steps a batch across threads. A
+ * single environment must not be used from two threads at the same time.
+ *
+ * No call lets a C++ exception out: calls that can fail (out of memory, no
+ * thread to spare) return MUNCH_ERROR, and an environment whose reset or
+ * step failed keeps returning MUNCH_ERROR from munch_env_step until a
+ * munch_env_reset succeeds.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(MUNCH_ENV_BUILD)
+#define MUNCH_ENV_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define MUNCH_ENV_API __declspec(dllimport)
+#else
+#define MUNCH_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct MunchEnv MunchEnv;
+
+/* Actions: the arrow keys. A turn is buffered and taken at the next tile where
+   it is open, exactly as for a player; NONE keeps the current buffered turn. */
+enum
+{
+    MUNCH_ACTION_NONE = 0,
+    MUNCH_ACTION_UP = 1,
+    MUNCH_ACTION_DOWN = 2,
+    MUNCH_ACTION_LEFT = 3,
+    MUNCH_ACTION_RIGHT = 4,
+    MUNCH_ACTION_COUNT = 5
+};
+
+/* munch_env_step results (and MUNCH_ERROR from any call that can fail). */
+enum
+{
+    MUNCH_ERROR = -1,    /* the call failed; reset the environment */
+    MUNCH_RUNNING = 0,   /* episode continues */
+    MUNCH_GAME_OVER = 1, /* out of lives (terminated) */
+    MUNCH_TIME_LIMIT = 2 /* episode frame limit reached (truncated) */
+};
+
+/* munch_env_observe cell codes; actors are drawn over the maze. */
+enum
+{
+    MUNCH_CELL_EMPTY = 0,
+    MUNCH_CELL_WALL = 1,
+    MUNCH_CELL_PELLET = 2,
+    MUNCH_CELL_POWER_PELLET = 3,
+    MUNCH_CELL_DOOR = 4,
+    MUNCH_CELL_FRUIT = 5,
+    MUNCH_CELL_MUNCHER = 6,
+    MUNCH_CELL_GHOST = 7,            /* dangerous */
+    MUNCH_CELL_FRIGHTENED_GHOST = 8, /* edible */
+    MUNCH_CELL_EATEN_GHOST = 9       /* harmless eyes heading home */
+};
+
+/* munch_env_encode bit planes, in buffer order (PlaneEncoder.h). */
+enum
+{
+    MUNCH_PLANE_WALL = 0,
+    MUNCH_PLANE_PELLET = 1,
+    MUNCH_PLANE_POWER_PELLET = 2,
+    MUNCH_PLANE_DOOR = 3,
+    MUNCH_PLANE_TUNNEL = 4,
+    MUNCH_PLANE_FRUIT = 5,
+    MUNCH_PLANE_MUNCHER = 6,
+    MUNCH_PLANE_GHOST_DANGEROUS = 7,
+    MUNCH_PLANE_GHOST_FRIGHTENED = 8,
+    MUNCH_PLANE_GHOST_EYES = 9,
+    MUNCH_PLANE_GHOST_0 = 10, /* ghosts 0-3 by spawn order, any state */
+    MUNCH_PLANE_COUNT = 14
+};
+
+#define MUNCH_ENV_MAX_GHOSTS 8
+
+/* Everything that is not a map cell. Directions: 0 up, 1 down, 2 left, 3 right. */
+typedef struct MunchEnvState
+{
+    int32_t score;
+    int32_t lives;
+    int32_t level;
+    int32_t frame;         /* frames since reset */
+    int32_t pellets_left;  /* pellets + power pellets */
+    int32_t frightened;    /* 1 while a power pellet is active */
+    int32_t muncher_x, muncher_y, muncher_dir;
+    int32_t ghost_count;
+    int32_t ghost_x[MUNCH_ENV_MAX_GHOSTS];
+    int32_t ghost_y[MUNCH_ENV_MAX_GHOSTS];
+    int32_t ghost_dir[MUNCH_ENV_MAX_GHOSTS];
+    int32_t ghost_cell[MUNCH_ENV_MAX_GHOSTS]; /* MUNCH_CELL_*_GHOST */
+} MunchEnvState;
+
+/* New environment on a map (.png or compiled .pmm; NULL = the shipped map).
+   frame_skip = 60 Hz game frames per step (< 1 means 1). Environments on the
+   same map share one read-only copy of it. Returns NULL if the map fails to
+   load. The environment starts reset with seed 1. */
+MUNCH_ENV_API MunchEnv *munch_env_create(const char *map_path, int frame_skip);
+MUNCH_ENV_API void munch_env_destroy(MunchEnv *env);
+
+/* Episode length cap in frames (default 72000 = 20 minutes of game time). */
+MUNCH_ENV_API void munch_env_set_max_frames(MunchEnv *env, int32_t max_frames);
+
+/* Fresh game: level 1, score 0, three lives; the seed drives frightened ghosts.
+   Returns 0, or MUNCH_ERROR if the new game could not be set up. */
+MUNCH_ENV_API int munch_env_reset(MunchEnv *env, uint64_t seed);
+
+/* Apply `action` and run frame_skip frames. *reward (if not NULL) receives the
+   points scored. Returns MUNCH_RUNNING, MUNCH_GAME_OVER, MUNCH_TIME_LIMIT or
+   MUNCH_ERROR; a finished episode stays finished (reward 0) until munch_env_reset. */
+MUNCH_ENV_API int munch_env_step(MunchEnv *env, int action, float *reward);
+
+/* Step envs[0..count) with actions[i] on up to `threads` threads (0 = one per
+   core). rewards and results (either may be NULL) receive one entry per env.
+   Finished environments are not reset automatically. Returns 0, or
+   MUNCH_ERROR if any environment's step failed (its result says which) or
+   the batch could not be started at all (results are then left alone). */
+MUNCH_ENV_API int munch_env_step_many(MunchEnv *const *envs, int count, const int *actions, float *rewards,
+                                       int *results, int threads);
+
+/* Map size in tiles; munch_env_observe writes width * height bytes, row-major. */
+MUNCH_ENV_API int munch_env_width(const MunchEnv *env);
+MUNCH_ENV_API int munch_env_height(const MunchEnv *env);
+MUNCH_ENV_API void munch_env_observe(const MunchEnv *env, uint8_t *cells);
+MUNCH_ENV_API void munch_env_state(const MunchEnv *env, MunchEnvState *out);
+
+/* Bit-plane observation, written straight into the caller's buffer of
+   MUNCH_PLANE_COUNT * munch_env_plane_bytes(env) bytes. Cell (x, y) of a plane
+   is bit i % 8 of byte i / 8, i = y * width + x (numpy: unpackbits with
+   bitorder="little"); planes are padded to 8 bytes.
+   Incremental: if `planes` is the buffer passed last time and still holds what
+   was written, only cells that changed are touched. A different buffer, or
+   full != 0, rewrites it all. Returns 0, or MUNCH_ERROR (pass full next time). */
+MUNCH_ENV_API size_t munch_env_plane_bytes(const MunchEnv *env);
+MUNCH_ENV_API int munch_env_encode(MunchEnv *env, uint8_t *planes, int full);
+
+/* Encode envs[0..count) into one contiguous buffer: env i writes at
+   planes + i * MUNCH_PLANE_COUNT * munch_env_plane_bytes(envs[0]), so every
+   environment must be on a map of the same size. Returns 0, or MUNCH_ERROR if
+   any environment could not be encoded. */
+MUNCH_ENV_API int munch_env_encode_many(MunchEnv *const *envs, int count, uint8_t *planes, int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MUNCH_ENV_H */
@@ -0,0 +1,119 @@
+// aitrace — print a ghost AI trace written by `munch_maze --ai-trace` (or the
+// dev-mode T key).
+//
+//   aitrace trace.bin           counters plus a per-ghost summary
+//   aitrace trace.bin --tail N  ...and the last N records, one per line
+//
+// Compare AI variants by recording the same headless games with each, e.g.
+//   munch_maze --headless 20 --ai-trace greedy.bin
+//   munch_maze --headless 20 --ghost-search 250 --ai-trace search.bin
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AITrace.h"
+
+static const char *const MODE_NAMES[3] = {"SCATTER", "CHASE", "FRIGHTENED"};
+static const char *const DIRECTION_NAMES[4] = {"UP", "DOWN", "LEFT", "RIGHT"};
+static const char *const GHOST_NAMES[4] = {"JACK", "MIKE", "SAM", "WILL"};
+
+static std::string candidateString(std::uint8_t mask)
+{
+    std::string out;
+    for (int d = 0; d < 4; ++d)
+    {
+        if (mask & (1u << d))
+            out += DIRECTION_NAMES[d][0];
+    }
+    return out.empty() ? "-" : out;
+}
+
+static void printRecord(const AITraceRecord &r)
+{
+    std::cout << std::setw(8) << r.tick << "  ";
+    if (r.kind == AITraceRecord::MODE_CHANGE)
+    {
+        std::cout << "mode " << MODE_NAMES[r.chosen % 3] << " -> " << MODE_NAMES[r.mode % 3] << "\n";
+        return;
+    }
+    std::cout << (r.ghost < 4 ? GHOST_NAMES[r.ghost] : "ghost") << (r.ghost < 4 ? "" : std::to_string(r.ghost))
+              << " " << MODE_NAMES[r.mode % 3] << " at (" << r.tileX << "," << r.tileY << ")";
+    if (!(r.flags & AITraceRecord::RANDOM))
+        std::cout << " target (" << r.targetX << "," << r.targetY << ")";
+    std::cout << " options " << candidateString(r.candidates) << " -> " << DIRECTION_NAMES[r.chosen % 4];
+    if (r.flags & AITraceRecord::SEARCHED)
+        std::cout << " [search " << r.searchNodes << " nodes]";
+    if (r.flags & AITraceRecord::FROM_WORKER)
+        std::cout << " [worker]";
+    if (r.nanos)
+        std::cout << " " << r.nanos << " ns";
+    std::cout << "\n";
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: aitrace trace.bin [--tail N]" << std::endl;
+        return 1;
+    }
+    int tail = 0;
+    for (int i = 2; i + 1 < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--tail")
+            tail = std::atoi(argv[++i]);
+    }
+
+    AITrace::FileHeader header;
+    std::vector<AITraceRecord> records;
+    if (!AITrace::load(argv[1], header, records))
+    {
+        std::cout << argv[1] << ": not a ghost AI trace (or a different version)" << std::endl;
+        return 1;
+    }
+
+    AITrace::printCounters(std::cout, header.counters);
+
+    // Per-ghost summary over the records the ring still held.
+    struct GhostSummary
+    {
+        long decisions = 0, searched = 0, junctions = 0, nanos = 0;
+        long chosen[4] = {};
+    };
+    std::vector<GhostSummary> ghosts;
+    for (const AITraceRecord &r : records)
+    {
+        if (r.kind != AITraceRecord::DECISION)
+            continue;
+        if (r.ghost >= ghosts.size())
+            ghosts.resize(r.ghost + 1);
+        GhostSummary &g = ghosts[r.ghost];
+        g.decisions++;
+        g.searched += (r.flags & AITraceRecord::SEARCHED) ? 1 : 0;
+        int options = 0;
+        for (int d = 0; d < 4; ++d)
+            options += (r.candidates >> d) & 1;
+        g.junctions += options > 2 ? 1 : 0;
+        g.nanos += r.nanos;
+        g.chosen[r.chosen % 4]++;
+    }
+
+    std::cout << records.size() << " records (first tick " << (records.empty() ? 0 : records.front().tick) << ")\n";
+    for (std::size_t i = 0; i < ghosts.size(); ++i)
+    {
+        const GhostSummary &g = ghosts[i];
+        if (!g.decisions)
+            continue;
+        std::cout << "  " << std::left << std::setw(5) << (i < 4 ? GHOST_NAMES[i] : "ghost") << std::right
+                  << " decisions " << g.decisions << ", at junctions " << g.junctions << ", searched " << g.searched
+                  << ", avg " << g.nanos / g.decisions << " ns; U/D/L/R " << g.chosen[0] << "/" << g.chosen[1] << "/"
+                  << g.chosen[2] << "/" << g.chosen[3] << "\n";
+    }
+
+    std::size_t from = records.size() > static_cast<std::size_t>(std::max(tail, 0)) ? records.size() - tail : 0;
+    for (std::size_t i = from; tail > 0 && i < records.size(); ++i)
+        printRecord(records[i]);
+    std::cout << std::flush;
+    return 0;
+}
@@ -0,0 +1,171 @@
+// envcheck — the RL environment's two observations must tell the same story.
+//
+//   envcheck [map.png|map.pmm] [--envs N] [--steps N] [--seed N]
+//
+// Plays N environments (default 8) with random actions for --steps steps
+// (default 3000) and, after every step, checks each munch_env_observe cell
+// code against the munch_env_encode bit planes at that cell: the code must
+// be the one the planes imply, with actors drawn over the maze (ghosts, then
+// the muncher, then fruit) and the maze as door, wall, power pellet, pellet
+// or empty. Also checks that every code the map can produce turns up (a
+// door plane with no door cells means observe lost them). Exit status 1 on
+// any disagreement. Built with the library's source: `make env-check`.
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "munch_env.h"
+
+// Whether bit `cell` of plane `plane` is set.
+static bool planeBit(const std::vector<std::uint8_t> &planes, std::size_t planeBytes, int plane, std::size_t cell)
+{
+    return (planes[plane * planeBytes + (cell >> 3)] >> (cell & 7)) & 1;
+}
+
+// The observe code one cell's planes stand for; a cell under several ghosts
+// may be any of their codes (the last one drawn wins), so ghost cells are
+// checked separately.
+static int impliedCode(const std::vector<std::uint8_t> &planes, std::size_t planeBytes, std::size_t cell)
+{
+    if (planeBit(planes, planeBytes, MUNCH_PLANE_MUNCHER, cell))
+        return MUNCH_CELL_MUNCHER;
+    if (planeBit(planes, planeBytes, MUNCH_PLANE_FRUIT, cell))
+        return MUNCH_CELL_FRUIT;
+    if (planeBit(planes, planeBytes, MUNCH_PLANE_DOOR, cell))
+        return MUNCH_CELL_DOOR;
+    if (planeBit(planes, planeBytes, MUNCH_PLANE_WALL, cell))
+        return MUNCH_CELL_WALL;
+    if (planeBit(planes, planeBytes, MUNCH_PLANE_POWER_PELLET, cell))
+        return MUNCH_CELL_POWER_PELLET;
+    if (planeBit(planes, planeBytes, MUNCH_PLANE_PELLET, cell))
+        return MUNCH_CELL_PELLET;
+    return MUNCH_CELL_EMPTY;
+}
+
+int main(int argc, char **argv)
+{
+    const char *mapPath = nullptr;
+    int envCount = 8;
+    int steps = 3000;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--envs" && i + 1 < argc)
+            envCount = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--steps" && i + 1 < argc)
+            steps = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg.rfind("--", 0) != 0)
+            mapPath = argv[i];
+        else
+        {
+            std::cout << "Usage: envcheck [map.png|map.pmm] [--envs N] [--steps N] [--seed N]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<MunchEnv *> envs;
+    for (int i = 0; i < envCount; ++i)
+    {
+        MunchEnv *env = munch_env_create(mapPath, 4);
+        if (!env)
+        {
+            std::cout << "Cannot create an environment on " << (mapPath ? mapPath : "the shipped map") << std::endl;
+            return 1;
+        }
+        if (munch_env_reset(env, seed + i) != 0)
+        {
+            std::cout << "Cannot reset environment " << i << std::endl;
+            return 1;
+        }
+        envs.push_back(env);
+    }
+
+    const int width = munch_env_width(envs[0]), height = munch_env_height(envs[0]);
+    const std::size_t cells = static_cast<std::size_t>(width) * height;
+    const std::size_t planeBytes = munch_env_plane_bytes(envs[0]);
+    std::vector<std::uint8_t> codes(cells);
+    std::vector<std::vector<std::uint8_t>> planes(envs.size(),
+                                                  std::vector<std::uint8_t>(planeBytes * MUNCH_PLANE_COUNT));
+    std::vector<long> seen(MUNCH_CELL_EATEN_GHOST + 1, 0);
+    std::vector<long> planeCells(MUNCH_PLANE_COUNT, 0);
+    std::minstd_rand rng(seed);
+    long checked = 0;
+    int failures = 0;
+
+    for (int step = 0; step <= steps && failures < 10; ++step)
+    {
+        for (std::size_t e = 0; e < envs.size() && failures < 10; ++e)
+        {
+            MunchEnv *env = envs[e];
+            if (step > 0 && munch_env_step(env, static_cast<int>(rng() % MUNCH_ACTION_COUNT), nullptr) != MUNCH_RUNNING)
+                munch_env_reset(env, seed + static_cast<unsigned>(e) + static_cast<unsigned>(step));
+            munch_env_observe(env, codes.data());
+            munch_env_encode(env, planes[e].data(), 0); // incremental, as a trainer would call it
+
+            for (std::size_t c = 0; c < cells; ++c)
+            {
+                ++seen[codes[c]];
+                for (int p = 0; p < MUNCH_PLANE_COUNT; ++p)
+                    planeCells[p] += planeBit(planes[e], planeBytes, p, c);
+
+                int want = impliedCode(planes[e], planeBytes, c);
+                bool ok;
+                switch (codes[c])
+                {
+                case MUNCH_CELL_GHOST:
+                    ok = planeBit(planes[e], planeBytes, MUNCH_PLANE_GHOST_DANGEROUS, c);
+                    break;
+                case MUNCH_CELL_FRIGHTENED_GHOST:
+                    ok = planeBit(planes[e], planeBytes, MUNCH_PLANE_GHOST_FRIGHTENED, c);
+                    break;
+                case MUNCH_CELL_EATEN_GHOST:
+                    ok = planeBit(planes[e], planeBytes, MUNCH_PLANE_GHOST_EYES, c);
+                    break;
+                default:
+                    ok = codes[c] == want && !planeBit(planes[e], planeBytes, MUNCH_PLANE_GHOST_DANGEROUS, c) &&
+                         !planeBit(planes[e], planeBytes, MUNCH_PLANE_GHOST_FRIGHTENED, c) &&
+                         !planeBit(planes[e], planeBytes, MUNCH_PLANE_GHOST_EYES, c);
+                    break;
+                }
+                ++checked;
+                if (!ok)
+                {
+                    ++failures;
+                    std::cout << "  env " << e << " step " << step << " cell (" << c % width << "," << c / width
+                              << "): observe says " << static_cast<int>(codes[c]) << ", planes say " << want
+                              << std::endl;
+                }
+            }
+        }
+    }
+
+    // A plane with bits set whose code never appears (and is not hidden
+    // under actors every time) means observe never emits that code.
+    const int pairs[][2] = {{MUNCH_PLANE_WALL, MUNCH_CELL_WALL},
+                            {MUNCH_PLANE_DOOR, MUNCH_CELL_DOOR},
+                            {MUNCH_PLANE_PELLET, MUNCH_CELL_PELLET},
+                            {MUNCH_PLANE_POWER_PELLET, MUNCH_CELL_POWER_PELLET}};
+    for (const auto &pair : pairs)
+    {
+        if (planeCells[pair[0]] > 0 && seen[pair[1]] == 0)
+        {
+            ++failures;
+            std::cout << "  plane " << pair[0] << " has " << planeCells[pair[0]] << " cells set, but observe never wrote code "
+                      << pair[1] << std::endl;
+        }
+    }
+
+    for (MunchEnv *env : envs)
+        munch_env_destroy(env);
+    std::cout << checked << " cells checked on " << width << "x" << height << " (" << seen[MUNCH_CELL_DOOR]
+              << " door, " << seen[MUNCH_CELL_WALL] << " wall): "
+              << (failures ? std::to_string(failures) + " disagreements" : std::string("observe and planes agree"))
+              << std::endl;
+    return failures ? 1 : 0;
+}
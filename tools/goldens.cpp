@@ -0,0 +1,605 @@
+// goldens — golden ghost decisions: record them, and check AI implementations
+// against them (DecisionCorpus.h).
+//
+//   goldens record out.gdc [options]        decision points from bot-played games
+//     --map file.png|file.pmm               board (default: the shipped map)
+//     --generate WxH --seed N               ...or a generated one
+//     --games N                             games to sample (default 20)
+//     --cases N                             keep N distinct cases, spread over the games (default 200000)
+//     --bot S                               bot strength 0-10 (default 6)
+//   goldens check corpus.gdc [options]      replay every case through each implementation
+//     --impl a,b,...                        which ones (default: every golden one)
+//     --repeat N                            passes over the corpus, for timing (default 10)
+//     --show N                              mismatches to print in full (default 10)
+//   goldens list                            the implementations
+//
+// Each decision point is taken as the ghost waits on a tile for its next
+// move, and kept in both scatter and chase and with the muncher facing each
+// way, so every personality meets every quirk (the ambusher's up-and-left
+// target when the muncher faces UP) whatever the games happened to do.
+//
+// An implementation decides every case of the corpus in one call (so batched
+// and vectorised ones can batch); check compares its target and move with the
+// recorded ones and breaks mismatches down by personality and mode. Add a
+// new AI variant to IMPLEMENTATIONS below and run `make goldens-check`
+// before swapping it in. "ambusher-fixed" straightens the ambusher's target
+// on purpose; it is there to show what a mismatch looks like.
+//
+// The corpus is recorded from the current GhostAI, so on its own it only
+// pins today's behaviour. "baseline" holds it to the AI the game shipped
+// with: a frozen copy of the original getTargetTile / getBestDirection,
+// which answers the cases it can model (the classic four in their classic
+// roles on the classic board) and skips the rest.
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "DecisionCorpus.h"
+#include "GameConfig.h"
+#include "GameSession.h"
+#include "GreedyBatch.h"
+#include "Grid.h"
+#include "MazeGenerator.h"
+#include "MuncherBot.h"
+#include "Spookie_Chase.h"
+
+static const float MAX_GAME_SECONDS = 600.0f;
+
+// One decision: where the ghost aims, and the step it takes.
+struct Answer
+{
+    sf::Vector2i target;
+    GhostDirection move;
+    bool skipped; // outside what the implementation models; not scored
+};
+
+struct Implementation
+{
+    const char *name;
+    const char *about;
+    bool golden; // expected to match every case
+    void (*run)(const DecisionCorpus &corpus, const Grid &grid, std::vector<Answer> &out);
+};
+
+// GhostAI::decide, the live path: personality dispatch, target, greedy step
+// (no search budget, so no lookahead).
+static void runDecide(const DecisionCorpus &corpus, const Grid &grid, std::vector<Answer> &out)
+{
+    GhostAI ai(grid.getWidth(), grid.getHeight());
+    const std::vector<DecisionCase> &cases = corpus.getCases();
+    for (std::size_t i = 0; i < cases.size(); ++i)
+    {
+        const DecisionCase &c = cases[i];
+        sf::Vector2i chaserTile;
+        const sf::Vector2i *chaser = c.chaser(chaserTile);
+        GhostView ghost = c.ghostView();
+        MuncherView muncher = c.muncherView();
+        out[i].move = ai.decide(grid, ghost, muncher, chaser, c.getMode());
+        out[i].target = ai.targetFor(ghost, muncher, chaser, c.getMode());
+    }
+}
+
+// Greedy steps scored on vector registers (GreedyBatch, what lockstep games
+// use); long-range chase steps are routed first, as queueUpdate does.
+static void runBatch(const DecisionCorpus &corpus, const Grid &grid, std::vector<Answer> &out)
+{
+    static const int CHUNK = 4096;
+    GhostAI ai(grid.getWidth(), grid.getHeight());
+    GreedyBatch batch;
+    const std::vector<DecisionCase> &cases = corpus.getCases();
+    for (std::size_t first = 0; first < cases.size(); first += CHUNK)
+    {
+        std::size_t last = std::min(cases.size(), first + CHUNK);
+        batch.clear();
+        for (std::size_t i = first; i < last; ++i)
+        {
+            const DecisionCase &c = cases[i];
+            sf::Vector2i chaserTile;
+            GhostView ghost = c.ghostView();
+            out[i].target = ai.targetFor(ghost, c.muncherView(), c.chaser(chaserTile), c.getMode());
+            int routed = GhostAI::longRangeStep(grid, ghost, out[i].target, c.getMode());
+            if (routed >= 0)
+                out[i].move = static_cast<GhostDirection>(routed);
+            else
+                batch.add(0, static_cast<int>(i - first), grid, ghost, out[i].target);
+        }
+        batch.solve();
+        for (int q = 0; q < batch.size(); ++q)
+            out[first + batch.ghost(q)].move = batch.direction(q);
+    }
+}
+
+// No board for the greedy step: the legal steps from the case's `open` bits,
+// the choices for each (open, heading) from a table built once. Long-range
+// chase steps still take the board's path hierarchy.
+struct StepTable
+{
+    std::uint8_t options[16][4]; // directions to score; 0 = none legal (keep heading)
+
+    StepTable()
+    {
+        static const int opposite[4] = {1, 0, 3, 2};
+        for (int open = 0; open < 16; ++open)
+        {
+            for (int heading = 0; heading < 4; ++heading)
+            {
+                int preferred = open & ~(1 << opposite[heading]);
+                options[open][heading] = static_cast<std::uint8_t>(preferred ? preferred : open);
+            }
+        }
+    }
+};
+
+static GhostDirection stepFromTable(const Grid &grid, const DecisionCase &c, sf::Vector2i target)
+{
+    int routed = GhostAI::longRangeStep(grid, c.ghostView(), target, c.getMode());
+    if (routed >= 0)
+        return static_cast<GhostDirection>(routed);
+
+    static const StepTable table;
+    static const int offsetX[4] = {0, 0, -1, 1};
+    static const int offsetY[4] = {-1, 1, 0, 0};
+    int options = table.options[c.open & 15][c.heading & 3];
+    int chosen = c.heading;
+    float best = std::numeric_limits<float>::max();
+    for (int d = 0; d < 4; ++d)
+    {
+        if (!(options >> d & 1))
+            continue;
+        float distance = tileDistance(sf::Vector2i(c.tileX + offsetX[d], c.tileY + offsetY[d]), target);
+        if (distance < best)
+        {
+            best = distance;
+            chosen = d;
+        }
+    }
+    return static_cast<GhostDirection>(chosen);
+}
+
+static sf::Vector2i tableTarget(const DecisionCase &c)
+{
+    if (c.getMode() == AIMode::SCATTER)
+        return sf::Vector2i(c.scatterX, c.scatterY);
+    sf::Vector2i chaserTile;
+    GhostView ghost = c.ghostView();
+    MuncherView muncher = c.muncherView();
+    return GhostPersonalities::get(c.personality).chaseTarget(TargetContext{ghost, muncher, c.chaser(chaserTile), ghost.scatter});
+}
+
+static void runTable(const DecisionCorpus &corpus, const Grid &grid, std::vector<Answer> &out)
+{
+    const std::vector<DecisionCase> &cases = corpus.getCases();
+    for (std::size_t i = 0; i < cases.size(); ++i)
+    {
+        out[i].target = tableTarget(cases[i]);
+        out[i].move = stepFromTable(grid, cases[i], out[i].target);
+    }
+}
+
+// The table path with the ambusher aiming straight up when the muncher faces
+// UP (the "fixed" arcade bug): must be flagged.
+static void runAmbusherFixed(const DecisionCorpus &corpus, const Grid &grid, std::vector<Answer> &out)
+{
+    const int ambusher = GhostPersonalities::forType(GhostType::MIKE);
+    const std::vector<DecisionCase> &cases = corpus.getCases();
+    for (std::size_t i = 0; i < cases.size(); ++i)
+    {
+        const DecisionCase &c = cases[i];
+        out[i].target = tableTarget(c);
+        if (c.personality == ambusher && c.getMode() == AIMode::CHASE &&
+            static_cast<MuncherDirection>(c.muncherHeading) == MuncherDirection::UP)
+            out[i].target = sf::Vector2i(c.muncherX, c.muncherY - AmbusherPolicy::AMBUSH_DISTANCE);
+        out[i].move = stepFromTable(grid, c, out[i].target);
+    }
+}
+
+// The ghost AI as the game first shipped it: getTargetTile and
+// getBestDirection with their helpers, copied from the original
+// Spookie_Chase.h and changed only to read a case instead of Ghost and
+// Muncher objects. Frozen on purpose: do not update it along with GhostAI.
+// It knows four ghosts, one per GhostType, with their corners hard-coded for
+// the classic 28x31 board, so it answers the first four ghosts of a line-up
+// with the personality their type had, on a board of that size, and skips
+// the rest. Their scatter targets are part of the answer, not of the test
+// for coverage: a line-up that moves the classic corners must mismatch.
+struct BaselineAI
+{
+    static constexpr int AMBUSH_DISTANCE = 4;
+    static constexpr float BASHFUL_RETREAT_DISTANCE = 8.0f;
+    sf::Vector2i scatterCorners[4] = {sf::Vector2i(1, 1), sf::Vector2i(26, 1), sf::Vector2i(1, 29),
+                                      sf::Vector2i(26, 29)};
+
+    bool covers(const DecisionCase &c, const Grid &grid) const
+    {
+        return grid.getWidth() == GameConfig::GRID_WIDTH && grid.getHeight() == GameConfig::GRID_HEIGHT &&
+               (c.flags & DecisionCase::CLASSIC_SLOT) && c.type < 4 &&
+               c.personality == GhostPersonalities::forType(static_cast<GhostType>(c.type));
+    }
+
+    sf::Vector2i getTargetTile(const DecisionCase &c) const
+    {
+        sf::Vector2i muncherPos(c.muncherX, c.muncherY);
+        if (c.getMode() == AIMode::SCATTER)
+            return scatterCorners[c.type];
+        switch (static_cast<GhostType>(c.type))
+        {
+        case GhostType::JACK: // CHASER
+            return muncherPos;
+        case GhostType::MIKE: // AMBUSHER
+        {
+            sf::Vector2i offset(0, 0);
+            switch (static_cast<MuncherDirection>(c.muncherHeading))
+            {
+            case MuncherDirection::UP:
+                // Original bug: offset both up and left when facing up
+                offset = sf::Vector2i(-AMBUSH_DISTANCE / 2, -AMBUSH_DISTANCE / 2);
+                break;
+            case MuncherDirection::DOWN:
+                offset = sf::Vector2i(0, AMBUSH_DISTANCE);
+                break;
+            case MuncherDirection::LEFT:
+                offset = sf::Vector2i(-AMBUSH_DISTANCE, 0);
+                break;
+            case MuncherDirection::RIGHT:
+                offset = sf::Vector2i(AMBUSH_DISTANCE, 0);
+                break;
+            }
+            return muncherPos + offset;
+        }
+        case GhostType::SAM: // FICKLE
+        {
+            if (!(c.flags & DecisionCase::HAS_CHASER))
+                return muncherPos; // Fallback
+            sf::Vector2i offset(0, 0);
+            switch (static_cast<MuncherDirection>(c.muncherHeading))
+            {
+            case MuncherDirection::UP:
+                offset = sf::Vector2i(0, -2);
+                break;
+            case MuncherDirection::DOWN:
+                offset = sf::Vector2i(0, 2);
+                break;
+            case MuncherDirection::LEFT:
+                offset = sf::Vector2i(-2, 0);
+                break;
+            case MuncherDirection::RIGHT:
+                offset = sf::Vector2i(2, 0);
+                break;
+            }
+            sf::Vector2i midPoint = muncherPos + offset;
+            sf::Vector2i vector = midPoint - c.chaserTile();
+            return midPoint + vector;
+        }
+        case GhostType::WILL: // BASHFUL
+            if (calculateDistance(sf::Vector2i(c.tileX, c.tileY), muncherPos) < BASHFUL_RETREAT_DISTANCE)
+                return scatterCorners[c.type];
+            return muncherPos;
+        default:
+            return muncherPos;
+        }
+    }
+
+    GhostDirection getBestDirection(const DecisionCase &c, sf::Vector2i targetTile, const Grid &grid) const
+    {
+        static const sf::Vector2i offsets[4] = {sf::Vector2i(0, -1), sf::Vector2i(0, 1), sf::Vector2i(-1, 0),
+                                                sf::Vector2i(1, 0)};
+        static const GhostDirection opposites[4] = {GhostDirection::DOWN, GhostDirection::UP, GhostDirection::RIGHT,
+                                                    GhostDirection::LEFT};
+        sf::Vector2i position(c.tileX, c.tileY);
+        GhostDirection heading = static_cast<GhostDirection>(c.heading);
+
+        // getValidDirections / Ghost::canMove: in bounds, and not a wall
+        // unless it is the ghost door and the ghost may pass it.
+        std::vector<GhostDirection> validDirs;
+        for (int d = 0; d < 4; ++d)
+        {
+            sf::Vector2i p = position + offsets[d];
+            if (p.x < 0 || p.x >= grid.getWidth() || p.y < 0 || p.y >= grid.getHeight())
+                continue;
+            if (!grid.isWall(p.x, p.y) || (grid.isGhostDoor(p.x, p.y) && (c.flags & DecisionCase::DOOR_OPEN)))
+                validDirs.push_back(static_cast<GhostDirection>(d));
+        }
+        if (validDirs.empty())
+            return heading; // Can't move anywhere
+
+        // Don't go backwards unless it's the only option
+        GhostDirection opposite = opposites[static_cast<int>(heading)];
+        std::vector<GhostDirection> preferredDirs;
+        for (GhostDirection dir : validDirs)
+        {
+            if (dir != opposite)
+                preferredDirs.push_back(dir);
+        }
+        std::vector<GhostDirection> &dirsToCheck = preferredDirs.empty() ? validDirs : preferredDirs;
+
+        // Find direction that gets closest to target
+        GhostDirection bestDir = dirsToCheck[0];
+        float bestDistance = std::numeric_limits<float>::max();
+        for (GhostDirection dir : dirsToCheck)
+        {
+            float distance = calculateDistance(position + offsets[static_cast<int>(dir)], targetTile);
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                bestDir = dir;
+            }
+        }
+        return bestDir;
+    }
+
+    static float calculateDistance(sf::Vector2i pos1, sf::Vector2i pos2)
+    {
+        float dx = static_cast<float>(pos1.x - pos2.x);
+        float dy = static_cast<float>(pos1.y - pos2.y);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+};
+
+static void runBaseline(const DecisionCorpus &corpus, const Grid &grid, std::vector<Answer> &out)
+{
+    BaselineAI ai;
+    const std::vector<DecisionCase> &cases = corpus.getCases();
+    for (std::size_t i = 0; i < cases.size(); ++i)
+    {
+        const DecisionCase &c = cases[i];
+        out[i].skipped = !ai.covers(c, grid);
+        if (out[i].skipped)
+            continue;
+        out[i].target = ai.getTargetTile(c);
+        out[i].move = ai.getBestDirection(c, out[i].target, grid);
+    }
+}
+
+static const Implementation IMPLEMENTATIONS[] = {
+    {"decide", "GhostAI::decide (personality dispatch + greedy step)", true, runDecide},
+    {"batch", "targetFor + GreedyBatch (vectorised greedy steps)", true, runBatch},
+    {"table", "board-free: policy target + (open, heading) step table", true, runTable},
+    {"baseline", "the original getTargetTile / getBestDirection, frozen (classic four on the classic board)", true,
+     runBaseline},
+    {"ambusher-fixed", "table, with the ambusher's UP quirk straightened (expected to mismatch)", false, runAmbusherFixed},
+};
+
+static const char *const USAGE =
+    "Usage: goldens record out.gdc [--map file | --generate WxH] [--seed N] [--games N] [--cases N] [--bot S]\n"
+    "       goldens check corpus.gdc [--impl a,b,...] [--repeat N] [--show N]\n"
+    "       goldens list\n";
+
+static const char *const MODE_NAMES[3] = {"scatter", "chase", "frightened"};
+
+static bool isAmbusherUp(const DecisionCase &c)
+{
+    return c.personality == GhostPersonalities::forType(GhostType::MIKE) && c.getMode() == AIMode::CHASE &&
+           static_cast<MuncherDirection>(c.muncherHeading) == MuncherDirection::UP;
+}
+
+static int record(const std::string &outPath, int argc, char **argv)
+{
+    std::string mapPath = GameConfig::MAZE_IMAGE;
+    bool customMap = false;
+    int genWidth = 0, genHeight = 0;
+    unsigned long long seed = 1;
+    int games = 20;
+    std::size_t maxCases = 200000;
+    int botStrength = 6;
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--map" && i + 1 < argc)
+        {
+            mapPath = argv[++i];
+            customMap = true;
+        }
+        else if (arg == "--generate" && i + 1 < argc)
+            std::sscanf(argv[++i], "%dx%d", &genWidth, &genHeight);
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--games" && i + 1 < argc)
+            games = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--cases" && i + 1 < argc)
+            maxCases = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        else if (arg == "--bot" && i + 1 < argc)
+            botStrength = std::max(0, std::min(10, std::atoi(argv[++i])));
+        else
+        {
+            std::cout << "Unknown option " << arg << "\n" << USAGE << std::flush;
+            return 1;
+        }
+    }
+
+    Grid grid(GameConfig::GRID_WIDTH, GameConfig::GRID_HEIGHT, false);
+    if (genWidth > 0 && genHeight > 0)
+        MazeGenerator(seed).generate(grid, genWidth, genHeight);
+    else if (!(std::filesystem::path(mapPath).extension() == ".pmm" ? grid.loadCompiledMap(mapPath)
+                                                                    : grid.loadMazeFromImage(mapPath, customMap)))
+    {
+        std::cout << "Cannot load map " << mapPath << std::endl;
+        return 1;
+    }
+
+    // Every registered personality, twice over, so each meets a chaser and
+    // the others on the board.
+    std::vector<int> roster;
+    for (int k = 0; k < 2 * GhostPersonalities::count(); ++k)
+        roster.push_back(k % GhostPersonalities::count());
+
+    DecisionCorpus corpus;
+    corpus.setBoard(grid);
+    const sf::Time frame = sf::seconds(1.0f / 60.0f);
+    int played = 0;
+    for (; played < games; ++played)
+    {
+        GameSession session = GameSession::headless(grid);
+        session.setRoster(roster);
+        MuncherBot::Settings settings;
+        settings.strength = botStrength / 10.0f;
+        settings.seed = static_cast<unsigned>(seed) + played;
+        MuncherBot bot(settings);
+        while (!session.isGameOver() && session.getTime().asSeconds() < MAX_GAME_SECONDS)
+        {
+            bot.play(session);
+            session.step(frame);
+
+            const GhostAI &ai = session.getGhostAI();
+            if (ai.getCurrentMode() == AIMode::FRIGHTENED)
+                continue;
+            const Ghost *chaserGhost = ai.getChaserGhost();
+            sf::Vector2i chaserTile = chaserGhost ? chaserGhost->getPosition() : sf::Vector2i();
+            const std::vector<Ghost> &ghosts = session.getGhosts();
+            for (std::size_t slot = 0; slot < ghosts.size(); ++slot)
+            {
+                const Ghost &ghost = ghosts[slot];
+                if (!GhostAI::needsDecision(ghost))
+                    continue;
+                for (AIMode mode : {AIMode::SCATTER, AIMode::CHASE})
+                {
+                    for (int heading = 0; heading < 4; ++heading)
+                    {
+                        MuncherView muncher{session.getMuncher().getPosition(), static_cast<MuncherDirection>(heading)};
+                        corpus.add(DecisionCorpus::capture(ai, grid, GhostAI::viewOf(ghost), muncher,
+                                                           chaserGhost ? &chaserTile : nullptr, mode,
+                                                           static_cast<int>(slot)));
+                    }
+                }
+            }
+        }
+        corpus.dedupe();
+    }
+
+    corpus.thin(maxCases);
+    std::cout << played << " games on " << grid.getWidth() << "x" << grid.getHeight() << ": " << corpus.size()
+              << " distinct decisions" << std::endl;
+    return corpus.save(outPath) ? 0 : 1;
+}
+
+static int check(const std::string &path, int argc, char **argv)
+{
+    std::vector<std::string> names;
+    int repeat = 10;
+    int show = 10;
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--impl" && i + 1 < argc)
+        {
+            std::stringstream list(argv[++i]);
+            for (std::string name; std::getline(list, name, ',');)
+                names.push_back(name);
+        }
+        else if (arg == "--repeat" && i + 1 < argc)
+            repeat = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--show" && i + 1 < argc)
+            show = std::max(0, std::atoi(argv[++i]));
+        else
+        {
+            std::cout << "Unknown option " << arg << "\n" << USAGE << std::flush;
+            return 1;
+        }
+    }
+
+    DecisionCorpus corpus;
+    if (!corpus.load(path))
+    {
+        std::cout << path << ": not a decision corpus (or a different version)" << std::endl;
+        return 1;
+    }
+    Grid grid(1, 1, false);
+    corpus.buildGrid(grid);
+    const std::vector<DecisionCase> &cases = corpus.getCases();
+    long ambusherUp = std::count_if(cases.begin(), cases.end(), isAmbusherUp);
+    std::cout << path << ": " << cases.size() << " decisions on " << corpus.getWidth() << "x" << corpus.getHeight()
+              << " (" << ambusherUp << " with the ambusher's UP quirk)" << std::endl;
+
+    int failed = 0;
+    std::vector<Answer> answers(cases.size());
+    for (const Implementation &impl : IMPLEMENTATIONS)
+    {
+        bool picked = names.empty() ? impl.golden : std::find(names.begin(), names.end(), impl.name) != names.end();
+        if (!picked)
+            continue;
+
+        answers.assign(cases.size(), Answer{});
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeat; ++r)
+            impl.run(corpus, grid, answers);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Mismatches per personality and mode, plus the ambusher-UP cases on their own.
+        std::vector<long> byKind(static_cast<std::size_t>(GhostPersonalities::count()) * 2, 0);
+        long mismatches = 0, targets = 0, moves = 0, quirk = 0, skipped = 0;
+        for (std::size_t i = 0; i < cases.size(); ++i)
+        {
+            const DecisionCase &c = cases[i];
+            if (answers[i].skipped)
+            {
+                ++skipped;
+                continue;
+            }
+            bool targetOk = answers[i].target == c.target();
+            bool moveOk = static_cast<int>(answers[i].move) == c.chosen;
+            if (targetOk && moveOk)
+                continue;
+            ++mismatches;
+            targets += targetOk ? 0 : 1;
+            moves += moveOk ? 0 : 1;
+            quirk += isAmbusherUp(c) ? 1 : 0;
+            if (c.personality < GhostPersonalities::count())
+                byKind[static_cast<std::size_t>(c.personality) * 2 + c.mode % 2]++;
+            if (mismatches <= show)
+                std::cout << "    case " << i << ": " << GhostPersonalities::get(c.personality).name << " "
+                          << MODE_NAMES[c.mode % 3] << " at (" << c.tileX << "," << c.tileY << ") heading "
+                          << static_cast<int>(c.heading) << ", muncher (" << c.muncherX << "," << c.muncherY
+                          << ") facing " << static_cast<int>(c.muncherHeading) << ": target (" << c.targetX << ","
+                          << c.targetY << ") move " << static_cast<int>(c.chosen) << ", got (" << answers[i].target.x
+                          << "," << answers[i].target.y << ") move " << static_cast<int>(answers[i].move) << "\n";
+        }
+
+        std::string verdict = mismatches ? std::to_string(mismatches) + " mismatches"
+                              : skipped == static_cast<long>(cases.size()) ? std::string("no cases it models")
+                                                                           : std::string("ok");
+        std::cout << "  " << impl.name << ": " << verdict
+                  << " (" << static_cast<long>(cases.size() * repeat / std::max(seconds, 1e-9) / 1e6 * 10) / 10.0
+                  << " M decisions/s) - " << impl.about << std::endl;
+        if (skipped)
+            std::cout << "    " << cases.size() - skipped << " of " << cases.size() << " cases scored; "
+                      << skipped << " skipped as outside what it models" << std::endl;
+        if (mismatches)
+        {
+            std::cout << "    " << targets << " targets, " << moves << " moves differ; " << quirk
+                      << " on the ambusher's UP quirk\n    by kind:";
+            for (int k = 0; k < GhostPersonalities::count(); ++k)
+                for (int m = 0; m < 2; ++m)
+                    if (byKind[static_cast<std::size_t>(k) * 2 + m])
+                        std::cout << " " << GhostPersonalities::get(k).name << "/" << MODE_NAMES[m] << " "
+                                  << byKind[static_cast<std::size_t>(k) * 2 + m];
+            std::cout << std::endl;
+        }
+        if (mismatches && impl.golden)
+            ++failed;
+    }
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "record" && argc > 2)
+        return record(argv[2], argc, argv);
+    if (command == "check" && argc > 2)
+        return check(argv[2], argc, argv);
+    if (command == "list")
+    {
+        for (const Implementation &impl : IMPLEMENTATIONS)
+            std::cout << "  " << impl.name << (impl.golden ? "" : " (not golden)") << ": " << impl.about << "\n";
+        std::cout << std::flush;
+        return 0;
+    }
+    std::cout << USAGE << std::flush;
+    return 1;
+}
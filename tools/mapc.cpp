@@ -0,0 +1,162 @@
+// mapc — compile authoring PNG maps into the binary .pmm format the game maps.
+//
+//   mapc in.png [out.pmm]          compile one map (default: in.png -> in.pmm)
+//   mapc --size WxH in.png [out]   resample a PNG painted at more than 1px/tile
+//   mapc --info map.pmm            print the header and verify the content hash
+//   mapc --batch dir [outdir]      compile every .png in dir (into outdir, default dir)
+//
+// The game loads "<name>.pmm" in place of "<name>.png" whenever the compiled
+// file is at least as new as the PNG; `make maps` rebuilds the shipped one.
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BitFlood.h"
+#include "Grid.h"
+
+// Warn about pellets the muncher can't get to from its start (through the
+// tunnel too): a level with one can never be cleared.
+static void checkReachable(const Grid &grid, const std::string &name)
+{
+    if (!grid.isValidPosition(grid.getPlayerStartX(), grid.getPlayerStartY()))
+    {
+        std::cout << name << ": warning: no player start" << std::endl;
+        return;
+    }
+    std::shared_ptr<const PassMasks> masks = PassMasks::of(grid);
+    BitFlood &bfs = BitFlood::scratch();
+    bfs.flood(masks->muncher, sf::Vector2i(grid.getPlayerStartX(), grid.getPlayerStartY()),
+              std::numeric_limits<int>::max(), nullptr, &masks->tunnels);
+
+    int stranded = 0;
+    sf::Vector2i first(-1, -1);
+    for (CellType kind : {PELLET, POWER_PELLET})
+    {
+        for (const sf::Vector2i &p : grid.findTiles(kind))
+        {
+            if (bfs.reached(p.x, p.y))
+                continue;
+            if (stranded++ == 0)
+                first = p;
+        }
+    }
+    if (stranded)
+        std::cout << name << ": warning: " << stranded << " pellet(s) unreachable from the player start, first at ("
+                  << first.x << ", " << first.y << ")" << std::endl;
+}
+
+// Load one PNG (fit to the image, or resampled to width x height) and write it.
+static bool compileMap(const std::string &input, const std::string &output, int width, int height)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool fit = width == 0;
+    Grid grid(fit ? 1 : width, fit ? 1 : height, false);
+    if (!grid.loadMazeFromImage(input, fit) || !grid.saveCompiledMap(output))
+        return false;
+    checkReachable(grid, input);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << input << " -> " << output << " (" << grid.getWidth() << "x" << grid.getHeight() << ", "
+              << ms << " ms)" << std::endl;
+    return true;
+}
+
+// Compile a whole folder of authoring PNGs. Files go one after another; each
+// load already classifies its rows on every core.
+static int compileFolder(const std::string &dir, const std::string &outDir)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (!fs::is_directory(dir, ec))
+    {
+        std::cout << "Not a directory: " << dir << std::endl;
+        return 1;
+    }
+    fs::create_directories(outDir, ec);
+
+    std::vector<fs::path> inputs;
+    for (const fs::directory_entry &entry : fs::directory_iterator(dir, ec))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".png")
+            inputs.push_back(entry.path());
+    }
+    std::sort(inputs.begin(), inputs.end());
+
+    auto start = std::chrono::steady_clock::now();
+    int failed = 0;
+    for (const fs::path &input : inputs)
+    {
+        fs::path output = fs::path(outDir) / input.filename().replace_extension(".pmm");
+        if (!compileMap(input.string(), output.string(), 0, 0))
+            ++failed;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << inputs.size() - failed << "/" << inputs.size() << " maps compiled in " << ms << " ms" << std::endl;
+    return failed ? 1 : 0;
+}
+
+static int printInfo(const std::string &path)
+{
+    MappedFile file;
+    if (!file.open(path))
+    {
+        std::cout << "Cannot open " << path << std::endl;
+        return 1;
+    }
+    std::string error;
+    const PmmHeader &h = *reinterpret_cast<const PmmHeader *>(file.data());
+    if (file.size() < sizeof(PmmHeader) || !validatePmmHeader(h, file.size(), Grid::CHUNK_SHIFT, error))
+    {
+        std::cout << path << ": " << (error.empty() ? "too small" : error) << std::endl;
+        return 1;
+    }
+
+    std::uint64_t actual = pmmContentHash(file.data(), h, Grid::CHUNK_SHIFT);
+    std::cout << path << ": version " << h.version << ", " << h.width << "x" << h.height << " tiles\n"
+              << "  chunks:   " << h.storedChunks << " stored / " << h.chunkCount << " total\n"
+              << "  specials: " << h.specialCount << " indexed tiles\n"
+              << "  flags:   " << ((h.flags & PMM_HAS_SCOREBOARD) ? " scoreboard" : "")
+              << ((h.flags & PMM_HAS_TUNNEL) ? " tunnel" : "") << ((h.flags & PMM_HAS_GHOST_DOOR) ? " ghost-door" : "")
+              << "\n  size:     " << h.fileSize << " bytes\n"
+              << "  hash:     " << std::hex << h.contentHash << (actual == h.contentHash ? " (ok)" : " (MISMATCH)")
+              << std::dec << std::endl;
+    return actual == h.contentHash ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 3 && std::string(argv[1]) == "--info")
+        return printInfo(argv[2]);
+    if ((argc == 3 || argc == 4) && std::string(argv[1]) == "--batch")
+        return compileFolder(argv[2], argc == 4 ? argv[3] : argv[2]);
+
+    int argi = 1;
+    int width = 0, height = 0;
+    if (argc > 2 && std::string(argv[1]) == "--size")
+    {
+        if (std::sscanf(argv[2], "%dx%d", &width, &height) != 2 || width < 3 || height < 3)
+        {
+            std::cout << "Bad --size (expected WxH, e.g. 1024x1024)" << std::endl;
+            return 1;
+        }
+        argi = 3;
+    }
+    if (argc - argi < 1 || argc - argi > 2)
+    {
+        std::cout << "Usage: mapc [--size WxH] in.png [out.pmm]\n"
+                  << "       mapc --info map.pmm\n"
+                  << "       mapc --batch dir [outdir]" << std::endl;
+        return 1;
+    }
+
+    std::string input = argv[argi];
+    std::string output = argc - argi == 2 ? argv[argi + 1]
+                                          : std::filesystem::path(input).replace_extension(".pmm").string();
+
+    return compileMap(input, output, width, height) ? 0 : 1;
+}
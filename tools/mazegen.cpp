@@ -0,0 +1,85 @@
+// mazegen — write procedurally generated mazes as authoring PNGs.
+//
+//   mazegen WxH [seed] out.png     one maze
+//   mazegen --corpus dir           the fixed benchmark corpus (used by `make corpus`)
+//
+// Output maps are one pixel per tile in the MAZE_LEGEND colours, so the game
+// loads them with `munch_maze --map out.png`.
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "Grid.h"
+#include "PelletGrid.h"
+#include "MazeGenerator.h"
+
+// The benchmark set: every size is generated from the same seeds, so the
+// corpus is byte-for-byte identical from run to run and machine to machine.
+struct CorpusEntry
+{
+    int width;
+    int height;
+};
+
+static const CorpusEntry CORPUS_SIZES[] = {
+    {28, 31}, {64, 64}, {128, 128}, {256, 256}, {512, 512}, {1024, 1024}, {2048, 2048}, {4096, 4096}};
+static const unsigned long long CORPUS_SEEDS[] = {1, 2};
+
+static bool writeMaze(int width, int height, unsigned long long seed, const std::string &path, std::ostream *manifest)
+{
+    auto start = std::chrono::steady_clock::now();
+    Grid grid(width, height, false);
+    MazeGenerator(seed).generate(grid, width, height);
+    double genMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (!grid.saveMazeToImage(path))
+        return false;
+
+    PelletGrid pellets(grid);
+    std::cout << path << ": " << grid.getWidth() << "x" << grid.getHeight() << " seed " << seed
+              << ", " << pellets.countPellets() << " pellets, generated in " << genMs << " ms" << std::endl;
+    if (manifest)
+        *manifest << path << ' ' << grid.getWidth() << ' ' << grid.getHeight() << ' ' << seed << ' '
+                  << pellets.countPellets() << ' ' << pellets.countPowerPellets() << '\n';
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 3 && std::string(argv[1]) == "--corpus")
+    {
+        std::string dir = argv[2];
+        std::ofstream manifest(dir + "/manifest.txt");
+        if (!manifest)
+        {
+            std::cout << "Cannot write " << dir << "/manifest.txt (does the directory exist?)" << std::endl;
+            return 1;
+        }
+        manifest << "# file width height seed pellets power_pellets\n";
+        for (const CorpusEntry &e : CORPUS_SIZES)
+        {
+            for (unsigned long long seed : CORPUS_SEEDS)
+            {
+                std::string path = dir + "/maze_" + std::to_string(e.width) + "x" + std::to_string(e.height) +
+                                   "_s" + std::to_string(seed) + ".png";
+                if (!writeMaze(e.width, e.height, seed, path, &manifest))
+                    return 1;
+            }
+        }
+        return 0;
+    }
+
+    int width = 0, height = 0;
+    if ((argc == 3 || argc == 4) && std::sscanf(argv[1], "%dx%d", &width, &height) == 2)
+    {
+        unsigned long long seed = (argc == 4) ? std::strtoull(argv[2], nullptr, 10) : 1;
+        return writeMaze(width, height, seed, argv[argc - 1], nullptr) ? 0 : 1;
+    }
+
+    std::cout << "Usage: mazegen WxH [seed] out.png\n"
+              << "       mazegen --corpus dir" << std::endl;
+    return 1;
+}
@@ -0,0 +1,304 @@
+// replay — play recorded games back and prove they come out the same.
+//
+//   replay info file.pmr...                  what each replay holds
+//   replay verify [options] file.pmr...      play each one back and compare
+//     --threads N                            N copies of each at once, one per thread
+//     --lockstep K                           ...each copy K lanes of a GameBatch (the
+//                                            batched, vectorised ghost AI path)
+//   replay diff a.log b.log                  first difference between two --checksum-log files
+//
+// Replays come from `munch_maze --headless N --record games.pmr`; every
+// --checksum-every frames (default 60) they hold a checksum of the whole game
+// state (StateChecksum.h). verify replays the recorded inputs and reports the
+// first frame where a checksum differs, and in which fields (muncher, ghosts,
+// pellets, score, ai, fruit, clock); the exit status is 1 if any did.
+//
+// Optimisations must not change a single game, so build this tool the ways
+// the game gets built and check each one against the same recordings:
+// `make verify` records a few games, then runs verify from -O0, -O2, -O3,
+// -O3 -flto and -O3 -mavx2 builds, several threads at once and in lockstep.
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "GameBatch.h"
+#include "GameSession.h"
+#include "Grid.h"
+#include "Parallel.h"
+#include "Replay.h"
+#include "StateChecksum.h"
+
+// Which build this is, for the report (make verify passes its flags).
+#ifndef REPLAY_BUILD
+#define REPLAY_BUILD "default build"
+#endif
+
+// Where a playback left the recording (ok: never).
+struct Outcome
+{
+    bool ok = true;
+    std::uint32_t frame = 0;  // first frame whose checksum differed
+    std::uint32_t agreed = 0; // last checkpoint frame that matched
+    int lane = 0;             // which lockstep lane saw it first
+    std::vector<int> fields;  // StateChecksum fields that differed there
+    std::uint32_t checked = 0; // checkpoints compared
+};
+
+// Compare `session`, `frame` steps in, with the recording's checkpoint there
+// (if it has one; `next` walks the checkpoints in order). False on a mismatch.
+static bool check(const Replay &replay, std::size_t &next, std::uint32_t frame, const GameSession &session,
+                  Outcome &out, int lane)
+{
+    const std::vector<Replay::Checkpoint> &checkpoints = replay.getCheckpoints();
+    if (next >= checkpoints.size() || checkpoints[next].frame != frame)
+        return true;
+    StateChecksum want = checkpoints[next++].checksum();
+    StateChecksum got = session.getChecksum();
+    ++out.checked;
+    if (got.firstDifference(want) < 0)
+    {
+        out.agreed = frame;
+        return true;
+    }
+    out.ok = false;
+    out.frame = frame;
+    out.lane = lane;
+    for (int f = 0; f < StateChecksum::FIELDS; ++f)
+    {
+        if (got.parts[f] != want.parts[f])
+            out.fields.push_back(f);
+    }
+    return false;
+}
+
+// One playback stepped on its own, as runHeadless steps a game.
+static Outcome playAlone(const Replay &replay, const Grid &grid, const DifficultyCurve &curve)
+{
+    Outcome out;
+    GameSession session = GameSession::headless(grid);
+    replay.setUp(session, curve);
+    std::size_t next = 0;
+    for (std::uint32_t f = 0; f < replay.frameCount(); ++f)
+    {
+        replay.applyInput(session, f);
+        session.step(replay.getFrameTime());
+        if (!check(replay, next, f + 1, session, out, 0))
+            break;
+    }
+    return out;
+}
+
+// `lanes` playbacks of the same replay stepped together (GameBatch).
+static Outcome playLockstep(const Replay &replay, const Grid &grid, const DifficultyCurve &curve, int lanes)
+{
+    Outcome out;
+    GameBatch batch(grid, lanes);
+    for (int i = 0; i < batch.size(); ++i)
+        replay.setUp(batch.lane(i), curve);
+    std::vector<std::size_t> next(batch.size(), 0);
+    for (std::uint32_t f = 0; f < replay.frameCount() && out.ok; ++f)
+    {
+        for (int i = 0; i < batch.size(); ++i)
+            replay.applyInput(batch.lane(i), f);
+        batch.step(replay.getFrameTime());
+        for (int i = 0; i < batch.size() && out.ok; ++i)
+            check(replay, next[i], f + 1, batch.lane(i), out, i);
+    }
+    out.checked = static_cast<std::uint32_t>(next[0]); // per lane
+    return out;
+}
+
+static int info(const std::vector<std::string> &files)
+{
+    int failed = 0;
+    for (const std::string &path : files)
+    {
+        Replay replay;
+        if (!replay.load(path))
+        {
+            std::cout << path << ": not a replay (or a different version)" << std::endl;
+            ++failed;
+            continue;
+        }
+        const Replay::FileHeader &h = replay.getHeader();
+        std::cout << path << ": " << h.width << "x" << h.height << ", "
+                  << (replay.getRoster().empty() ? std::string("classic four") : std::to_string(replay.getRoster().size()) + " ghosts")
+                  << ", " << (h.curveLevels ? std::to_string(h.curveLevels) + "-level curve" : std::string("standard ramp"))
+                  << (h.searchMicros ? ", ghost search " + std::to_string(h.searchMicros) + " us" : std::string())
+                  << ", seed " << h.seed << "\n  " << replay.frameCount() << " frames of "
+                  << h.frameMicros << " us, " << replay.getCheckpoints().size() << " checkpoints every "
+                  << h.checksumEvery << " frames";
+        if (!replay.getCheckpoints().empty())
+            std::cout << ", last " << std::hex << std::setfill('0') << std::setw(16)
+                      << replay.getCheckpoints().back().checksum().total() << std::dec << std::setfill(' ');
+        std::cout << std::endl;
+    }
+    return failed ? 1 : 0;
+}
+
+static int verify(const std::vector<std::string> &files, int copies, int lanes)
+{
+    // Load everything first: boards are shared (read-only) by every copy.
+    std::vector<Replay> replays(files.size());
+    std::vector<Grid> grids;
+    std::vector<DifficultyCurve> curves;
+    grids.reserve(files.size());
+    for (std::size_t i = 0; i < files.size(); ++i)
+    {
+        grids.emplace_back(1, 1, false);
+        if (!replays[i].load(files[i]))
+        {
+            std::cout << files[i] << ": not a replay (or a different version)" << std::endl;
+            return 1;
+        }
+        replays[i].buildGrid(grids[i]);
+        if (!replays[i].gridMatches(grids[i]))
+            std::cout << files[i] << ": warning: spawn tiles differ from the recording's board" << std::endl;
+        curves.push_back(replays[i].makeCurve());
+    }
+
+    std::cout << "Verifying " << files.size() << " replays, " << copies << " at once"
+              << (lanes > 0 ? " in " + std::to_string(lanes) + "-lane lockstep" : std::string()) << " ("
+              << REPLAY_BUILD << ")" << std::endl;
+
+    // Every (file, copy) pair is a task; threads take them in turn.
+    const int tasks = static_cast<int>(files.size()) * copies;
+    std::vector<Outcome> outcomes(tasks);
+    std::atomic<int> nextTask{0};
+    auto worker = [&](int, int)
+    {
+        for (int t; (t = nextTask++) < tasks;)
+        {
+            int f = t / copies;
+            outcomes[t] = lanes > 0 ? playLockstep(replays[f], grids[f], curves[f], lanes)
+                                    : playAlone(replays[f], grids[f], curves[f]);
+        }
+    };
+    parallelFor(0, copies, static_cast<unsigned>(copies), worker);
+
+    int failed = 0;
+    for (std::size_t f = 0; f < files.size(); ++f)
+    {
+        const Outcome *bad = nullptr;
+        std::uint32_t checked = 0;
+        for (int c = 0; c < copies; ++c)
+        {
+            const Outcome &o = outcomes[f * copies + c];
+            checked = std::max(checked, o.checked);
+            if (!o.ok && (!bad || o.frame < bad->frame))
+                bad = &o;
+        }
+        if (!bad)
+        {
+            std::cout << "  " << files[f] << ": ok (" << replays[f].frameCount() << " frames, " << checked
+                      << " checkpoints)" << std::endl;
+            continue;
+        }
+        ++failed;
+        std::cout << "  " << files[f] << ": DIVERGED at frame " << bad->frame;
+        if (lanes > 0)
+            std::cout << " (lane " << bad->lane << ")";
+        std::cout << " in";
+        for (int field : bad->fields)
+            std::cout << " " << StateChecksum::fieldName(field);
+        std::cout << " (last agreed at frame " << bad->agreed << ")" << std::endl;
+    }
+    std::cout << (failed ? std::to_string(failed) + " of " + std::to_string(files.size()) + " replays diverged"
+                         : std::string("All replays match"))
+              << std::endl;
+    return failed ? 1 : 0;
+}
+
+// Two --checksum-log files: the first line that differs, and in which fields.
+static int diffLogs(const std::string &pathA, const std::string &pathB)
+{
+    std::ifstream a(pathA), b(pathB);
+    if (!a || !b)
+    {
+        std::cout << "Cannot open " << (!a ? pathA : pathB) << std::endl;
+        return 1;
+    }
+    std::string lineA, lineB;
+    long lines = 0;
+    while (true)
+    {
+        bool moreA = static_cast<bool>(std::getline(a, lineA));
+        bool moreB = static_cast<bool>(std::getline(b, lineB));
+        if (!moreA || !moreB)
+        {
+            if (moreA != moreB)
+            {
+                std::cout << "Logs agree for " << lines << " checkpoints, then " << (moreA ? pathB : pathA)
+                          << " ends" << std::endl;
+                return 1;
+            }
+            std::cout << "Logs agree (" << lines << " checkpoints)" << std::endl;
+            return 0;
+        }
+        if (!lineA.empty() && lineA[0] == '#')
+            continue;
+        if (lineA == lineB)
+        {
+            ++lines;
+            continue;
+        }
+
+        // game frame total, then one column per field
+        std::istringstream inA(lineA), inB(lineB);
+        std::string gameA, frameA, totalA, gameB, frameB, totalB;
+        inA >> gameA >> frameA >> totalA;
+        inB >> gameB >> frameB >> totalB;
+        std::cout << "First difference: game " << gameA << " frame " << frameA;
+        if (gameA != gameB || frameA != frameB)
+        {
+            std::cout << " vs game " << gameB << " frame " << frameB << " (runs stopped at different frames)" << std::endl;
+            return 1;
+        }
+        std::cout << " in";
+        for (int f = 0; f < StateChecksum::FIELDS; ++f)
+        {
+            std::string partA, partB;
+            inA >> partA;
+            inB >> partB;
+            if (partA != partB)
+                std::cout << " " << StateChecksum::fieldName(f);
+        }
+        std::cout << std::endl;
+        return 1;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string command = argc > 1 ? argv[1] : "";
+    int copies = 1;
+    int lanes = 0;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+            copies = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--lockstep" && i + 1 < argc)
+            lanes = std::max(1, std::min(GameBatch::MAX_LANES, std::atoi(argv[++i])));
+        else
+            files.push_back(arg);
+    }
+
+    if (command == "info" && !files.empty())
+        return info(files);
+    if (command == "verify" && !files.empty())
+        return verify(files, copies, lanes);
+    if (command == "diff" && files.size() == 2)
+        return diffLogs(files[0], files[1]);
+
+    std::cout << "Usage: replay info file.pmr...\n"
+              << "       replay verify [--threads N] [--lockstep K] file.pmr...\n"
+              << "       replay diff a.log b.log" << std::endl;
+    return 1;
+}
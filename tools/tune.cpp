@@ -0,0 +1,431 @@
+// tune — fit the per-level difficulty curve to a target survival rate, using
+// bot-played headless games on every core.
+//
+//   tune [options] [out.txt]        (default out: difficulty.txt)
+//     --map file.png|file.pmm       board to tune on (default: the shipped map)
+//     --levels N                    levels to tune (default 8)
+//     --target a,b,c,...            survival rate per level, last one repeats
+//                                   (default 0.9 falling 0.05 a level to 0.55)
+//     --games N                     bot games per candidate (default 2000)
+//     --bot S                       bot strength 0-10 standing in for the player (default 6)
+//     --search evolve|grid          (default evolve)
+//     --generations N --offspring N evolve: per level (default 6 x 8)
+//     --steps N                     grid: values per parameter (default 3, so 81 candidates)
+//     --threads N --seed N
+//
+// One "game" is one level: a headless session starts at that level and the
+// bot plays until it clears the board, loses a life, or MAX_LEVEL_SECONDS of
+// game time pass. Survival = no life lost. Play the result with
+// `munch_maze --difficulty difficulty.txt`.
+//
+// Levels are tuned in order. Each one starts from the level before it plus
+// the standard ramp's step, and a small penalty for straying from there keeps
+// the curve smooth when several settings hit the target equally well.
+//
+// Every candidate plays the same seeded games, and the game is deterministic,
+// so candidates are compared on identical luck. Games run in batches and a
+// candidate is dropped as soon as it clearly cannot beat the best one so far,
+// so most losers cost a batch rather than the full count.
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Grid.h"
+#include "GameConfig.h"
+#include "GameSession.h"
+#include "MuncherBot.h"
+#include "DifficultyCurve.h"
+#include "Parallel.h"
+
+static const float MAX_LEVEL_SECONDS = 240.0f;
+static const int BATCH_GAMES = 250;      // games per racing round
+static const float RACE_SIGMAS = 2.5f;   // confidence before a candidate is dropped
+static const float SMOOTHNESS = 0.02f;   // survival error traded per unit of normalised drift
+
+// Search range per parameter, in LevelDifficulty order.
+static const float PARAM_MIN[4] = {0.15f, 1.0f, 5.0f, 0.5f};
+static const float PARAM_MAX[4] = {0.60f, 15.0f, 60.0f, 12.0f};
+
+struct TuneOptions
+{
+    std::string mapPath = GameConfig::MAZE_IMAGE;
+    bool customMap = false;
+    std::string outPath = "difficulty.txt";
+    int levels = 8;
+    std::vector<float> targets;
+    int games = 2000;
+    int botStrength = 6;
+    bool grid = false;
+    int generations = 6;
+    int offspring = 8;
+    int steps = 3;
+    unsigned threads = 0;
+    unsigned seed = 1;
+};
+
+static float *param(LevelDifficulty &d, int i)
+{
+    float *p[4] = {&d.ghostSecondsPerTile, &d.scatterTime, &d.chaseTime, &d.frightenedTime};
+    return p[i];
+}
+
+static LevelDifficulty clampToRange(LevelDifficulty d)
+{
+    for (int i = 0; i < 4; ++i)
+        *param(d, i) = std::min(PARAM_MAX[i], std::max(PARAM_MIN[i], *param(d, i)));
+    return d;
+}
+
+// Root-mean-square distance in units of each parameter's search range.
+static float drift(LevelDifficulty a, LevelDifficulty b)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < 4; ++i)
+    {
+        float t = (*param(a, i) - *param(b, i)) / (PARAM_MAX[i] - PARAM_MIN[i]);
+        sum += t * t;
+    }
+    return std::sqrt(sum / 4.0f);
+}
+
+static std::string describe(const LevelDifficulty &d)
+{
+    char text[96];
+    std::snprintf(text, sizeof(text), "ghost %.3f s/tile, scatter %.1f s, chase %.1f s, frightened %.1f s",
+                  d.ghostSecondsPerTile, d.scatterTime, d.chaseTime, d.frightenedTime);
+    return text;
+}
+
+// Plays games for candidates on one level and keeps the best.
+class LevelTuner
+{
+public:
+    struct Candidate
+    {
+        LevelDifficulty difficulty;
+        int played = 0;
+        int survived = 0;
+        bool dropped = false;
+
+        float survival() const { return played ? static_cast<float>(survived) / played : 0.0f; }
+    };
+
+    LevelTuner(const Grid &grid, const TuneOptions &opts, int level, float target, LevelDifficulty anchor)
+        : grid(grid), opts(opts), level(level), target(target), anchor(anchor) {}
+
+    // Race `pool` on the same games. Returns the index of the best survivor
+    // (candidates that are dropped keep their partial counts).
+    int race(std::vector<Candidate> &pool, int incumbent = -1);
+
+    float cost(const Candidate &c) const { return std::fabs(c.survival() - target) + SMOOTHNESS * drift(c.difficulty, anchor); }
+
+    long getGames() const { return gamesPlayed; }
+    long getFrames() const { return framesPlayed; }
+
+private:
+    const Grid &grid;
+    const TuneOptions &opts;
+    int level;
+    float target;
+    LevelDifficulty anchor;
+    long gamesPlayed = 0;
+    long framesPlayed = 0;
+
+    // Cost interval from the games so far (normal approximation, never narrower
+    // than one game's worth so a 0/N or N/N run is not treated as certain).
+    float halfWidth(const Candidate &c) const
+    {
+        float p = c.survival();
+        float sigma = std::sqrt(std::max(p * (1.0f - p), 0.25f / c.played) / c.played);
+        return RACE_SIGMAS * sigma;
+    }
+
+    bool playGame(const DifficultyCurve &curve, int game, long &frames) const;
+};
+
+// One level from the start: true if the bot got through it without dying.
+inline bool LevelTuner::playGame(const DifficultyCurve &curve, int game, long &frames) const
+{
+    const sf::Time frame = sf::seconds(1.0f / 60.0f);
+    unsigned gameSeed = opts.seed + static_cast<unsigned>(game) * 7919u;
+
+    GameSession session = GameSession::headless(grid);
+    session.seed(gameSeed);
+    session.setDifficulty(&curve);
+    session.setLevel(level);
+
+    MuncherBot::Settings settings;
+    settings.strength = opts.botStrength / 10.0f;
+    settings.seed = gameSeed;
+    MuncherBot bot(settings);
+
+    bool survived = true;
+    while (session.getLevel() == level && session.getTime().asSeconds() < MAX_LEVEL_SECONDS)
+    {
+        bot.play(session);
+        session.step(frame);
+        if (session.isDying() || session.isGameOver())
+        {
+            survived = false;
+            break;
+        }
+    }
+    frames += session.getFrames();
+    return survived;
+}
+
+inline int LevelTuner::race(std::vector<Candidate> &pool, int incumbent)
+{
+    // Each candidate gets its own curve: sessions keep a pointer to it.
+    std::vector<DifficultyCurve> curves(pool.size());
+    for (std::size_t c = 0; c < pool.size(); ++c)
+        curves[c].set(level, pool[c].difficulty);
+
+    int best = incumbent;
+    for (int first = 0; first < opts.games; first += BATCH_GAMES)
+    {
+        int count = std::min(BATCH_GAMES, opts.games - first);
+        std::vector<int> active;
+        for (std::size_t c = 0; c < pool.size(); ++c)
+        {
+            if (!pool[c].dropped && pool[c].played < first + count)
+                active.push_back(static_cast<int>(c));
+        }
+        if (active.empty())
+            break;
+
+        // Every (candidate, game) pair is independent; results go to disjoint slots.
+        int jobs = static_cast<int>(active.size()) * count;
+        std::vector<char> survived(jobs);
+        std::vector<long> frames(jobs);
+        parallelFor(0, jobs, opts.threads, [&](int begin, int end)
+        {
+            for (int j = begin; j < end; ++j)
+            {
+                int c = active[j / count];
+                survived[j] = playGame(curves[c], first + j % count, frames[j]);
+            }
+        });
+
+        for (int j = 0; j < jobs; ++j)
+        {
+            Candidate &c = pool[active[j / count]];
+            c.played++;
+            c.survived += survived[j];
+            framesPlayed += frames[j];
+        }
+        gamesPlayed += jobs;
+
+        // Drop anything whose best case is worse than the leader's worst case.
+        float bestUpper = 1e9f;
+        for (const Candidate &c : pool)
+        {
+            if (!c.dropped && c.played > 0)
+                bestUpper = std::min(bestUpper, cost(c) + halfWidth(c));
+        }
+        for (int c : active)
+        {
+            if (cost(pool[c]) - halfWidth(pool[c]) > bestUpper)
+                pool[c].dropped = true;
+        }
+    }
+
+    // Only fully played candidates are compared exactly.
+    for (std::size_t c = 0; c < pool.size(); ++c)
+    {
+        if (pool[c].dropped || pool[c].played < opts.games)
+            continue;
+        if (best < 0 || cost(pool[c]) < cost(pool[best]))
+            best = static_cast<int>(c);
+    }
+    return best;
+}
+
+// Grid sweep: every combination of `steps` evenly spaced values per parameter.
+static LevelTuner::Candidate tuneGrid(LevelTuner &tuner, const TuneOptions &opts)
+{
+    std::vector<LevelTuner::Candidate> pool;
+    int steps = std::max(2, opts.steps);
+    int total = steps * steps * steps * steps;
+    for (int n = 0; n < total; ++n)
+    {
+        LevelTuner::Candidate c;
+        int k = n;
+        for (int i = 0; i < 4; ++i, k /= steps)
+            *param(c.difficulty, i) = PARAM_MIN[i] + (PARAM_MAX[i] - PARAM_MIN[i]) * (k % steps) / (steps - 1);
+        pool.push_back(c);
+    }
+    int best = tuner.race(pool);
+    return pool[best];
+}
+
+// (1 + lambda) evolution: mutate the parent, race the children against it on
+// the same games, keep the best; widen the step after a win, narrow it after
+// a miss.
+static LevelTuner::Candidate tuneEvolve(LevelTuner &tuner, const TuneOptions &opts, LevelDifficulty start,
+                                        std::minstd_rand &rng)
+{
+    std::vector<LevelTuner::Candidate> pool(1);
+    pool[0].difficulty = start;
+    tuner.race(pool);
+    LevelTuner::Candidate parent = pool[0];
+
+    float stepSize = 0.15f; // fraction of each parameter's range
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+    for (int gen = 0; gen < opts.generations; ++gen)
+    {
+        pool.assign(1, parent); // already fully played: races as the incumbent for free
+        for (int k = 0; k < opts.offspring; ++k)
+        {
+            LevelTuner::Candidate child;
+            child.difficulty = parent.difficulty;
+            for (int i = 0; i < 4; ++i)
+                *param(child.difficulty, i) += gauss(rng) * stepSize * (PARAM_MAX[i] - PARAM_MIN[i]);
+            child.difficulty = clampToRange(child.difficulty);
+            pool.push_back(child);
+        }
+
+        int best = tuner.race(pool, 0);
+        bool improved = best != 0;
+        parent = pool[best];
+        stepSize = std::min(0.5f, std::max(0.01f, stepSize * (improved ? 1.5f : 0.7f)));
+        std::cout << "    gen " << gen + 1 << ": survival " << parent.survival() << ", cost " << tuner.cost(parent)
+                  << (improved ? " (improved)" : "") << std::endl;
+    }
+    return parent;
+}
+
+static std::vector<float> parseTargets(const std::string &list)
+{
+    std::vector<float> out;
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ','))
+    {
+        float t = std::strtof(item.c_str(), nullptr);
+        out.push_back(std::min(1.0f, std::max(0.0f, t)));
+    }
+    return out;
+}
+
+static bool parseOptions(int argc, char **argv, TuneOptions &opts)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--map" && hasValue)
+        {
+            opts.mapPath = argv[++i];
+            opts.customMap = true;
+        }
+        else if (arg == "--levels" && hasValue)
+            opts.levels = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--target" && hasValue)
+            opts.targets = parseTargets(argv[++i]);
+        else if (arg == "--games" && hasValue)
+            opts.games = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--bot" && hasValue)
+            opts.botStrength = std::max(0, std::min(10, std::atoi(argv[++i])));
+        else if (arg == "--search" && hasValue)
+            opts.grid = std::string(argv[++i]) == "grid";
+        else if (arg == "--generations" && hasValue)
+            opts.generations = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--offspring" && hasValue)
+            opts.offspring = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--steps" && hasValue)
+            opts.steps = std::max(2, std::atoi(argv[++i]));
+        else if (arg == "--threads" && hasValue)
+            opts.threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        else if (arg == "--seed" && hasValue)
+            opts.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg.rfind("--", 0) != 0)
+            opts.outPath = arg;
+        else
+        {
+            std::cout << "Usage: tune [--map file] [--levels N] [--target a,b,...] [--games N] [--bot 0-10]\n"
+                      << "            [--search evolve|grid] [--generations N] [--offspring N] [--steps N]\n"
+                      << "            [--threads N] [--seed N] [out.txt]" << std::endl;
+            return false;
+        }
+    }
+    if (opts.targets.empty())
+    {
+        for (int level = 1; level <= opts.levels; ++level)
+            opts.targets.push_back(std::max(0.55f, 0.95f - 0.05f * level));
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    TuneOptions opts;
+    if (!parseOptions(argc, argv, opts))
+        return 1;
+
+    Grid grid(GameConfig::GRID_WIDTH, GameConfig::GRID_HEIGHT, false);
+    bool loaded = std::filesystem::path(opts.mapPath).extension() == ".pmm"
+                      ? grid.loadCompiledMap(opts.mapPath)
+                      : grid.loadMazeFromImage(opts.mapPath, opts.customMap);
+    if (!loaded)
+    {
+        std::cout << "Cannot load map " << opts.mapPath << std::endl;
+        return 1;
+    }
+
+    unsigned threads = opts.threads ? opts.threads : defaultThreadCount();
+    std::cout << "Tuning " << opts.levels << " levels on " << grid.getWidth() << "x" << grid.getHeight() << " ("
+              << (opts.grid ? "grid" : "evolve") << " search, " << opts.games << " games per candidate, bot strength "
+              << opts.botStrength << ", " << threads << " threads)" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    std::minstd_rand rng(opts.seed);
+    DifficultyCurve curve;
+    std::vector<std::string> notes;
+    long totalGames = 0, totalFrames = 0;
+    for (int level = 1; level <= opts.levels; ++level)
+    {
+        float target = opts.targets[std::min<std::size_t>(level, opts.targets.size()) - 1];
+
+        // Start from the previous tuned level plus the standard ramp's step.
+        LevelDifficulty anchor = DifficultyCurve::standard(level);
+        if (level > 1)
+        {
+            LevelDifficulty prev = curve.at(level - 1), stdPrev = DifficultyCurve::standard(level - 1);
+            for (int i = 0; i < 4; ++i)
+                *param(anchor, i) = *param(prev, i) + (*param(anchor, i) - *param(stdPrev, i));
+            anchor = clampToRange(anchor);
+        }
+
+        std::cout << "Level " << level << " (target survival " << target << ")" << std::endl;
+        LevelTuner tuner(grid, opts, level, target, anchor);
+        LevelTuner::Candidate best = opts.grid ? tuneGrid(tuner, opts) : tuneEvolve(tuner, opts, anchor, rng);
+        curve.set(level, best.difficulty);
+        totalGames += tuner.getGames();
+        totalFrames += tuner.getFrames();
+
+        char note[64];
+        std::snprintf(note, sizeof(note), "level %d: survival %.3f (target %.3f)", level, best.survival(), target);
+        notes.push_back(note);
+        std::cout << "  " << describe(best.difficulty) << " -> survival " << best.survival() << " over "
+                  << best.played << " games" << std::endl;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << totalGames << " games, " << totalFrames << " frames in " << seconds << " s ("
+              << static_cast<long>(totalFrames / std::max(seconds, 1e-9)) << " frames/s)" << std::endl;
+    if (!curve.save(opts.outPath, notes))
+        return 1;
+    std::cout << "Wrote " << opts.outPath << " (play it with: munch_maze --difficulty " << opts.outPath << ")"
+              << std::endl;
+    return 0;
+}